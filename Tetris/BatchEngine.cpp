@@ -0,0 +1,223 @@
+#include "BatchEngine.h"
+#include "TetrominoTable.h"
+
+// constructor - create gameCount games, game g is seeded with (seed + g)
+BatchEngine::BatchEngine(int gameCount, std::uint64_t seed, PieceRandomizer::Mode randomizerMode)
+	: gameCount(gameCount),
+	rowMasks(static_cast<size_t>(gameCount) * Gameboard::MAX_Y),
+	shapes(gameCount), rotations(gameCount), pieceX(gameCount), pieceY(gameCount),
+	nextShapes(gameCount), scores(gameCount),
+	candidateX(gameCount), candidateY(gameCount), candidateRotation(gameCount),
+	pending(gameCount), moved(gameCount), locking(gameCount)
+{
+	randomizers.reserve(gameCount);
+	for (int game = 0; game < gameCount; game++) {
+		randomizers.push_back(PieceRandomizer(seed + game, randomizerMode));
+		reset(game);
+	}
+}
+
+int BatchEngine::getGameCount() const
+{
+	return gameCount;
+}
+
+// advance every game by one step: apply actions[g] to game g, then one gravity tick.
+void BatchEngine::step(const Action actions[])
+{
+	// phase 1: turn each action into a candidate position
+	for (int g = 0; g < gameCount; g++) {
+		Action action = actions[g];
+		candidateX[g] = pieceX[g] + (action == Action::RIGHT) - (action == Action::LEFT);
+		candidateY[g] = pieceY[g] + (action == Action::DOWN);
+		candidateRotation[g] = (rotations[g] + (action == Action::ROTATE)) % TetrominoTable::ROTATION_COUNT;
+		pending[g] = (action == Action::ROTATE || action == Action::LEFT
+			|| action == Action::RIGHT || action == Action::DOWN);
+		locking[g] = 0;
+	}
+	moveKernel();
+
+	// a DOWN that can't move locks the piece, a DROP falls as far as it can and locks
+	for (int g = 0; g < gameCount; g++) {
+		if (actions[g] == Action::DOWN && !moved[g]) {
+			locking[g] = 1;
+		}
+		else if (actions[g] == Action::DROP) {
+			const Gameboard::RowMask* board = &rowMasks[static_cast<size_t>(g) * Gameboard::MAX_Y];
+			while (fits(board, shapes[g], rotations[g], pieceX[g], pieceY[g] + 1)) {
+				pieceY[g]++;
+			}
+			locking[g] = 1;
+		}
+	}
+
+	// phase 2: gravity (every piece that isn't locking moves down one row)
+	for (int g = 0; g < gameCount; g++) {
+		candidateX[g] = pieceX[g];
+		candidateY[g] = pieceY[g] + 1;
+		candidateRotation[g] = rotations[g];
+		pending[g] = !locking[g];
+	}
+	moveKernel();
+
+	// phase 3: lock the pieces that couldn't fall
+	for (int g = 0; g < gameCount; g++) {
+		if (locking[g] || (pending[g] && !moved[g])) {
+			lockAndSpawn(g);
+		}
+	}
+
+	gameSteps += gameCount;
+}
+
+// reset a single game (keeps its randomizer sequence going)
+void BatchEngine::reset(int game)
+{
+	Gameboard::RowMask* board = &rowMasks[static_cast<size_t>(game) * Gameboard::MAX_Y];
+	for (int row = 0; row < Gameboard::MAX_Y; row++) {
+		board[row] = 0;
+	}
+	scores[game] = 0;
+
+	nextShapes[game] = static_cast<std::int8_t>(randomizers[game].nextShape());
+	spawn(game);
+	nextShapes[game] = static_cast<std::int8_t>(randomizers[game].nextShape());
+}
+
+// State access ==================================================
+
+const Gameboard::RowMask* BatchEngine::getRowMasks(int game) const
+{
+	return &rowMasks[static_cast<size_t>(game) * Gameboard::MAX_Y];
+}
+
+GridTetromino BatchEngine::getCurrentShape(int game) const
+{
+	GridTetromino shape;
+	shape.setShape(static_cast<Tetromino::TetShape>(shapes[game]));
+	shape.setRotation(rotations[game]);
+	shape.setGridLoc(pieceX[game], pieceY[game]);
+	return shape;
+}
+
+Tetromino::TetShape BatchEngine::getNextShape(int game) const
+{
+	return static_cast<Tetromino::TetShape>(nextShapes[game]);
+}
+
+int BatchEngine::getScore(int game) const
+{
+	return scores[game];
+}
+
+std::uint64_t BatchEngine::getGameSteps() const
+{
+	return gameSteps;
+}
+
+std::uint64_t BatchEngine::getGamesOver() const
+{
+	return gamesOver;
+}
+
+std::uint64_t BatchEngine::getShapesPlaced() const
+{
+	return shapesPlaced;
+}
+
+// Kernels =======================================================
+
+// return true if a piece with the given shape/rotation at x,y fits on a board
+//   (within the left, right & lower borders and not overlapping any block)
+bool BatchEngine::fits(const Gameboard::RowMask board[], int shape, int rotation, int x, int y)
+{
+	const TetrominoTable::Orientation& orientation = TetrominoTable::getOrientation(shape, rotation);
+
+	if (x + orientation.minX < 0
+		|| x + orientation.maxX >= Gameboard::MAX_X
+		|| y + orientation.maxY >= Gameboard::MAX_Y)
+	{
+		return false;
+	}
+
+	int shift = x + orientation.minX;
+	int rowCount = orientation.maxY - orientation.minY + 1;
+	int topRow = y + orientation.minY;
+	unsigned overlap = 0;
+
+	for (int i = 0; i < rowCount; i++) {
+		int row = topRow + i;
+		if (row >= 0) {
+			overlap |= board[row] & (orientation.rowMasks[i] << shift);
+		}
+	}
+
+	return overlap == 0;
+}
+
+// collision kernel: test every pending candidate position, then move the pieces that fit
+void BatchEngine::moveKernel()
+{
+	for (int g = 0; g < gameCount; g++) {
+		moved[g] = pending[g]
+			&& fits(&rowMasks[static_cast<size_t>(g) * Gameboard::MAX_Y], shapes[g], candidateRotation[g], candidateX[g], candidateY[g]);
+	}
+
+	for (int g = 0; g < gameCount; g++) {
+		if (moved[g]) {
+			pieceX[g] = candidateX[g];
+			pieceY[g] = candidateY[g];
+			rotations[g] = candidateRotation[g];
+		}
+	}
+}
+
+// lock game g's piece onto its board, remove completed rows, spawn the next shape
+void BatchEngine::lockAndSpawn(int game)
+{
+	Gameboard::RowMask* board = &rowMasks[static_cast<size_t>(game) * Gameboard::MAX_Y];
+	const TetrominoTable::Orientation& orientation = TetrominoTable::getOrientation(shapes[game], rotations[game]);
+
+	int shift = pieceX[game] + orientation.minX;
+	int rowCount = orientation.maxY - orientation.minY + 1;
+	int topRow = pieceY[game] + orientation.minY;
+
+	for (int i = 0; i < rowCount; i++) {
+		if (topRow + i >= 0) {
+			board[topRow + i] |= static_cast<Gameboard::RowMask>(orientation.rowMasks[i] << shift);
+		}
+	}
+	shapesPlaced++;
+
+	// (same order as TetrisEngine: the next shape must fit before rows are removed)
+	if (!spawn(game)) {
+		gamesOver++;
+		reset(game);
+		return;
+	}
+	nextShapes[game] = static_cast<std::int8_t>(randomizers[game].nextShape());
+
+	// line clear kernel: compact the surviving rows downwards (bottom up)
+	int targetRow = Gameboard::MAX_Y - 1;
+	for (int row = Gameboard::MAX_Y - 1; row >= 0; row--) {
+		Gameboard::RowMask mask = board[row];
+		board[targetRow] = mask;
+		targetRow -= (mask != Gameboard::FULL_ROW_MASK);
+	}
+	int cleared = targetRow + 1;
+	for (int row = 0; row < cleared; row++) {
+		board[row] = 0;
+	}
+	scores[game] += cleared;
+}
+
+// spawn the next shape for game g, return false if it doesn't fit
+bool BatchEngine::spawn(int game)
+{
+	shapes[game] = nextShapes[game];
+	rotations[game] = 0;
+	pieceX[game] = Gameboard::MAX_X / 2;
+	pieceY[game] = 0;
+
+	return fits(&rowMasks[static_cast<size_t>(game) * Gameboard::MAX_Y], shapes[game], 0, pieceX[game], pieceY[game]);
+}
@@ -0,0 +1,108 @@
+// The BatchEngine runs many independent tetris games in lockstep, for bot training
+// and simulation sweeps where we want as many game-steps per second as possible.
+//
+// Rather than N TetrisEngine objects (each with its own board, tetrominoes, etc.)
+// the games are stored as a structure of arrays:
+//   - all boards are contiguous: game g's rows are rowMasks[g*MAX_Y .. g*MAX_Y+MAX_Y-1]
+//   - all active pieces are contiguous: shapes[], rotations[], pieceX[], pieceY[]
+//   - all scores, counters, randomizers are contiguous
+// so the collision (legality) and line-clear kernels sweep over contiguous memory,
+// one phase at a time for every game, which the compiler can vectorize.
+//
+// Boards are occupancy only (Gameboard::RowMask per row, no colors): a bot only
+// cares whether a cell is filled. The rules match TetrisEngine:
+//   - step() applies one action to every game, then one gravity tick to every game
+//     (a step is one tick of game time),
+//   - a piece that can't move down is locked, completed rows are removed (1 point each)
+//     and the next shape is spawned at the spawn location,
+//   - a game whose next shape can't be spawned is over, and is automatically reset.
+
+#ifndef BATCHENGINE_H
+#define BATCHENGINE_H
+
+#include <cstdint>
+#include <vector>
+#include "Gameboard.h"
+#include "PieceRandomizer.h"
+#include "TetrisEngine.h"
+
+class BatchEngine
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	typedef TetrisEngine::Action Action;
+
+	// constructor - create gameCount games, game g is seeded with (seed + g)
+	BatchEngine(int gameCount, std::uint64_t seed, PieceRandomizer::Mode randomizerMode = PieceRandomizer::Mode::RANDOM);
+
+	// return the # of games in the batch
+	int getGameCount() const;
+
+	// advance every game by one step: apply actions[g] to game g, then one gravity tick.
+	//   actions must hold getGameCount() actions.
+	void step(const Action actions[]);
+
+	// reset a single game (keeps its randomizer sequence going)
+	void reset(int game);
+
+	// STATE ACCESS
+
+	// return the MAX_Y row masks of a game's board (top row first)
+	const Gameboard::RowMask* getRowMasks(int game) const;
+	// return a game's falling tetromino (positioned on its board)
+	GridTetromino getCurrentShape(int game) const;
+	// return a game's "on deck" shape
+	Tetromino::TetShape getNextShape(int game) const;
+	// return a game's score (rows removed since its last reset)
+	int getScore(int game) const;
+	// return the total # of game-steps performed (steps * games)
+	std::uint64_t getGameSteps() const;
+	// return the total # of games that have ended (and been reset)
+	std::uint64_t getGamesOver() const;
+	// return the total # of shapes placed across all games
+	std::uint64_t getShapesPlaced() const;
+
+private:
+	// return true if a piece with the given shape/rotation at x,y fits on a board
+	//   (within the left, right & lower borders and not overlapping any block)
+	static bool fits(const Gameboard::RowMask board[], int shape, int rotation, int x, int y);
+
+	// collision kernel: for every game with pending[g] set, test the candidate
+	//   position (candidateX/Y/Rotation) and move the piece there if it fits.
+	//   moved[g] reports the result.
+	void moveKernel();
+
+	// lock game g's piece onto its board, remove completed rows, spawn the next shape
+	void lockAndSpawn(int game);
+
+	// spawn the next shape for game g, return false if it doesn't fit
+	bool spawn(int game);
+
+	// MEMBER VARIABLES
+
+	int gameCount;								// the # of games in the batch
+	std::vector<Gameboard::RowMask> rowMasks;	// every board, MAX_Y rows per game
+	std::vector<std::int8_t> shapes;			// the falling shape of each game
+	std::vector<std::int8_t> rotations;			// the rotation of each falling shape
+	std::vector<std::int8_t> pieceX;			// the gridLoc x of each falling shape
+	std::vector<std::int8_t> pieceY;			// the gridLoc y of each falling shape
+	std::vector<std::int8_t> nextShapes;		// the "on deck" shape of each game
+	std::vector<int> scores;					// the score of each game
+	std::vector<PieceRandomizer> randomizers;	// the shape sequence of each game
+
+	// per step scratch (kept here so step() never allocates)
+	std::vector<std::int8_t> candidateX;
+	std::vector<std::int8_t> candidateY;
+	std::vector<std::int8_t> candidateRotation;
+	std::vector<std::uint8_t> pending;			// 1 = test the candidate position
+	std::vector<std::uint8_t> moved;			// 1 = the candidate position was legal
+	std::vector<std::uint8_t> locking;			// 1 = the piece locks at the end of this step
+
+	std::uint64_t gameSteps = 0;
+	std::uint64_t gamesOver = 0;
+	std::uint64_t shapesPlaced = 0;
+};
+
+#endif /* BATCHENGINE_H */
@@ -0,0 +1,449 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include "BeamSearchBot.h"
+
+double BeamSearchBot::Stats::getNodesPerSecond() const
+{
+	return seconds > 0.0 ? nodes / seconds : 0.0;
+}
+
+double BeamSearchBot::Stats::getSecondsPerDecision() const
+{
+	return decisions > 0 ? seconds / decisions : 0.0;
+}
+
+// constructor - start the worker threads (with the default Settings)
+BeamSearchBot::BeamSearchBot()
+	: BeamSearchBot(Settings())
+{
+}
+
+// constructor - start the worker threads
+BeamSearchBot::BeamSearchBot(const Settings& settings)
+	: settings(settings)
+{
+	if (!this->settings.evaluator) {
+		this->settings.evaluator = evaluateDefault;
+	}
+	assert(this->settings.beamWidth > 0);
+
+	int threadCount = this->settings.threadCount;
+	if (threadCount <= 0) {
+		threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+
+	for (int w = 0; w < threadCount; w++) {
+		workers.emplace_back(new Worker());
+	}
+	for (std::vector<Node>& beam : beams) {
+		beam.resize(this->settings.beamWidth);
+	}
+	selected.reserve(this->settings.beamWidth);
+
+	for (int w = 1; w < threadCount; w++) {
+		threads.emplace_back(&BeamSearchBot::workerLoop, this, w);
+	}
+}
+
+// destructor - stop the worker threads
+BeamSearchBot::~BeamSearchBot()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	startCondition.notify_all();
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+// find the best placement for the falling shape (current) on a board,
+//   looking ahead at the next shape
+BeamSearchBot::Decision BeamSearchBot::decide(const Gameboard& board, const GridTetromino& current, Tetromino::TetShape next)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (std::unique_ptr<Worker>& worker : workers) {
+		worker->nodes = 0;
+		worker->tableHits = 0;
+	}
+
+	const Tetromino::TetShape shapes[] = { current.getShape(), next };
+	Candidate best{};
+	bool found = false;
+	bool fromTable = false;
+
+	// a decision from an earlier search of this board & shapes, if its placement
+	//   can still be reached from where the falling shape is now
+	TranspositionTable* table = settings.table.get();
+	std::uint64_t rootKey = 0;
+	if (table != nullptr) {
+		table->newSearch();
+		rootKey = TranspositionTable::makeKey(board.getOccupancyHash(), shapes[0], next);
+		TranspositionTable::Entry entry;
+		if (table->probe(rootKey, entry) && entry.depth >= LEVEL_COUNT) {
+			rootEnumerator.enumerate(board, current);
+			if (rootEnumerator.isReachable(entry.placement)) {
+				best.root = entry.placement;
+				best.score = entry.score;
+				found = true;
+				fromTable = true;
+				workers[0]->tableHits++;
+			}
+		}
+	}
+
+	int beamSize = 1;
+	int depth = 0;		// the # of levels searched
+
+	for (int level = 0; level < LEVEL_COUNT && !fromTable; level++) {
+		levelBeam = &beams[level % 2];
+		parentBeam = &beams[(level + 1) % 2];
+		buildNodes = (level > 0);
+		lastLevel = (level == LEVEL_COUNT - 1);
+		buildShape = (level > 0) ? shapes[level - 1] : shapes[0];
+		levelShape = shapes[level];
+		if (level == 0) {
+			// level 0 expands the root (the board as it is, with the falling shape where it is)
+			beams[0][0].board = board;
+			beams[0][0].rowsRemoved = 0;
+			levelStart = current;
+		}
+		else {
+			levelStart = GridTetromino();
+			levelStart.setShape(levelShape);
+			levelStart.setGridLoc(board.getSpawnLoc());
+		}
+		taskCount = beamSize;
+
+		runLevel();
+
+		// keep the best children for the next level (the best one is first)
+		selectCandidates(lastLevel ? 1 : settings.beamWidth);
+		if (selected.empty()) {
+			break;	// no placements (the next shape can't spawn): keep the previous best
+		}
+
+		if (level == 0) {
+			// the root's children are the placements of the falling shape
+			for (Candidate& candidate : selected) {
+				candidate.root = candidate.placement;
+			}
+		}
+		best = selected[0];
+		found = true;
+		depth = level + 1;
+		beamSize = static_cast<int>(selected.size());
+	}
+
+	Decision decision;
+	decision.found = found;
+	if (found) {
+		decision.placement = best.root;
+		decision.score = best.score;
+
+		// the workers' enumerators have moved on, so find the path again
+		if (!fromTable) {
+			rootEnumerator.enumerate(board, current);
+			if (table != nullptr) {
+				table->store(rootKey, best.root, best.score, depth);
+			}
+		}
+		rootEnumerator.getPath(best.root, decision.path);
+	}
+
+	// stats
+	lastStats = Stats();
+	lastStats.decisions = 1;
+	for (std::unique_ptr<Worker>& worker : workers) {
+		lastStats.nodes += worker->nodes;
+		lastStats.tableHits += worker->tableHits;
+	}
+	lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	lastStats.maxSeconds = lastStats.seconds;
+	totalStats.decisions++;
+	totalStats.nodes += lastStats.nodes;
+	totalStats.tableHits += lastStats.tableHits;
+	totalStats.seconds += lastStats.seconds;
+	totalStats.maxSeconds = std::max(totalStats.maxSeconds, lastStats.seconds);
+
+	return decision;
+}
+
+// (same as above) for the state of an engine
+BeamSearchBot::Decision BeamSearchBot::decide(const TetrisEngine& engine)
+{
+	return decide(engine.getBoard(), engine.getCurrentShape(), engine.getNextShape().getShape());
+}
+
+// return the next action to play in an engine (a policy)
+BeamSearchBot::Action BeamSearchBot::nextAction(const TetrisEngine& engine)
+{
+	if (engine.isGameOver()) {
+		return Action::NONE;
+	}
+
+	const GridTetromino& shape = engine.getCurrentShape();
+	bool onPlan = engine.getShapesPlaced() == plannedShapesPlaced
+		&& shape.getGridLoc().getX() == expectedX
+		&& shape.getGridLoc().getY() == expectedY
+		&& shape.getRotation() == expectedRotation
+		&& planIndex < plan.size();
+
+	if (!onPlan) {
+		// search from where the shape is now
+		Decision decision = decide(engine);
+		plan = decision.path;
+		// the moves down at the end of the path are what DROP does anyway
+		while (!plan.empty() && plan.back() == Action::DOWN) {
+			plan.pop_back();
+		}
+		plan.push_back(Action::DROP);
+		planIndex = 0;
+		plannedShapesPlaced = engine.getShapesPlaced();
+		expectedX = shape.getGridLoc().getX();
+		expectedY = shape.getGridLoc().getY();
+		expectedRotation = shape.getRotation();
+	}
+
+	Action action = plan[planIndex++];
+	switch (action) {
+	case Action::LEFT: expectedX--; break;
+	case Action::RIGHT: expectedX++; break;
+	case Action::DOWN: expectedY++; break;
+	case Action::ROTATE: expectedRotation = (expectedRotation + 1) % Tetromino::ROTATION_COUNT; break;
+	default: break;
+	}
+
+	return action;
+}
+
+const BeamSearchBot::Stats& BeamSearchBot::getLastStats() const
+{
+	return lastStats;
+}
+
+const BeamSearchBot::Stats& BeamSearchBot::getTotalStats() const
+{
+	return totalStats;
+}
+
+// the default evaluator: a weighted sum of aggregate height, rows removed, holes & bumpiness
+double BeamSearchBot::evaluateDefault(const BoardFeatures& features, int rowsRemoved)
+{
+	return -0.510066 * features.getAggregateHeight()
+		+ 0.760666 * rowsRemoved
+		- 0.35663 * features.getHoles()
+		- 0.184483 * features.getBumpiness();
+}
+
+// return a ParallelGameRunner policy factory: each policy owns a bot
+ParallelGameRunner::PolicyFactory BeamSearchBot::makePolicyFactory(const Settings& settings)
+{
+	return [settings]() -> ParallelGameRunner::Policy {
+		std::shared_ptr<BeamSearchBot> bot = std::make_shared<BeamSearchBot>(settings);
+		return [bot](const TetrisEngine& engine) { return bot->nextAction(engine); };
+	};
+}
+
+// Threads =======================================================
+
+// the body of each worker thread: wait for a level, run its tasks, repeat
+void BeamSearchBot::workerLoop(int workerIndex)
+{
+	std::uint64_t seenGeneration = 0;
+
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			startCondition.wait(lock, [&] { return stopping || levelGeneration != seenGeneration; });
+			if (stopping) {
+				return;
+			}
+			seenGeneration = levelGeneration;
+		}
+
+		runTasks(workerIndex);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--workersBusy == 0) {
+				doneCondition.notify_one();
+			}
+		}
+	}
+}
+
+// run the current level on every worker (including the calling thread)
+void BeamSearchBot::runLevel()
+{
+	for (std::unique_ptr<Worker>& worker : workers) {
+		worker->candidates.clear();
+	}
+	nextTask.store(0);
+
+	if (!threads.empty()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			workersBusy = static_cast<int>(threads.size());
+			levelGeneration++;
+		}
+		startCondition.notify_all();
+	}
+
+	runTasks(0);
+
+	if (!threads.empty()) {
+		std::unique_lock<std::mutex> lock(mutex);
+		doneCondition.wait(lock, [&] { return workersBusy == 0; });
+	}
+}
+
+// claim and run tasks of the current level until there are none left
+void BeamSearchBot::runTasks(int workerIndex)
+{
+	Worker& worker = *workers[workerIndex];
+
+	for (int task = nextTask.fetch_add(1); task < taskCount; task = nextTask.fetch_add(1)) {
+		runTask(worker, task);
+	}
+}
+
+// Search ========================================================
+
+// task: build beam node (from the previous level's selected candidate),
+//   then expand it with the level's shape
+void BeamSearchBot::runTask(Worker& worker, int nodeIndex)
+{
+	Node& node = (*levelBeam)[nodeIndex];
+
+	if (buildNodes) {
+		const Candidate& candidate = selected[nodeIndex];
+		node.board = (*parentBeam)[candidate.parent].board;
+		lockPlacement(node.board, buildShape, candidate.placement);
+		node.rowsRemoved = candidate.rowsRemoved;
+		node.root = candidate.root;
+	}
+
+	// on the last level only a node's best child is kept: it may be in the table
+	TranspositionTable* table = settings.table.get();
+	std::uint64_t key = 0;
+	if (lastLevel && table != nullptr) {
+		key = getNodeKey(node, levelShape);
+		TranspositionTable::Entry entry;
+		if (table->probe(key, entry)) {
+			Candidate candidate;
+			candidate.score = entry.score;
+			candidate.parent = nodeIndex;
+			candidate.rowsRemoved = node.rowsRemoved;
+			candidate.placement = entry.placement;
+			candidate.root = node.root;
+			worker.candidates.push_back(candidate);
+			worker.tableHits++;
+			return;
+		}
+	}
+
+	std::size_t firstCandidate = worker.candidates.size();
+	int count = worker.enumerator.enumerate(node.board, levelStart);
+
+	for (int i = 0; i < count; i++) {
+		const Placement& placement = worker.enumerator.getPlacement(i);
+
+		// score the child on a copy of the features (its board is only built if it is kept)
+		Gameboard::RowMask masks[Tetromino::BLOCK_COUNT];
+		GridTetromino placed = toGridTetromino(levelShape, placement);
+		int rowCount = placed.getRowMasksMappedToGrid(masks);
+		BoardFeatures features = node.board.getFeatures();
+		features.addRowMasks(placed.getMappedTopRow(), masks, rowCount);
+		int rowsRemoved = node.rowsRemoved + features.removeCompletedRows();
+
+		Candidate candidate;
+		candidate.score = static_cast<float>(settings.evaluator(features, rowsRemoved));
+		candidate.parent = nodeIndex;
+		candidate.rowsRemoved = rowsRemoved;
+		candidate.placement = placement;
+		candidate.root = node.root;
+		worker.candidates.push_back(candidate);
+	}
+
+	worker.nodes += count;
+
+	if (lastLevel && table != nullptr && count > 0) {
+		const Candidate* best = &worker.candidates[firstCandidate];
+		for (std::size_t i = firstCandidate + 1; i < worker.candidates.size(); i++) {
+			if (isBetter(worker.candidates[i], *best)) {
+				best = &worker.candidates[i];
+			}
+		}
+		table->store(key, best->placement, best->score, 1);
+	}
+}
+
+// return the table key of a node, to be expanded with shape
+std::uint64_t BeamSearchBot::getNodeKey(const Node& node, Tetromino::TetShape shape)
+{
+	// the evaluator scores the rows removed on the way to a board too
+	std::uint64_t rowsKey = static_cast<std::uint64_t>(node.rowsRemoved) * 0xC2B2AE3D27D4EB4FULL;
+	return TranspositionTable::makeKey(node.board.getOccupancyHash() ^ rowsKey, shape);
+}
+
+// keep the best beamWidth candidates of every worker (in a deterministic order)
+void BeamSearchBot::selectCandidates(int keep)
+{
+	selected.clear();
+	for (std::unique_ptr<Worker>& worker : workers) {
+		selected.insert(selected.end(), worker->candidates.begin(), worker->candidates.end());
+	}
+
+	if (static_cast<int>(selected.size()) > keep) {
+		std::nth_element(selected.begin(), selected.begin() + keep, selected.end(), isBetter);
+		selected.resize(keep);
+	}
+	std::sort(selected.begin(), selected.end(), isBetter);
+}
+
+// return true if candidate a ranks before b (higher score, then by parent & placement)
+bool BeamSearchBot::isBetter(const Candidate& a, const Candidate& b)
+{
+	if (a.score != b.score) {
+		return a.score > b.score;
+	}
+	if (a.parent != b.parent) {
+		return a.parent < b.parent;
+	}
+	if (a.placement.y != b.placement.y) {
+		return a.placement.y < b.placement.y;
+	}
+	if (a.placement.x != b.placement.x) {
+		return a.placement.x < b.placement.x;
+	}
+	return a.placement.rotation < b.placement.rotation;
+}
+
+// lock a placement of a shape onto a board & remove completed rows, return the # removed
+int BeamSearchBot::lockPlacement(Gameboard& board, Tetromino::TetShape shape, const Placement& placement)
+{
+	GridTetromino placed = toGridTetromino(shape, placement);
+
+	for (const Point& loc : placed.getBlockLocsMappedToGrid()) {
+		if (board.isValidPoint(loc)) {
+			board.setContent(loc, static_cast<int>(placed.getColor()));
+		}
+	}
+
+	return board.removeCompletedRows();
+}
+
+// return a placement of a shape as a GridTetromino
+GridTetromino BeamSearchBot::toGridTetromino(Tetromino::TetShape shape, const Placement& placement)
+{
+	GridTetromino placed;
+	placed.setShape(shape);
+	placed.setRotation(placement.rotation);
+	placed.setGridLoc(placement.x, placement.y);
+	return placed;
+}
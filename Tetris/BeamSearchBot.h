@@ -0,0 +1,216 @@
+// The BeamSearchBot is a built-in AI player. It can drive a TetrisGame (see its
+// autoplay key) or a headless TetrisEngine (eg: as a ParallelGameRunner policy).
+//
+// - Search: a beam search over the known pieces: the falling shape, then the "on
+//   deck" shape. Each level expands every node of the beam with every placement of
+//   that level's shape (PlacementEnumerator), scores each child with the evaluator,
+//   and keeps the best beamWidth children for the next level. The decision is the
+//   first placement on the way to the best leaf.
+// - Evaluation: pluggable. The evaluator scores a board from its BoardFeatures
+//   (heights, holes, bumpiness, wells) and the # of rows removed on the way there.
+//   A child is scored on a copy of its parent's features with the placement's blocks
+//   added (a few word operations): its board is only built if it joins the beam.
+// - Threads: each level is split into one task per beam node. The bot's worker
+//   threads (persistent, started by the constructor) and the calling thread claim
+//   tasks with an atomic counter, and each worker has its own enumerator, scratch
+//   features and candidate buffer, so nothing is locked while a level is expanded.
+//   A mutex & condition variables only start and finish each level.
+// - Transpositions: with a TranspositionTable (see Settings), the bot remembers the
+//   decision for each board & pair of shapes, and the best leaf under each last level
+//   node. Searching again from where a tick moved the falling shape (or another thread
+//   or bot reaching the same node) then costs a probe instead of an expansion.
+// - Stats: every decision reports the # of nodes evaluated and its latency, so the
+//   beam width & thread count can be tuned against a per-piece time budget.
+
+#ifndef BEAMSEARCHBOT_H
+#define BEAMSEARCHBOT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BoardFeatures.h"
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "ParallelGameRunner.h"
+#include "PlacementEnumerator.h"
+#include "TetrisEngine.h"
+#include "TranspositionTable.h"
+
+class BeamSearchBot
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	typedef TetrisEngine::Action Action;
+	typedef PlacementEnumerator::Placement Placement;
+
+	// scores a board (higher is better) from its features and the total # of rows
+	//   removed by the placements that led to it. Called from every search thread.
+	typedef std::function<double(const BoardFeatures& features, int rowsRemoved)> Evaluator;
+
+	// how to search
+	struct Settings {
+		int beamWidth = 24;			// the # of nodes kept at each level
+		int threadCount = 0;		// the # of search threads, including the caller (0 = one per hardware thread)
+		Evaluator evaluator;		// (empty = evaluateDefault)
+		std::shared_ptr<TranspositionTable> table;	// shared by the bots using it (null = none)
+	};
+
+	// the result of a search
+	struct Decision {
+		bool found = false;			// false if the falling shape has no placement
+		Placement placement{};		// where to lock the falling shape
+		std::vector<Action> path;	// the actions that move the falling shape there
+		double score = 0.0;			// the evaluation of the best leaf
+	};
+
+	// search statistics
+	struct Stats {
+		std::uint64_t decisions = 0;	// the # of searches
+		std::uint64_t nodes = 0;		// the # of nodes evaluated
+		std::uint64_t tableHits = 0;	// the # of searches & nodes found in the table
+		double seconds = 0.0;			// the time spent searching (the decision latency)
+		double maxSeconds = 0.0;		// the slowest decision
+
+		// return the # of nodes evaluated per second
+		double getNodesPerSecond() const;
+		// return the mean decision latency in seconds
+		double getSecondsPerDecision() const;
+	};
+
+	// constructor - start the worker threads (with the default Settings)
+	BeamSearchBot();
+	// constructor - start the worker threads
+	explicit BeamSearchBot(const Settings& settings);
+	// destructor - stop the worker threads
+	~BeamSearchBot();
+
+	BeamSearchBot(const BeamSearchBot&) = delete;
+	BeamSearchBot& operator=(const BeamSearchBot&) = delete;
+
+	// find the best placement for the falling shape (current) on a board,
+	//   looking ahead at the next shape
+	Decision decide(const Gameboard& board, const GridTetromino& current, Tetromino::TetShape next);
+	// (same as above) for the state of an engine
+	Decision decide(const TetrisEngine& engine);
+
+	// return the next action to play in an engine (a policy): follows the path of the
+	//   last decision, then drops. Searches again for every new shape, and whenever the
+	//   shape isn't where the path expects it (eg: a tick moved it down).
+	Action nextAction(const TetrisEngine& engine);
+
+	// return the stats of the last decision
+	const Stats& getLastStats() const;
+	// return the stats of every decision so far
+	const Stats& getTotalStats() const;
+
+	// the default evaluator: a weighted sum of aggregate height, rows removed,
+	//   holes & bumpiness (weights tuned by genetic search for a 10 wide board)
+	static double evaluateDefault(const BoardFeatures& features, int rowsRemoved);
+
+	// return a ParallelGameRunner policy factory: each policy owns a bot
+	static ParallelGameRunner::PolicyFactory makePolicyFactory(const Settings& settings);
+
+private:
+	// CONSTANTS
+	static const int LEVEL_COUNT = 2;	// the # of pieces searched (the falling & on deck shapes)
+
+	// a beam entry: a board reached by placing the pieces so far
+	struct Node {
+		Gameboard board;
+		int rowsRemoved = 0;		// rows removed on the way here
+		Placement root{};			// the placement of the falling shape on the way here
+	};
+
+	// a child of a beam node, before it is built (if it is kept)
+	struct Candidate {
+		float score;				// (a float, like the table stores, so hits & misses rank the same)
+		int parent;					// the index of its parent in the beam
+		int rowsRemoved;
+		Placement placement;		// the placement of this level's shape
+		Placement root;
+	};
+
+	// the search state of a worker (only ever touched by that worker during a level)
+	struct Worker {
+		PlacementEnumerator enumerator;
+		std::vector<Candidate> candidates;
+		std::uint64_t nodes = 0;
+		std::uint64_t tableHits = 0;
+	};
+
+	// the body of each worker thread: wait for a level, run its tasks, repeat
+	void workerLoop(int workerIndex);
+
+	// run the current level on every worker (including the calling thread)
+	void runLevel();
+
+	// claim and run tasks of the current level until there are none left
+	void runTasks(int workerIndex);
+
+	// task: build beam node (from the previous level's selected candidate),
+	//   then expand it with the level's shape
+	void runTask(Worker& worker, int nodeIndex);
+
+	// return the table key of a node, to be expanded with shape
+	static std::uint64_t getNodeKey(const Node& node, Tetromino::TetShape shape);
+
+	// keep the best beamWidth candidates of every worker (in a deterministic order)
+	void selectCandidates(int keep);
+
+	// return true if candidate a ranks before b (higher score, then by parent & placement)
+	static bool isBetter(const Candidate& a, const Candidate& b);
+
+	// lock a placement of a shape onto a board & remove completed rows, return the # removed
+	static int lockPlacement(Gameboard& board, Tetromino::TetShape shape, const Placement& placement);
+
+	// return a placement of a shape as a GridTetromino
+	static GridTetromino toGridTetromino(Tetromino::TetShape shape, const Placement& placement);
+
+	// MEMBER VARIABLES
+
+	Settings settings;
+	std::vector<std::unique_ptr<Worker>> workers;	// [0] is the calling thread
+	std::vector<std::thread> threads;				// workers 1 and up
+	std::vector<Node> beams[2];						// the beam of the previous & current level
+	std::vector<Candidate> selected;				// the candidates kept from the previous level
+	PlacementEnumerator rootEnumerator;				// rebuilds the decision's path
+
+	// the current level (written by runLevel()'s caller before it starts)
+	const std::vector<Node>* parentBeam = nullptr;	// the beam selected was expanded from
+	std::vector<Node>* levelBeam = nullptr;			// the nodes to build & expand
+	Tetromino::TetShape buildShape = Tetromino::TetShape::S;	// the shape of the selected placements
+	Tetromino::TetShape levelShape = Tetromino::TetShape::S;	// the shape placed at this level
+	GridTetromino levelStart;						// where levelShape starts
+	bool buildNodes = false;						// false: levelBeam is already built (the root)
+	bool lastLevel = false;							// true: only the best child of each node matters
+	int taskCount = 0;
+	std::atomic<int> nextTask{ 0 };
+
+	// level start/finish (not on the hot path)
+	std::mutex mutex;
+	std::condition_variable startCondition;
+	std::condition_variable doneCondition;
+	std::uint64_t levelGeneration = 0;
+	int workersBusy = 0;
+	bool stopping = false;
+
+	// nextAction() state
+	std::vector<Action> plan;						// the actions left to play
+	std::size_t planIndex = 0;
+	int plannedShapesPlaced = -1;					// the engine's shapesPlaced when planned
+	int expectedX = 0;								// where the plan expects the falling shape
+	int expectedY = 0;
+	int expectedRotation = 0;
+
+	Stats lastStats;
+	Stats totalStats;
+};
+
+#endif /* BEAMSEARCHBOT_H */
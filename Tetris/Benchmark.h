@@ -0,0 +1,534 @@
+// Throughput benchmarks for the headless simulation code.
+// Run them by starting the program with the --benchmark argument, eg:
+//   Tetris.exe --benchmark
+// (build in Release: the numbers are meaningless with a Debug build)
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include "BatchEngine.h"
+#include "ParallelGameRunner.h"
+#include "PlacementEnumerator.h"
+#include "ReplayCorpus.h"
+#include "ReplayCorpusWriter.h"
+#include "ReplayPlayer.h"
+#include "ReplayRecorder.h"
+#include "BeamSearchBot.h"
+#include "TetrisEngine.h"
+#include "TranspositionTable.h"
+#include "VersusSession.h"
+#include "LatencySimulator.h"
+#include "FrameTimings.h"
+
+class Benchmark
+{
+public:
+	static bool runBenchmarks()
+	{
+		std::cout << "Running Benchmarks -----------------------" << "\n";
+
+		Benchmark::runTetrisEngineBenchmark(1024, 2000);
+		Benchmark::runBatchEngineBenchmark(1024, 2000);
+		Benchmark::runBatchEngineBenchmark(16384, 200);
+		Benchmark::runParallelGameRunnerBenchmark(1, 2000);
+		Benchmark::runParallelGameRunnerBenchmark(0, 2000);
+		Benchmark::runPlacementEnumeratorBenchmark(200000);
+		Benchmark::runBeamSearchBotBenchmark(1, 500, 0);
+		Benchmark::runBeamSearchBotBenchmark(0, 500, 0);
+		Benchmark::runBeamSearchBotBenchmark(0, 500, 64);
+		Benchmark::runReplayRecorderBenchmark(500);
+		Benchmark::runReplaySeekBenchmark(2000, 1000);
+		Benchmark::runSnapshotBenchmark(1000000);
+		Benchmark::runReplayCorpusBenchmark(0, 200000);
+		Benchmark::runVersusSessionBenchmark(9000, 0.05, 0.1);
+		Benchmark::runFrameTimingsBenchmark(1000000);
+
+		std::cout << "Benchmarks complete ----------------------" << "\n";
+		return true;
+	}
+
+	// build a table of pseudo-random actions (mostly moves & rotations, some drops)
+	//   so that generating actions isn't part of what is measured.
+	static std::vector<TetrisEngine::Action> makeActionTable(int size)
+	{
+		const TetrisEngine::Action choices[] = {
+			TetrisEngine::Action::NONE, TetrisEngine::Action::NONE,
+			TetrisEngine::Action::LEFT, TetrisEngine::Action::RIGHT,
+			TetrisEngine::Action::ROTATE, TetrisEngine::Action::DOWN,
+			TetrisEngine::Action::LEFT, TetrisEngine::Action::DROP
+		};
+
+		std::vector<TetrisEngine::Action> actions(size);
+		std::uint32_t x = 12345;
+		for (int i = 0; i < size; i++) {
+			x = x * 1664525u + 1013904223u;
+			actions[i] = choices[x >> 29];
+		}
+		return actions;
+	}
+
+	// step gameCount independent games in a BatchEngine, report game-steps/second
+	static double runBatchEngineBenchmark(int gameCount, int stepCount)
+	{
+		std::vector<TetrisEngine::Action> table = makeActionTable(gameCount + stepCount);
+		BatchEngine batch(gameCount, 1);
+
+		auto start = std::chrono::steady_clock::now();
+		for (int s = 0; s < stepCount; s++) {
+			batch.step(&table[s]);
+		}
+		std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+		double stepsPerSecond = batch.getGameSteps() / seconds.count();
+		std::cout << " BatchEngine  " << gameCount << " games x " << stepCount << " steps: "
+			<< stepsPerSecond << " game-steps/s, " << batch.getShapesPlaced() << " shapes placed, "
+			<< batch.getGamesOver() << " games over" << "\n";
+		return stepsPerSecond;
+	}
+
+	// the same workload with one TetrisEngine per game, for comparison
+	//   (each step applies an action and exactly one tick of virtual time)
+	static double runTetrisEngineBenchmark(int gameCount, int stepCount)
+	{
+		std::vector<TetrisEngine::Action> table = makeActionTable(gameCount + stepCount);
+		std::vector<TetrisEngine> engines;
+		engines.reserve(gameCount);
+		for (int g = 0; g < gameCount; g++) {
+			engines.emplace_back(1 + g);
+		}
+
+		std::uint64_t gameSteps = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int s = 0; s < stepCount; s++) {
+			for (int g = 0; g < gameCount; g++) {
+				TetrisEngine& engine = engines[g];
+				engine.step(table[s + g], engine.getSecondsPerTick() * 1.0001);
+				if (engine.isGameOver()) {
+					engine.reset();
+				}
+			}
+			gameSteps += gameCount;
+		}
+		std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+		double stepsPerSecond = gameSteps / seconds.count();
+		std::cout << " TetrisEngine " << gameCount << " games x " << stepCount << " steps: "
+			<< stepsPerSecond << " game-steps/s" << "\n";
+		return stepsPerSecond;
+	}
+
+	// play gameCount whole games with random policies on threadCount threads
+	//   (0 = one per hardware thread), report games/second
+	static double runParallelGameRunnerBenchmark(int threadCount, int gameCount)
+	{
+		ParallelGameRunner::Settings settings;
+		settings.gameCount = gameCount;
+		settings.baseSeed = 1;
+		settings.threadCount = threadCount;
+		settings.maxShapesPerGame = 200;
+
+		ParallelGameRunner::Results results = ParallelGameRunner::run(settings, ParallelGameRunner::makeRandomPolicyFactory(1));
+
+		double gamesPerSecond = results.gamesPlayed / results.seconds;
+		std::cout << " ParallelGameRunner " << results.threadCount << " threads x " << gameCount << " games: "
+			<< gamesPerSecond << " games/s, mean score " << results.getMeanScore() << ", "
+			<< results.steals << " steals" << "\n";
+		return gamesPerSecond;
+	}
+
+	// enumerate the placements of every shape on boards taken from random games,
+	//   report boards/second (one enumeration per board)
+	static double runPlacementEnumeratorBenchmark(int boardCount)
+	{
+		// collect some realistic boards first
+		const int BOARDS = 64;
+		std::vector<TetrisEngine::Action> table = makeActionTable(BOARDS * 50);
+		std::vector<Gameboard> boards;
+		TetrisEngine engine(3);
+		for (int i = 0; (int)boards.size() < BOARDS; i++) {
+			engine.step(table[i % table.size()], engine.getSecondsPerTick() * 1.0001);
+			if (engine.isGameOver()) {
+				engine.reset();
+			}
+			if (i % 50 == 49) {
+				boards.push_back(engine.getBoard());
+			}
+		}
+
+		PlacementEnumerator enumerator;
+		std::uint64_t placements = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < boardCount; i++) {
+			Tetromino::TetShape shape = static_cast<Tetromino::TetShape>(i % TetrominoTable::SHAPE_COUNT);
+			placements += enumerator.enumerate(boards[i % BOARDS], shape);
+		}
+		std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+		double boardsPerSecond = boardCount / seconds.count();
+		std::cout << " PlacementEnumerator " << boardCount << " boards: " << boardsPerSecond << " boards/s, "
+			<< static_cast<double>(placements) / boardCount << " placements per board" << "\n";
+		return boardsPerSecond;
+	}
+
+	// play the same bot game (one action per 1/30s frame, like TetrisGame's autoplay)
+	//   gameCount times with & without recording it, report the recording cost per
+	//   frame and the replay size per piece
+	static double runReplayRecorderBenchmark(int gameCount)
+	{
+		// the bot's actions, played once
+		const int PIECES = 300;
+		BeamSearchBot::Settings settings;
+		settings.threadCount = 1;
+		BeamSearchBot bot(settings);
+		TetrisEngine game(7);
+		std::vector<TetrisEngine::Action> actions;
+		while (game.getShapesPlaced() < PIECES && !game.isGameOver()) {
+			actions.push_back(bot.nextAction(game));
+			game.step(actions.back(), 1.0 / 30);
+		}
+
+		const char* path = "Benchmark.replay";
+		double seconds[2];
+		std::uint64_t bytes = 0;
+		for (int recording = 0; recording < 2; recording++) {
+			ReplayRecorder recorder;
+			TetrisEngine engine(7);
+			auto start = std::chrono::steady_clock::now();
+			for (int g = 0; g < gameCount; g++) {
+				engine.reset(7);
+				if (recording) {
+					recorder.start(path, engine);
+				}
+				for (TetrisEngine::Action action : actions) {
+					engine.applyAction(action);
+					recorder.recordAction(engine, action);
+					engine.update(1.0 / 30);
+					recorder.recordUpdate(engine);
+				}
+				recorder.stop(engine);
+			}
+			recorder.flush();
+			seconds[recording] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			bytes = recorder.getBytesRecorded();
+		}
+		std::remove(path);
+
+		double frames = static_cast<double>(actions.size()) * gameCount;
+		double nanosecondsPerFrame = (seconds[1] - seconds[0]) * 1e9 / frames;
+		std::cout << " ReplayRecorder " << gameCount << " games x " << actions.size() << " frames: "
+			<< nanosecondsPerFrame << " ns/frame to record (writing included), "
+			<< static_cast<double>(bytes) / game.getShapesPlaced() << " bytes per piece" << "\n";
+		return nanosecondsPerFrame;
+	}
+
+	// record a bot game of pieceCount pieces with & without keyframes, then seek
+	//   seekCount times to random shapes in each, report the time per seek
+	static double runReplaySeekBenchmark(int seekCount, int pieceCount)
+	{
+		const char* paths[2] = { "Benchmark-1.replay", "Benchmark-2.replay" };
+		{
+			BeamSearchBot::Settings settings;
+			settings.beamWidth = 4;
+			settings.threadCount = 1;
+			BeamSearchBot bot(settings);
+			ReplayRecorder recorders[2];
+			recorders[1].setKeyframeInterval(0);
+			TetrisEngine game(7);
+			for (int i = 0; i < 2; i++) {
+				recorders[i].start(paths[i], game);
+			}
+			while (game.getShapesPlaced() < pieceCount && !game.isGameOver()) {
+				TetrisEngine::Action action = bot.nextAction(game);
+				game.applyAction(action);
+				game.update(1.0 / 30);
+				for (ReplayRecorder& recorder : recorders) {
+					recorder.recordAction(game, action);
+					recorder.recordUpdate(game);
+				}
+			}
+			for (ReplayRecorder& recorder : recorders) {
+				recorder.stop(game);
+			}
+		}
+
+		double microsecondsPerSeek[2];
+		int shapeCount = 0;
+		for (int i = 0; i < 2; i++) {
+			ReplayPlayer player;
+			player.load(paths[i]);
+			TetrisEngine engine;
+			player.play(engine);
+			shapeCount = engine.getShapesPlaced();
+
+			// (scattered over the whole game)
+			auto start = std::chrono::steady_clock::now();
+			for (int s = 0; s < seekCount; s++) {
+				player.seek(engine, s * 7919 % (shapeCount + 1));
+			}
+			microsecondsPerSeek[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / seekCount;
+			std::remove(paths[i]);
+		}
+
+		std::cout << " ReplayPlayer seek in a " << shapeCount << " shape replay: " << microsecondsPerSeek[0]
+			<< " us from keyframes (vs " << microsecondsPerSeek[1] << " us from the start)" << "\n";
+		return microsecondsPerSeek[0];
+	}
+
+	// save & restore a game's snapshot count times each, through a ring buffer of
+	//   snapshots (like a rollback or an undo history), and the same with the
+	//   compact State (getState() & setState()) for comparison
+	static double runSnapshotBenchmark(int count)
+	{
+		const int RING = 4096;
+		std::vector<TetrisEngine::Snapshot> ring(RING);
+		TetrisEngine engine(3);
+		for (int s = 0; s < 200; s++) {
+			engine.step(TetrisEngine::Action::DROP, 0.1);	// (a board with blocks)
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		for (int s = 0; s < count; s++) {
+			engine.save(ring[s % RING]);
+		}
+		double saveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		start = std::chrono::steady_clock::now();
+		for (int s = 0; s < count; s++) {
+			engine.restore(ring[s * 7 % RING]);
+		}
+		double restoreSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		start = std::chrono::steady_clock::now();
+		for (int s = 0; s < count / 10; s++) {
+			engine.setState(engine.getState());
+		}
+		double stateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 10;
+
+		double nanosecondsPerCopy = (saveSeconds + restoreSeconds) * 1e9 / (2.0 * count);
+		std::cout << " TetrisEngine::Snapshot (" << sizeof(TetrisEngine::Snapshot) << " bytes): "
+			<< saveSeconds * 1e9 / count << " ns/save, " << restoreSeconds * 1e9 / count << " ns/restore (vs "
+			<< stateSeconds * 1e9 / count << " ns for getState() + setState())" << "\n";
+		return nanosecondsPerCopy;
+	}
+
+	// gather gameCount replays (random policy games, played at 30 frames per second)
+	//   into a corpus, then scan it on threadCount threads (0 = one per hardware thread):
+	//   its events only, then replaying every game through an engine
+	static double runReplayCorpusBenchmark(int threadCount, int gameCount)
+	{
+		// record a few distinct games, and repeat them
+		const int DISTINCT_GAMES = 64;
+		const char* replayPath = "Benchmark.replay";
+		const char* corpusPath = "Benchmark.corpus";
+		std::vector<std::vector<std::uint8_t>> replays;
+		{
+			ParallelGameRunner::PolicyFactory makePolicy = ParallelGameRunner::makeRandomPolicyFactory(11);
+			ParallelGameRunner::Policy policy = makePolicy();
+			ReplayRecorder recorder;
+			TetrisEngine engine;
+			for (int g = 0; g < DISTINCT_GAMES; g++) {
+				engine.reset(ParallelGameRunner::getGameSeed(11, g));
+				recorder.start(replayPath, engine);
+				while (!engine.isGameOver()) {
+					TetrisEngine::Action action = policy(engine);
+					engine.applyAction(action);
+					recorder.recordAction(engine, action);
+					engine.update(1.0 / 30);
+					recorder.recordUpdate(engine);
+				}
+				recorder.stop(engine);
+				recorder.flush();
+				std::ifstream file(replayPath, std::ios::binary);
+				replays.emplace_back((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			}
+		}
+		std::remove(replayPath);
+
+		ReplayCorpusWriter writer;
+		writer.open(corpusPath);
+		for (int g = 0; g < gameCount; g++) {
+			const std::vector<std::uint8_t>& replay = replays[g % DISTINCT_GAMES];
+			writer.add(replay.data(), replay.size());
+		}
+		writer.close();
+
+		ReplayCorpus corpus;
+		corpus.open(corpusPath);
+		int threads = threadCount > 0 ? threadCount : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+		std::vector<std::uint64_t> shardEvents(threads, 0);		// (one counter per shard: nothing shared)
+		std::vector<std::uint64_t> shardShapes(threads, 0);
+
+		// scan the events
+		auto start = std::chrono::steady_clock::now();
+		corpus.forEachGameParallel(threads, [&shardEvents](int shard, std::uint64_t, ReplayPlayer& player) {
+			ReplayFormat::Event events[256];
+			std::uint64_t eventCount = 0;
+			std::size_t count;
+			while ((count = player.nextEvents(events, 256)) > 0) {
+				eventCount += count;
+			}
+			shardEvents[shard] += eventCount;
+		});
+		double scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		// replay the games
+		start = std::chrono::steady_clock::now();
+		corpus.forEachGameParallel(threads, [&shardShapes](int shard, std::uint64_t, ReplayPlayer& player) {
+			TetrisEngine engine;
+			player.start(engine);
+			player.play(engine);
+			shardShapes[shard] += engine.getShapesPlaced();
+		});
+		double replaySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::uint64_t events = 0, shapes = 0;
+		for (int s = 0; s < threads; s++) {
+			events += shardEvents[s];
+			shapes += shardShapes[s];
+		}
+		double gigabytesPerSecond = corpus.getSize() / scanSeconds / 1e9;
+		std::cout << " ReplayCorpus " << gameCount << " games (" << corpus.getSize() / 1e6 << " MB) on " << threads << " threads: "
+			<< gigabytesPerSecond << " GB/s scanning " << events << " events, "
+			<< gameCount / replaySeconds << " games/s (" << shapes / replaySeconds << " shapes/s) replaying" << "\n";
+
+		corpus.close();
+		std::remove(corpusPath);
+		return gigabytesPerSecond;
+	}
+
+	// play frameCount frames of a versus game between 2 sessions connected by a
+	//   simulated network (latency + jitter), both players making random inputs
+	//   (a worst case: most frames have an input to mispredict). Report the cost of a
+	//   frame (its share of the rollbacks included) & of the longest rollback possible.
+	static double runVersusSessionBenchmark(int frameCount, double latencySeconds, double jitterSeconds)
+	{
+		VersusSession first(1), second(2);
+		VersusSession* sessions[VersusSession::PLAYER_COUNT] = { &first, &second };
+		LatencySimulator links[VersusSession::PLAYER_COUNT];
+		ParallelGameRunner::Policy policies[VersusSession::PLAYER_COUNT];
+		for (int i = 0; i < VersusSession::PLAYER_COUNT; i++) {
+			LatencySimulator::Settings settings;
+			settings.latencySeconds = latencySeconds;
+			settings.jitterSeconds = jitterSeconds;
+			settings.seed = i + 1;
+			links[i].setSettings(settings);
+			policies[i] = ParallelGameRunner::makeRandomPolicyFactory(i + 1)();
+		}
+
+		std::vector<std::uint8_t> packet;
+		double sessionSeconds = 0.0;	// (the time spent in the sessions, not the simulated network)
+		for (int tick = 0; tick < frameCount; tick++) {
+			double now = tick * VersusSession::FRAME_SECONDS;
+			for (int i = 0; i < VersusSession::PLAYER_COUNT; i++) {
+				VersusSession& session = *sessions[i];
+				TetrisEngine::Action action = policies[i](session.getEngine(session.getLocalPlayer()));
+
+				auto start = std::chrono::steady_clock::now();
+				while (links[1 - i].receive(packet, now)) {
+					session.receivePacket(packet.data(), packet.size());
+				}
+				session.advanceFrame(action);
+				session.writePacket(packet);
+				sessionSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+				links[i].send(packet.data(), packet.size(), now);
+			}
+		}
+
+		// the longest rollback: restore a state & simulate MAX_PREDICTION_FRAMES frames
+		const int REPEATS = 1000;
+		VersusSession::State state = first.getState();
+		VersusSession::State saved = state;
+		const TetrisEngine::Action inputs[VersusSession::PLAYER_COUNT] = { TetrisEngine::Action::LEFT, TetrisEngine::Action::ROTATE };
+		auto start = std::chrono::steady_clock::now();
+		for (int r = 0; r < REPEATS; r++) {
+			state = saved;
+			for (int f = 0; f < VersusSession::MAX_PREDICTION_FRAMES; f++) {
+				VersusSession::simulateFrame(state, first.getSeed(), inputs);
+			}
+		}
+		double rollbackSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / REPEATS;
+
+		std::uint64_t rollbacks = first.getRollbackCount() + second.getRollbackCount();
+		std::uint64_t resimulated = first.getResimulatedFrameCount() + second.getResimulatedFrameCount();
+		double secondsPerFrame = sessionSeconds / (2.0 * frameCount);
+		std::cout << " VersusSession " << frameCount << " frames, " << latencySeconds * 1000.0 << "+" << jitterSeconds * 1000.0
+			<< " ms latency: " << secondsPerFrame * 1e6 << " us/frame, " << rollbacks << " rollbacks of "
+			<< (rollbacks ? static_cast<double>(resimulated) / rollbacks : 0.0) << " frames (avg), "
+			<< first.getStallCount() + second.getStallCount() << " stalls, "
+			<< (first.isDesynced() || second.isDesynced() ? "DESYNCED" : "in sync") << ", "
+			<< VersusSession::MAX_PREDICTION_FRAMES << " frame rollback: " << rollbackSeconds * 1e6 << " us" << "\n";
+		return secondsPerFrame;
+	}
+
+	// let a bot play pieceCount pieces (with a tick every 4 actions, so it searches
+	//   again as pieces fall), report its nodes/s & decision latency.
+	//   tableMegabytes = the size of its transposition table (0 = none)
+	static double runBeamSearchBotBenchmark(int threadCount, int pieceCount, int tableMegabytes)
+	{
+		BeamSearchBot::Settings settings;
+		settings.threadCount = threadCount;
+		if (tableMegabytes > 0) {
+			settings.table = std::make_shared<TranspositionTable>(tableMegabytes);
+		}
+		BeamSearchBot bot(settings);
+
+		TetrisEngine engine(3);
+		while (engine.getShapesPlaced() < pieceCount) {
+			engine.step(bot.nextAction(engine), engine.getSecondsPerTick() * 0.2501);
+			if (engine.isGameOver()) {
+				engine.reset();
+			}
+		}
+
+		const BeamSearchBot::Stats& stats = bot.getTotalStats();
+		std::cout << " BeamSearchBot " << pieceCount << " pieces, " << threadCount << " threads (0 = all), "
+			<< tableMegabytes << " MB table: " << stats.getNodesPerSecond() << " nodes/s, "
+			<< stats.getSecondsPerDecision() * 1000.0 << " ms/decision (max " << stats.maxSeconds * 1000.0 << " ms), "
+			<< stats.tableHits << " table hits, score " << engine.getScore() << "\n";
+		return stats.getNodesPerSecond();
+	}
+
+	// record the phases of frameCount frames, as the game does (a simulation loop &
+	//   a rendered frame: 5 clock reads & 7 records), with the FrameTimings on & off,
+	//   report the cost of a frame's instrumentation (it should stay under 1 us)
+	static double runFrameTimingsBenchmark(int frameCount)
+	{
+		typedef FrameTimings::Phase Phase;
+		FrameTimings timings;
+		double nanosecondsPerFrame[2] = {};
+		for (int enabled = 0; enabled < 2; enabled++) {
+			timings.setEnabled(enabled != 0);
+			auto start = std::chrono::steady_clock::now();
+			for (int f = 0; f < frameCount; f++) {
+				FrameTimings::Clock::time_point phaseStart = FrameTimings::now();
+				timings.record(Phase::INPUT, phaseStart);
+				timings.record(Phase::SIMULATION, phaseStart);
+				timings.record(Phase::TICK_JITTER, (f % 97) * 1e-6);
+				phaseStart = FrameTimings::now();
+				timings.record(Phase::DRAW, phaseStart);
+				timings.record(Phase::PRESENT, phaseStart);
+				timings.record(Phase::FRAME, 0.016 + (f % 13) * 1e-4);
+				timings.record(Phase::INPUT_LATENCY, 0.02);
+			}
+			nanosecondsPerFrame[enabled] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e9 / frameCount;
+		}
+
+		const TimingHistogram& frames = timings.getHistogram(Phase::FRAME);
+		std::cout << " FrameTimings " << frameCount << " frames: " << nanosecondsPerFrame[1] << " ns/frame on, "
+			<< nanosecondsPerFrame[0] << " ns/frame off (frame p50 " << frames.getPercentile(0.5) << " us, p99 "
+			<< frames.getPercentile(0.99) << " us, max " << frames.getMax() << " us)" << "\n";
+		return nanosecondsPerFrame[1];
+	}
+};
+
+#endif /* BENCHMARK_H */
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include "BoardFeatures.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// constructor - an empty board
+BoardFeatures::BoardFeatures()
+{
+	for (int x = 0; x < MAX_X; x++) {
+		columns[x] = 0;
+	}
+	recomputeAll();
+}
+
+// set a cell occupied or empty
+void BoardFeatures::setCell(int x, int y, bool occupied)
+{
+	assert(x >= 0 && x < MAX_X && y >= 0 && y < MAX_Y);
+
+	ColumnMask column = occupied ? (columns[x] | (1u << y)) : (columns[x] & ~(1u << y));
+	if (column != columns[x]) {
+		columns[x] = column;
+		updateColumn(x);
+	}
+}
+
+// set the occupancy of a whole row
+void BoardFeatures::setRow(int y, RowMask mask)
+{
+	for (int x = 0; x < MAX_X; x++) {
+		setCell(x, y, ((mask >> x) & 1) != 0);
+	}
+}
+
+// occupy the cells of masks, where masks[0] is row topRow, masks[1] the row below, etc.
+void BoardFeatures::addRowMasks(int topRow, const RowMask masks[], int rowCount)
+{
+	for (int i = 0; i < rowCount; i++) {
+		int y = topRow + i;
+		if (y < 0 || y >= MAX_Y) {
+			continue;
+		}
+		for (unsigned mask = masks[i]; mask != 0; mask &= mask - 1) {
+			setCell(countTrailingZeros(mask), y, true);
+		}
+	}
+}
+
+// remove rows (the rows above each one slide down), rowIndices must be in ascending order
+void BoardFeatures::removeRows(const int rowIndices[], int rowCount)
+{
+	if (rowCount == 0) {
+		return;
+	}
+
+	// removing row y moves every bit above it (below y) down one bit. Going top to
+	//   bottom, the rows still to be removed (further down) don't move.
+	for (int i = 0; i < rowCount; i++) {
+		assert(i == 0 || rowIndices[i] > rowIndices[i - 1]);
+		ColumnMask above = (1u << rowIndices[i]) - 1;
+		ColumnMask below = ~((above << 1) | 1);
+		for (int x = 0; x < MAX_X; x++) {
+			columns[x] = (columns[x] & below) | ((columns[x] & above) << 1);
+		}
+	}
+
+	recomputeAll();
+}
+
+// remove all completed rows, return the # of rows removed
+int BoardFeatures::removeCompletedRows()
+{
+	int rowIndices[MAX_Y];
+	int rowCount = 0;
+
+	for (ColumnMask completed = getCompletedRows(); completed != 0; completed &= completed - 1) {
+		rowIndices[rowCount++] = countTrailingZeros(completed);
+	}
+	removeRows(rowIndices, rowCount);
+
+	return rowCount;
+}
+
+// Features ======================================================
+
+int BoardFeatures::getColumnHeight(int x) const
+{
+	return heights[x];
+}
+
+int BoardFeatures::getColumnHoles(int x) const
+{
+	return holes[x];
+}
+
+BoardFeatures::ColumnMask BoardFeatures::getColumnMask(int x) const
+{
+	return columns[x];
+}
+
+int BoardFeatures::getAggregateHeight() const
+{
+	return aggregateHeight;
+}
+
+int BoardFeatures::getMaxHeight() const
+{
+	ColumnMask occupied = 0;
+	for (int x = 0; x < MAX_X; x++) {
+		occupied |= columns[x];
+	}
+	return occupied == 0 ? 0 : MAX_Y - countTrailingZeros(occupied);
+}
+
+int BoardFeatures::getHoles() const
+{
+	return holeCount;
+}
+
+int BoardFeatures::getBumpiness() const
+{
+	return bumpiness;
+}
+
+int BoardFeatures::getWellDepth() const
+{
+	return wellDepth;
+}
+
+BoardFeatures::ColumnMask BoardFeatures::getCompletedRows() const
+{
+	ColumnMask completed = (1u << MAX_Y) - 1;
+	for (int x = 0; x < MAX_X; x++) {
+		completed &= columns[x];
+	}
+	return completed;
+}
+
+// return how many rows a shape can drop straight down
+int BoardFeatures::getDropDistance(int leftColumn, const int bottoms[], int columnCount) const
+{
+	int distance = MAX_Y;
+
+	for (int i = 0; i < columnCount; i++) {
+		int x = leftColumn + i;
+		int bottom = bottoms[i];
+		assert(x >= 0 && x < MAX_X && bottom < MAX_Y);
+
+		// the row of the first block below the shape (MAX_Y = the floor)
+		int landingRow = MAX_Y - heights[x];
+		if (bottom >= landingRow) {
+			// under an overhang: look for blocks below the shape's bottom
+			ColumnMask below = columns[x] & ~((2u << bottom) - 1);
+			landingRow = (below == 0) ? MAX_Y : countTrailingZeros(below);
+		}
+
+		distance = std::min(distance, landingRow - 1 - bottom);
+	}
+
+	return distance;
+}
+
+// Tracking ======================================================
+
+// recompute a column's height & holes after its mask changed, and update the totals
+void BoardFeatures::updateColumn(int x)
+{
+	// take out the terms that depend on this column's height...
+	bumpiness -= getBumpinessTerm(x - 1) + getBumpinessTerm(x);
+	wellDepth -= getWellTerm(x - 1) + getWellTerm(x) + getWellTerm(x + 1);
+	aggregateHeight -= heights[x];
+	holeCount -= holes[x];
+
+	// (the highest block is the lowest set bit, every cell below it is a block or a hole)
+	int height = columns[x] == 0 ? 0 : MAX_Y - countTrailingZeros(columns[x]);
+	heights[x] = static_cast<std::int8_t>(height);
+	holes[x] = static_cast<std::int8_t>(height - countBits(columns[x]));
+
+	// ...and put them back with the new height
+	bumpiness += getBumpinessTerm(x - 1) + getBumpinessTerm(x);
+	wellDepth += getWellTerm(x - 1) + getWellTerm(x) + getWellTerm(x + 1);
+	aggregateHeight += heights[x];
+	holeCount += holes[x];
+}
+
+// recompute every column and total (after rows were removed)
+void BoardFeatures::recomputeAll()
+{
+	aggregateHeight = 0;
+	holeCount = 0;
+	for (int x = 0; x < MAX_X; x++) {
+		int height = columns[x] == 0 ? 0 : MAX_Y - countTrailingZeros(columns[x]);
+		heights[x] = static_cast<std::int8_t>(height);
+		holes[x] = static_cast<std::int8_t>(height - countBits(columns[x]));
+		aggregateHeight += height;
+		holeCount += holes[x];
+	}
+
+	bumpiness = 0;
+	wellDepth = 0;
+	for (int x = 0; x < MAX_X; x++) {
+		bumpiness += getBumpinessTerm(x);
+		wellDepth += getWellTerm(x);
+	}
+}
+
+// return |height[x] - height[x+1]| (0 off the grid)
+int BoardFeatures::getBumpinessTerm(int x) const
+{
+	if (x < 0 || x + 1 >= MAX_X) {
+		return 0;
+	}
+	return std::abs(heights[x] - heights[x + 1]);
+}
+
+// return the well depth of column x (0 off the grid)
+int BoardFeatures::getWellTerm(int x) const
+{
+	if (x < 0 || x >= MAX_X) {
+		return 0;
+	}
+	int left = (x == 0) ? MAX_Y : heights[x - 1];
+	int right = (x == MAX_X - 1) ? MAX_Y : heights[x + 1];
+	return std::max(0, std::min(left, right) - heights[x]);
+}
+
+// return the # of trailing zero bits (mask must not be 0)
+int BoardFeatures::countTrailingZeros(ColumnMask mask)
+{
+	assert(mask != 0);
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+// return the # of set bits
+int BoardFeatures::countBits(ColumnMask mask)
+{
+#ifdef _MSC_VER
+	return static_cast<int>(__popcnt(mask));
+#else
+	return __builtin_popcount(mask);
+#endif
+}
@@ -0,0 +1,120 @@
+// BoardFeatures tracks the board features bot evaluation functions use (column heights,
+// holes, bumpiness and wells) as the board changes, so reading them is O(1) instead
+// of a scan of every cell.
+//
+// - The board is stored a column at a time: columns[x] has bit y set when the cell
+//   at [x,y] is occupied (y = 0 is the top row, like the Gameboard grid).
+//   A column's height is then the # of rows from its highest block to the bottom
+//   (one count-trailing-zeros), and its holes (empty cells below its highest block)
+//   are its height minus its # of blocks (one popcount).
+// - Changing a cell only changes one column's height & holes, and the bumpiness &
+//   well terms of that column and its 2 neighbours, so the totals are updated by
+//   subtracting the old terms and adding the new ones.
+// - Removing rows removes their bit from every column (the bits above slide down),
+//   then the totals are recomputed from the 10 columns.
+//
+// A Gameboard owns one, and keeps it in sync with its grid. Bots can also copy one
+// and add a candidate placement's blocks to the copy (then remove the completed
+// rows) to evaluate the placement with a handful of word operations.
+
+#ifndef BOARDFEATURES_H
+#define BOARDFEATURES_H
+
+#include <cstdint>
+
+class BoardFeatures
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// TYPES
+	// the occupancy of a single grid column, one bit per row (bit y set = row y occupied)
+	typedef std::uint32_t ColumnMask;
+	// the occupancy of a single grid row (the same as a Gameboard::RowMask)
+	typedef std::uint16_t RowMask;
+
+	// CONSTANTS (the Gameboard checks that these match its own)
+	static const int MAX_X = 10;		// the # of columns
+	static const int MAX_Y = 19;		// the # of rows
+
+	// constructor - an empty board
+	BoardFeatures();
+
+	// set a cell occupied or empty
+	void setCell(int x, int y, bool occupied);
+
+	// set the occupancy of a whole row
+	void setRow(int y, RowMask mask);
+
+	// occupy the cells of masks, where masks[0] is row topRow, masks[1] the row below, etc.
+	//   (eg: a tetromino's mapped row masks). Rows off the grid are disregarded.
+	void addRowMasks(int topRow, const RowMask masks[], int rowCount);
+
+	// remove rows (the rows above each one slide down), rowIndices must be in
+	//   ascending order (top to bottom)
+	void removeRows(const int rowIndices[], int rowCount);
+
+	// remove all completed rows, return the # of rows removed
+	int removeCompletedRows();
+
+	// FEATURES
+
+	// return the height of a column (0 = empty, MAX_Y = full to the top)
+	int getColumnHeight(int x) const;
+	// return the # of holes in a column (empty cells below its highest block)
+	int getColumnHoles(int x) const;
+	// return the occupancy of a column (bit y set = row y occupied)
+	ColumnMask getColumnMask(int x) const;
+	// return the sum of the column heights
+	int getAggregateHeight() const;
+	// return the height of the highest column
+	int getMaxHeight() const;
+	// return the total # of holes
+	int getHoles() const;
+	// return the sum of the height differences of neighbouring columns
+	int getBumpiness() const;
+	// return the sum of the well depths, where a column's well depth is how far it is
+	//   below the lower of its neighbours (the walls count as full height neighbours)
+	int getWellDepth() const;
+	// return the completed rows (bit y set = row y is full)
+	ColumnMask getCompletedRows() const;
+
+	// return how many rows a shape can drop straight down, where bottoms[i] is the row
+	//   of the shape's lowest block in column leftColumn+i (its bottom profile) and the
+	//   shape is in a legal position. O(1) per column: the surface height gives the
+	//   answer when the shape is above the surface, and when it is under an overhang
+	//   the first block below it is found in the column mask.
+	int getDropDistance(int leftColumn, const int bottoms[], int columnCount) const;
+
+private:
+	// recompute a column's height & holes after its mask changed, and update the totals
+	void updateColumn(int x);
+
+	// recompute every column and total (after rows were removed)
+	void recomputeAll();
+
+	// return |height[x] - height[x+1]| (0 off the grid)
+	int getBumpinessTerm(int x) const;
+
+	// return the well depth of column x (0 off the grid)
+	int getWellTerm(int x) const;
+
+	// return the # of trailing zero bits (mask must not be 0)
+	static int countTrailingZeros(ColumnMask mask);
+
+	// return the # of set bits
+	static int countBits(ColumnMask mask);
+
+	// MEMBER VARIABLES
+
+	ColumnMask columns[MAX_X];		// the occupancy of each column
+	std::int8_t heights[MAX_X];		// the height of each column
+	std::int8_t holes[MAX_X];		// the holes in each column
+	int aggregateHeight = 0;
+	int holeCount = 0;
+	int bumpiness = 0;
+	int wellDepth = 0;
+};
+
+#endif /* BOARDFEATURES_H */
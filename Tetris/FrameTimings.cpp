@@ -0,0 +1,130 @@
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include "FrameTimings.h"
+
+// turn recording on or off
+void FrameTimings::setEnabled(bool enable)
+{
+	enabled.store(enable, std::memory_order_relaxed);
+}
+
+bool FrameTimings::isEnabled() const
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+// return the time now
+FrameTimings::Clock::time_point FrameTimings::now()
+{
+	return Clock::now();
+}
+
+// (the phase's thread) record a phase that started at start & ends now
+void FrameTimings::record(Phase phase, Clock::time_point start)
+{
+	if (!isEnabled()) {
+		return;
+	}
+
+	std::chrono::microseconds duration = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+	std::int64_t microseconds = duration.count();
+	histograms[static_cast<int>(phase)].record(static_cast<std::uint32_t>(microseconds < 0 ? 0 : microseconds));
+}
+
+// (the phase's thread) record a phase's duration (clamped to the histogram's range)
+void FrameTimings::record(Phase phase, double seconds)
+{
+	if (!isEnabled()) {
+		return;
+	}
+
+	double microseconds = seconds * 1000000.0;
+	microseconds = (microseconds < 0.0) ? 0.0 : (microseconds > 4294967295.0 ? 4294967295.0 : microseconds);
+	histograms[static_cast<int>(phase)].record(static_cast<std::uint32_t>(microseconds + 0.5));
+}
+
+// return a phase's histogram
+const TimingHistogram& FrameTimings::getHistogram(Phase phase) const
+{
+	return histograms[static_cast<int>(phase)];
+}
+
+// (the simulation thread) set the # of key presses the InputThread has dropped
+void FrameTimings::setDroppedInputCount(std::uint64_t count)
+{
+	droppedInputs.store(count, std::memory_order_relaxed);
+}
+
+std::uint64_t FrameTimings::getDroppedInputCount() const
+{
+	return droppedInputs.load(std::memory_order_relaxed);
+}
+
+// return a line per phase (with any count): "name p50 p99 max", in microseconds
+//   (& a line with the key presses dropped, if any)
+std::string FrameTimings::getOverlayText() const
+{
+	std::ostringstream text;
+	text << std::left << std::setw(14) << "us" << std::setw(8) << "p50" << std::setw(8) << "p99" << "max\n";
+	for (int i = 0; i < static_cast<int>(Phase::COUNT); i++) {
+		const TimingHistogram& histogram = histograms[i];
+		if (histogram.getCount() != 0) {
+			text << std::setw(14) << getName(static_cast<Phase>(i))
+				<< std::setw(8) << histogram.getPercentile(0.5)
+				<< std::setw(8) << histogram.getPercentile(0.99)
+				<< histogram.getMax() << '\n';
+		}
+	}
+	if (getDroppedInputCount() != 0) {
+		text << "dropped keys  " << getDroppedInputCount() << '\n';
+	}
+	return text.str();
+}
+
+// write every phase to a text file: a summary line, then a line per bin that isn't empty
+bool FrameTimings::writeToFile(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file) {
+		return false;
+	}
+
+	file << "# frame timings (microseconds)\n";
+	file << "# phase name count p50 p99 max\n";
+	file << "# bin name lowest highest count\n";
+	file << "# dropped_inputs count\n";
+	for (int i = 0; i < static_cast<int>(Phase::COUNT); i++) {
+		const TimingHistogram& histogram = histograms[i];
+		std::string name = getName(static_cast<Phase>(i));
+		file << "phase " << name << ' ' << histogram.getCount() << ' ' << histogram.getPercentile(0.5)
+			<< ' ' << histogram.getPercentile(0.99) << ' ' << histogram.getMax() << '\n';
+		histogram.writeBins(file, ("bin " + name + ' ').c_str());
+	}
+	file << "dropped_inputs " << getDroppedInputCount() << '\n';
+
+	return static_cast<bool>(file);
+}
+
+// return the name of a phase
+const char* FrameTimings::getName(Phase phase)
+{
+	switch (phase) {
+	case Phase::INPUT:
+		return "input";
+	case Phase::SIMULATION:
+		return "simulation";
+	case Phase::TICK_JITTER:
+		return "tick_jitter";
+	case Phase::DRAW:
+		return "draw";
+	case Phase::PRESENT:
+		return "present";
+	case Phase::FRAME:
+		return "frame";
+	case Phase::INPUT_LATENCY:
+		return "input_latency";
+	default:
+		return "?";
+	}
+}
@@ -0,0 +1,82 @@
+// The FrameTimings measure how long each phase of the game's loops takes, each in a
+// TimingHistogram of its own, so frame pacing & tick jitter can be seen (in an overlay,
+// see getOverlayText()) and kept (in a file, see writeToFile()).
+//
+// The phases are recorded on 2 threads (see SimulationThread):
+// - the simulation thread: INPUT (taking the key presses), SIMULATION (a game loop),
+//   TICK_JITTER (how far the time between 2 game loops is from a simulation step)
+// - the render thread: DRAW (TetrisGame::draw()), PRESENT (window.display()),
+//   FRAME (the time between 2 presents), INPUT_LATENCY (from a key press to the
+//   present of the first frame that shows it)
+// Each phase has a single recording thread, so the histograms need no locks.
+//
+// Recording is off until setEnabled(true): when off, a record() is a relaxed load & a
+// branch. When on, it is a clock read & a few counter updates (see runFrameTimingsBenchmark()).
+
+#ifndef FRAMETIMINGS_H
+#define FRAMETIMINGS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "TimingHistogram.h"
+
+class FrameTimings
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// the phases measured
+	enum class Phase {
+		INPUT, SIMULATION, TICK_JITTER, DRAW, PRESENT, FRAME, INPUT_LATENCY,
+		COUNT	// (the # of phases)
+	};
+
+	typedef std::chrono::steady_clock Clock;
+
+	// MEMBER FUNCTIONS
+
+	// turn recording on or off (off to begin with)
+	void setEnabled(bool enable);
+	bool isEnabled() const;
+
+	// return the time now (to pass to record() at the end of the phase)
+	static Clock::time_point now();
+
+	// (the phase's thread) record a phase that started at start & ends now
+	void record(Phase phase, Clock::time_point start);
+
+	// (the phase's thread) record a phase's duration (eg: a jitter or a latency)
+	void record(Phase phase, double seconds);
+
+	// return a phase's histogram
+	const TimingHistogram& getHistogram(Phase phase) const;
+
+	// (the simulation thread) set the # of key presses the InputThread has dropped
+	//   (see InputThread::getDroppedCount())
+	void setDroppedInputCount(std::uint64_t count);
+	std::uint64_t getDroppedInputCount() const;
+
+	// return a line per phase (with any count): "name p50 p99 max", in microseconds
+	//   (& a line with the key presses dropped, if any)
+	std::string getOverlayText() const;
+
+	// write every phase to a text file: a summary line ("phase name count p50 p99 max"),
+	//   then a line per bin that isn't empty ("bin name lowest highest count"),
+	//   & last, the key presses dropped ("dropped_inputs count"),
+	//   return false if the file can't be written
+	bool writeToFile(const std::string& path) const;
+
+	// return the name of a phase (eg: "draw")
+	static const char* getName(Phase phase);
+
+private:
+	// MEMBER VARIABLES
+	std::atomic<bool> enabled{ false };
+	std::atomic<std::uint64_t> droppedInputs{ 0 };
+	TimingHistogram histograms[static_cast<int>(Phase::COUNT)];
+};
+
+#endif /* FRAMETIMINGS_H */
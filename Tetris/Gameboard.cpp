@@ -2,6 +2,7 @@
 #include "Point.h"
 #include "Gameboard.h"
 #include <cassert>
+#include <cstring>
 #include <iomanip>
 
 Gameboard::Gameboard() {
@@ -23,36 +24,62 @@ int Gameboard::getContent(int x, int y) const {
 	return grid[y][x];
 }
 
-Point Gameboard::getSpawnLoc() {
+Point Gameboard::getSpawnLoc() const {
 	Point pt = spawnLoc;
 	return pt;
 }
 
 void Gameboard::setContent(const Point& pt, int content) {
 	assert(isValidPoint(pt));
-	grid[pt.getY()][pt.getX()] = content;
+	setContent(pt.getX(), pt.getY(), content);
 }
 
 void Gameboard::setContent(int x, int y, int content) {
 	assert(isValidPoint(x, y));
-	grid[y][x] = content;
+	assert(content >= EMPTY_BLOCK && content <= MAX_CONTENT && "a block holds EMPTY_BLOCK to MAX_CONTENT");
+	int oldContent = grid[y][x];
+	grid[y][x] = static_cast<std::int8_t>(content);
+	content = grid[y][x];	// (the hashes are of what the grid holds)
+
+	if (content == EMPTY_BLOCK) {
+		rowMasks[y] &= ~(1 << x);
+	}
+	else {
+		rowMasks[y] |= (1 << x);
+	}
+
+	if (oldContent != content) {
+		version++;
+		std::uint64_t rowOccupancyHash = rowOccupancyHashes[y];
+		if ((oldContent == EMPTY_BLOCK) != (content == EMPTY_BLOCK)) {
+			rowOccupancyHash ^= getOccupancyKey(x);
+			features.setCell(x, y, content != EMPTY_BLOCK);
+		}
+		setRowHashes(y, rowHashes[y] ^ getCellKey(x, oldContent) ^ getCellKey(x, content), rowOccupancyHash);
+	}
 }
 
 void Gameboard::setContent(const std::vector<Point>& locs, int content) {
 	
 	for (const Point& pt : locs) {
 		if (isValidPoint(pt)) {
-			grid[pt.getY()][pt.getX()] = content;
+			setContent(pt.getX(), pt.getY(), content);
 		}
 	}
 
 }
 
-bool Gameboard::areLocsEmpty(std::vector<Point> locs) const {
+bool Gameboard::areLocsEmpty(const std::vector<Point>& locs) const {
+
+	return areLocsEmpty(locs.data(), static_cast<int>(locs.size()));
+}
+
+bool Gameboard::areLocsEmpty(const Point locs[], int locCount) const {
 	
-	for (Point& pt : locs) {
+	for (int i = 0; i < locCount; i++) {
+		const Point& pt = locs[i];
 		if (isValidPoint(pt)) {
-			if (grid[pt.getY()][pt.getX()] != EMPTY_BLOCK) {
+			if (rowMasks[pt.getY()] & (1 << pt.getX())) {
 				return false;
 			}
 		}
@@ -61,21 +88,128 @@ bool Gameboard::areLocsEmpty(std::vector<Point> locs) const {
 	return true;
 }
 
+Gameboard::RowMask Gameboard::getRowMask(int rowIndex) const {
+
+	if (rowIndex < 0 || rowIndex >= MAX_Y) {
+		return 0;
+	}
+
+	return rowMasks[rowIndex];
+}
+
+bool Gameboard::areRowMasksEmpty(int topRowIndex, const RowMask masks[], int rowCount) const {
+
+	for (int i = 0; i < rowCount; i++) {
+		if (masks[i] & getRowMask(topRowIndex + i)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::uint64_t Gameboard::getHash() const {
+
+	return hash;
+}
+
+std::uint64_t Gameboard::getOccupancyHash() const {
+
+	return occupancyHash;
+}
+
+const BoardFeatures& Gameboard::getFeatures() const {
+
+	return features;
+}
+
+std::uint32_t Gameboard::getVersion() const {
+
+	return version;
+}
+
 int Gameboard::removeCompletedRows() {
 
-	int size = getCompletedRowIndices().size();
+	int clearedRowIndices[MAX_Y];
+
+	return removeCompletedRows(clearedRowIndices);
+}
+
+int Gameboard::removeCompletedRows(int clearedRowIndices[MAX_Y]) {
+
+	int clearedCount = 0;
+	int row = MAX_Y - 1;
+
+	// scan from the bottom up. Every surviving row moves down by the number of
+	// completed rows found below it, so each run of surviving rows is moved as one block.
+	while (row >= 0) {
+		if (rowMasks[row] == FULL_ROW_MASK) {
+			clearedRowIndices[clearedCount++] = row;
+			row--;
+			continue;
+		}
+
+		int runBottom = row;
+		while (row >= 0 && rowMasks[row] != FULL_ROW_MASK) {
+			row--;
+		}
+		int runTop = row + 1;
+
+		if (clearedCount > 0) {
+			version++;
+			int runLength = runBottom - runTop + 1;
+			std::memmove(grid[runTop + clearedCount], grid[runTop], runLength * sizeof(grid[0]));
+			std::memmove(&rowMasks[runTop + clearedCount], &rowMasks[runTop], runLength * sizeof(rowMasks[0]));
+			std::memmove(&rowHashes[runTop + clearedCount], &rowHashes[runTop], runLength * sizeof(rowHashes[0]));
+			std::memmove(&rowOccupancyHashes[runTop + clearedCount], &rowOccupancyHashes[runTop], runLength * sizeof(rowOccupancyHashes[0]));
+		}
+	}
+
+	// the indices were found bottom to top, report them top to bottom
+	for (int i = 0; i < clearedCount / 2; i++) {
+		int temp = clearedRowIndices[i];
+		clearedRowIndices[i] = clearedRowIndices[clearedCount - 1 - i];
+		clearedRowIndices[clearedCount - 1 - i] = temp;
+	}
+	features.removeRows(clearedRowIndices, clearedCount);
+
+	// the top rows were vacated by the rows that slid down
+	for (int i = 0; i < clearedCount; i++) {
+		fillRow(i, EMPTY_BLOCK);
+	}
+	// the surviving rows moved, so the board hashes are rebuilt from the row hashes
+	if (clearedCount > 0) {
+		rehashRows();
+	}
+
+	return clearedCount;
+}
+
+bool Gameboard::insertGarbageRows(int rowCount, int holeColumn, int content) {
+
+	assert(rowCount >= 0 && rowCount <= MAX_Y && holeColumn >= 0 && holeColumn < MAX_X);
+
+	bool overflow = false;
+	for (int row = 0; row < rowCount; row++) {
+		overflow = overflow || rowMasks[row] != 0;
+	}
 
-	removeRows(getCompletedRowIndices());
+	// (top down, so every row is copied before it is overwritten)
+	for (int row = 0; row + rowCount < MAX_Y; row++) {
+		copyRowIntoRow(row + rowCount, row);
+	}
+	for (int row = MAX_Y - rowCount; row < MAX_Y; row++) {
+		fillRow(row, content);
+		setContent(holeColumn, row, EMPTY_BLOCK);
+	}
 
-	return size;
+	return overflow;
 }
 
 void Gameboard::empty() {
 
-	for (int col = 0; col < MAX_Y; col++) {
-		for (int row = 0; row < MAX_X; row++) {
-			grid[col][row] = EMPTY_BLOCK;
-		}
+	for (int row = 0; row < MAX_Y; row++) {
+		fillRow(row, EMPTY_BLOCK);
 	}
 }
 
@@ -85,7 +219,7 @@ void Gameboard::printToConsole() const {
 
 	for (int col = 0; col < MAX_Y; col++) {
 		for (int row = 0; row < MAX_X; row++) {
-			std::cout << std::setw(2) << grid[col][row];
+			std::cout << std::setw(2) << static_cast<int>(grid[col][row]);
 		}
 		std::cout << '\n';
 	}
@@ -93,13 +227,7 @@ void Gameboard::printToConsole() const {
 
 bool Gameboard::isRowCompleted(int rowIndex) const {
 
-	for (int col = 0; col < MAX_X; col++) {
-		if (grid[rowIndex][col] == EMPTY_BLOCK) {
-			return false;
-		}
-	}
-
-	return true;
+	return rowMasks[rowIndex] == FULL_ROW_MASK;
 }
 
 std::vector<int> Gameboard::getCompletedRowIndices() const {
@@ -132,16 +260,77 @@ void Gameboard::removeRows(const std::vector<int>& rowIndices) {
 }
 
 void Gameboard::fillRow(int rowIndex, int content) {
+	assert(content >= EMPTY_BLOCK && content <= MAX_CONTENT && "a block holds EMPTY_BLOCK to MAX_CONTENT");
+	version++;
+	std::uint64_t rowHash = 0;
+	std::uint64_t rowOccupancyHash = 0;
+
 	for (int col = 0; col < MAX_X; col++) {
-		grid[rowIndex][col] = content;
+		grid[rowIndex][col] = static_cast<std::int8_t>(content);
+		if (content != EMPTY_BLOCK) {
+			rowHash ^= getCellKey(col, content);
+			rowOccupancyHash ^= getOccupancyKey(col);
+		}
 	}
+	rowMasks[rowIndex] = (content == EMPTY_BLOCK) ? 0 : FULL_ROW_MASK;
+	setRowHashes(rowIndex, rowHash, rowOccupancyHash);
+	features.setRow(rowIndex, rowMasks[rowIndex]);
 }
 
 void Gameboard::copyRowIntoRow(int sourceRowIndex, int targetRowIndex) {
+	version++;
 
 	for (int col = 0; col < MAX_X; col++) {
 		grid[targetRowIndex][col] = grid[sourceRowIndex][col];
 	}
+	rowMasks[targetRowIndex] = rowMasks[sourceRowIndex];
+	setRowHashes(targetRowIndex, rowHashes[sourceRowIndex], rowOccupancyHashes[sourceRowIndex]);
+	features.setRow(targetRowIndex, rowMasks[targetRowIndex]);
+}
+
+void Gameboard::setRowHashes(int rowIndex, std::uint64_t rowHash, std::uint64_t rowOccupancyHash) {
+
+	// (rotation distributes over XOR, so the old row hash can be swapped for the new one in place)
+	hash ^= rotateForRow(rowHashes[rowIndex] ^ rowHash, rowIndex);
+	occupancyHash ^= rotateForRow(rowOccupancyHashes[rowIndex] ^ rowOccupancyHash, rowIndex);
+	rowHashes[rowIndex] = rowHash;
+	rowOccupancyHashes[rowIndex] = rowOccupancyHash;
+}
+
+void Gameboard::rehashRows() {
+
+	hash = 0;
+	occupancyHash = 0;
+	for (int row = 0; row < MAX_Y; row++) {
+		hash ^= rotateForRow(rowHashes[row], row);
+		occupancyHash ^= rotateForRow(rowOccupancyHashes[row], row);
+	}
+}
+
+std::uint64_t Gameboard::getCellKey(int x, int content) {
+
+	if (content == EMPTY_BLOCK) {
+		return 0;
+	}
+
+	std::uint64_t z = (static_cast<std::uint64_t>(x + 1) << 32 | static_cast<std::uint32_t>(content)) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+std::uint64_t Gameboard::getOccupancyKey(int x) {
+
+	// (a content value no color uses, so the occupancy keys differ from the cell keys)
+	return getCellKey(x, EMPTY_BLOCK - 1);
+}
+
+std::uint64_t Gameboard::rotateForRow(std::uint64_t rowHash, int rowIndex) {
+
+	// each row's keys are rotated by a different # of bits (3 per row, 0 to 54 bits)
+	static_assert(MAX_Y * 3 <= 64, "every row needs a different rotation");
+	int bits = rowIndex * 3;
+	return bits == 0 ? rowHash : (rowHash << bits) | (rowHash >> (64 - bits));
 }
 
 bool Gameboard::isValidPoint(const Point& p) const {
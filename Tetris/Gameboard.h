@@ -52,6 +52,9 @@
 #define GAMEBOARD_H
 
 #include <vector>
+#include <array>
+#include <cstdint>
+#include "BoardFeatures.h"
 #include "Point.h"
 
 class Gameboard
@@ -61,19 +64,49 @@ public:
 	// FRIENDS
 	friend class TestSuite;// (allows TestSuite access to private members for testing)
 
+	// TYPES
+	// the occupancy of a single grid row, one bit per column (bit x set = column x occupied)
+	typedef std::uint16_t RowMask;
+
 	// CONSTANTS
 	static const int MAX_X = 10;		// gameboard x dimension
 	static const int MAX_Y = 19;		// gameboard y dimension
 	static const int EMPTY_BLOCK = -1;	// contents of an empty block
+	static const int MAX_CONTENT = 14;	// the largest content of a block (EMPTY_BLOCK to this:
+										//   a replay keyframe packs content + 1 in 4 bits)
+	static const RowMask FULL_ROW_MASK = (1 << MAX_X) - 1;	// the mask of a completed row
+
+	static_assert(BoardFeatures::MAX_X == MAX_X && BoardFeatures::MAX_Y == MAX_Y, "BoardFeatures must match the grid");
 
 private:
 	// MEMBER VARIABLES -------------------------------------------------
 
 	// the gameboard - a grid of X and Y offsets.  
 	//  ([0][0] is top left, [MAX_Y-1][MAX_X-1] is bottom right) 
-	int grid[MAX_Y][MAX_X];
+	//  (a byte per block: the contents are EMPTY_BLOCK or a color, and a small
+	//  board keeps engine snapshots small)
+	std::int8_t grid[MAX_Y][MAX_X];
+	// the occupancy of the grid as one bitmask per row (the "bitboard").
+	//  kept in sync with grid by every function that writes to grid.
+	RowMask rowMasks[MAX_Y];
+	// Zobrist hashing: every (x, content) has a random 64 bit key (see getCellKey()),
+	//  a row's hash is the XOR of the keys of its non-empty cells, and the board's hash
+	//  is the XOR of each row hash rotated by its row index (see rotateForRow()).
+	//  So a cell change is 2 XORs, and moving a row only changes its rotation.
+	//  The occupancy variants use one key per x (whatever the content).
+	//  kept in sync with grid by every function that writes to grid.
+	std::uint64_t rowHashes[MAX_Y] = {};
+	std::uint64_t rowOccupancyHashes[MAX_Y] = {};
+	std::uint64_t hash = 0;
+	std::uint64_t occupancyHash = 0;
+	// the column heights, holes, etc. of the grid's occupancy (see BoardFeatures).
+	//  kept in sync with grid by every function that writes to grid.
+	BoardFeatures features;
+	// the # of changes made to the grid (see getVersion()).
+	//  incremented by every function that writes to grid.
+	std::uint32_t version = 0;
 	// the gameboard offset to spawn a new tetromino at.
-	const Point spawnLoc{ MAX_X / 2, 0 };
+	Point spawnLoc{ MAX_X / 2, 0 };
 
 public:
 	// MEMBER FUNCTIONS
@@ -87,7 +120,7 @@ public:
 	int getContent(int x, int y) const;			
 
 	//return the private spawnloc variable
-	Point getSpawnLoc();
+	Point getSpawnLoc() const;
 
 	// set the content at a given point (only if the point is valid)
 	void setContent(const Point& pt, int content);	
@@ -104,12 +137,52 @@ public:
 	//   Testing invalid points would likely result in an out of bounds
 	//     error or segmentation fault!
 	//   If none of the points are valid, return true
-	bool areLocsEmpty(std::vector<Point> locs) const;
+	bool areLocsEmpty(const std::vector<Point>& locs) const;
+	// (same as above, for a plain array of locCount points)
+	bool areLocsEmpty(const Point locs[], int locCount) const;
+	// (same as above, for a fixed size array of points - eg: a tetromino's mapped block locs)
+	template <std::size_t N>
+	bool areLocsEmpty(const std::array<Point, N>& locs) const { return areLocsEmpty(locs.data(), static_cast<int>(N)); }
+
+	// return the occupancy bitmask of a row (bit x set = column x occupied)
+	//   an invalid rowIndex (off the grid) is reported as an empty row.
+	RowMask getRowMask(int rowIndex) const;
+
+	// return true if none of the bits in masks overlap occupied cells, where
+	//   masks[0] is tested against row topRowIndex, masks[1] against the row below, etc.
+	//   Rows off the grid are disregarded (like invalid points in areLocsEmpty()),
+	//   so the caller is responsible for keeping the masks within the borders.
+	bool areRowMasksEmpty(int topRowIndex, const RowMask masks[], int rowCount) const;
+
+	// return the Zobrist hash of the grid (positions & contents), 0 when the grid is empty.
+	//   Equal grids always have equal hashes (a cheap identity for caches & transposition tables)
+	std::uint64_t getHash() const;
+	// return the Zobrist hash of the grid's occupancy (which cells are filled, ignoring colors)
+	std::uint64_t getOccupancyHash() const;
+
+	// return the features of the grid's occupancy (column heights, holes, bumpiness, wells)
+	const BoardFeatures& getFeatures() const;
+
+	// return the version of the grid: it changes whenever the grid's content changes,
+	//   whatever changed it (eg: to know when a drawing of the board is out of date).
+	//   The version is part of the board, so restoring a copy of a board (eg: an engine
+	//   snapshot) brings its version back too: a version only identifies the content of
+	//   boards with the same history, compare getHash() as well otherwise.
+	std::uint32_t getVersion() const;
 												
 	// removes all completed rows from the board
-	//   use getCompletedRowIndices() and removeRows() 
+	//   (in a single bottom-up pass: each run of surviving rows slides down with
+	//   one block memory move, then the vacated top rows are filled with EMPTY_BLOCK)
 	//   return the # of completed rows removed
-	int removeCompletedRows();			
+	int removeCompletedRows();
+	// (same as above) and record the removed row indices (top to bottom) in
+	//   clearedRowIndices, which must have room for MAX_Y entries.
+	int removeCompletedRows(int clearedRowIndices[MAX_Y]);
+
+	// push every row up by rowCount and fill the vacated bottom rows with content,
+	//   except for a hole at holeColumn (the "garbage" rows of a versus game).
+	//   return true if any blocks were pushed off the top of the grid
+	bool insertGarbageRows(int rowCount, int holeColumn, int content);
 												
 	// fill the board with EMPTY_BLOCK 
 	//   (iterate through each rowIndex and fillRow() with EMPTY_BLOCK))
@@ -159,6 +232,23 @@ private:
 	// copy a source row's contents into a target row.
 	void copyRowIntoRow(int sourceRowIndex, int targetRowIndex);
 
+	// set a row's hashes, keeping the board hashes in sync
+	void setRowHashes(int rowIndex, std::uint64_t rowHash, std::uint64_t rowOccupancyHash);
+
+	// recompute the board hashes from the row hashes (after rows have moved)
+	void rehashRows();
+
+	// return the Zobrist key of content at column x (0 for EMPTY_BLOCK).
+	//   keys are made by mixing x & content (SplitMix64), so every content a block can
+	//   hold (EMPTY_BLOCK to MAX_CONTENT) has a key.
+	static std::uint64_t getCellKey(int x, int content);
+
+	// return the Zobrist key of an occupied cell at column x
+	static std::uint64_t getOccupancyKey(int x);
+
+	// return a row hash as it contributes to the board hash at rowIndex
+	static std::uint64_t rotateForRow(std::uint64_t rowHash, int rowIndex);
+
 
 				
 };
@@ -38,27 +38,65 @@ void GridTetromino::move(int xOffset, int yOffset) {
 	gridLoc.setXY(x + xOffset, y + yOffset);
 }
 
-// build and return a vector of Points to represent our inherited
-// blockLocs vector mapped to the gridLoc of this object instance.
+// build and return the Points that represent our inherited
+// blockLocs mapped to the gridLoc of this object instance.
 // You will need to provide this class access to blockLocs (from the Tetromino class).
-// eg: if we have a Point [x,y] in our vector,
+// eg: if we have a Point [x,y] in our blockLocs,
 // and our gridLoc is [5,6] the mapped Point would be [5+x,6+y].
-std::vector<Point> GridTetromino::getBlockLocsMappedToGrid() const {
+Tetromino::BlockLocs GridTetromino::getBlockLocsMappedToGrid() const {
 
-	std::vector<Point> mappedPts{};
+	const TetrominoTable::Orientation& orientation = getOrientation();
+	BlockLocs mappedPts;
 
-	for (const Point& pt : blockLocs) {
-		int x = pt.getX();
-		int y = pt.getY();
+	int xoff = gridLoc.getX();
+	int yoff = gridLoc.getY();
 
-		int xoff = getGridLoc().getX();
-		int yoff = getGridLoc().getY();
-
-		Point pt2 = Point(x + xoff, y + yoff);
-		mappedPts.push_back(pt2);
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		mappedPts[i].setXY(orientation.blockX[i] + xoff, orientation.blockY[i] + yoff);
 	}
 
 
 	return mappedPts;
 
-}
\ No newline at end of file
+}
+
+// fill masks with the occupancy of each grid row this tetromino covers
+// (shifted so that bit x represents grid column x) and return the number of rows.
+int GridTetromino::getRowMasksMappedToGrid(Gameboard::RowMask masks[BLOCK_COUNT]) const {
+
+	const TetrominoTable::Orientation& orientation = getOrientation();
+	int rowCount = orientation.maxY - orientation.minY + 1;
+	int shift = gridLoc.getX() + orientation.minX;
+
+	for (int i = 0; i < rowCount; i++) {
+		masks[i] = static_cast<Gameboard::RowMask>(orientation.rowMasks[i] << shift);
+	}
+
+	return rowCount;
+}
+
+// return the grid row of this tetromino's topmost block
+int GridTetromino::getMappedTopRow() const {
+
+	return gridLoc.getY() + getOrientation().minY;
+}
+
+// fill bottoms with the grid row of this tetromino's lowest block in each grid column
+// it covers and return the number of columns.
+int GridTetromino::getColumnBottomsMappedToGrid(int bottoms[BLOCK_COUNT]) const {
+
+	const TetrominoTable::Orientation& orientation = getOrientation();
+	int columnCount = orientation.maxX - orientation.minX + 1;
+
+	for (int i = 0; i < columnCount; i++) {
+		bottoms[i] = gridLoc.getY() + orientation.columnBottoms[i];
+	}
+
+	return columnCount;
+}
+
+// return the grid column of this tetromino's leftmost block
+int GridTetromino::getMappedLeftColumn() const {
+
+	return gridLoc.getX() + getOrientation().minX;
+}
@@ -10,6 +10,7 @@
 #define GRIDTETROMINO_H
 
 #include "Tetromino.h"
+#include "Gameboard.h"
 
 class GridTetromino : public Tetromino
 {	
@@ -35,12 +36,30 @@ public:
 	//	(0,1) represents a move down (y+1)
 	void move(int xOffset, int yOffset);	
 
-	// build and return a vector of Points to represent our inherited
-	// blockLocs vector mapped to the gridLoc of this object instance.
+	// build and return the Points that represent our inherited
+	// blockLocs mapped to the gridLoc of this object instance.
 	// You will need to provide this class access to blockLocs (from the Tetromino class).
-	// eg: if we have a Point [x,y] in our vector,
+	// eg: if we have a Point [x,y] in our blockLocs,
 	// and our gridLoc is [5,6] the mapped Point would be [5+x,6+y].
-	std::vector<Point> getBlockLocsMappedToGrid() const;
+	// The Points are returned by value in fixed (inline) storage, so no heap allocation occurs.
+	BlockLocs getBlockLocsMappedToGrid() const;
+
+	// fill masks with the occupancy of each grid row this tetromino covers
+	// (shifted so that bit x represents grid column x) and return the number of rows.
+	// masks[0] is the row at getMappedTopRow(), masks[1] the row below it, etc.
+	// The tetromino must be within the left & right borders of the grid.
+	int getRowMasksMappedToGrid(Gameboard::RowMask masks[BLOCK_COUNT]) const;
+
+	// return the grid row of this tetromino's topmost block
+	int getMappedTopRow() const;
+
+	// fill bottoms with the grid row of this tetromino's lowest block in each grid column
+	// it covers and return the number of columns.
+	// bottoms[0] is the column at getMappedLeftColumn(), bottoms[1] the column to its right, etc.
+	int getColumnBottomsMappedToGrid(int bottoms[BLOCK_COUNT]) const;
+
+	// return the grid column of this tetromino's leftmost block
+	int getMappedLeftColumn() const;
 
 };
 
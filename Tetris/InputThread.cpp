@@ -0,0 +1,81 @@
+#include <SFML/System/Sleep.hpp>
+#include "InputThread.h"
+
+constexpr double InputThread::REPEAT_DELAY_SECONDS;
+constexpr double InputThread::REPEAT_INTERVAL_SECONDS;
+
+// constructor - start watching the keyboard
+InputThread::InputThread(const sf::Clock& gameClock)
+	: clock(gameClock), thread(&InputThread::run, this)
+{
+}
+
+// destructor - stop the thread
+InputThread::~InputThread()
+{
+	running = false;
+	thread.join();
+}
+
+// tell the thread whether the window has focus
+void InputThread::setFocused(bool hasFocus)
+{
+	focused = hasFocus;
+}
+
+// take the next key press (the oldest first)
+bool InputThread::pop(KeyPress& press)
+{
+	return queue.pop(press);
+}
+
+std::uint64_t InputThread::getDroppedCount() const
+{
+	return dropped;
+}
+
+// return the time on a clock in seconds (with microsecond resolution)
+double InputThread::getSeconds(const sf::Clock& clock)
+{
+	return clock.getElapsedTime().asMicroseconds() / 1000000.0;
+}
+
+// the body of the thread: poll the keys until the destructor stops it
+void InputThread::run()
+{
+	// the keys the game uses (see TetrisGame::onKeyPressed()), & whether they repeat
+	const sf::Keyboard::Key KEYS[] = {
+		sf::Keyboard::Up, sf::Keyboard::Down, sf::Keyboard::Left,
+		sf::Keyboard::Right, sf::Keyboard::Space, sf::Keyboard::A, sf::Keyboard::T
+	};
+	const bool REPEATS[] = { false, true, true, true, false, false, false };
+	const int KEY_COUNT = sizeof(KEYS) / sizeof(KEYS[0]);
+
+	bool wasDown[KEY_COUNT] = {};
+	double nextRepeat[KEY_COUNT] = {};
+
+	while (running) {
+		bool hasFocus = focused;
+		double now = getSeconds(clock);
+
+		for (int k = 0; k < KEY_COUNT; k++) {
+			bool down = hasFocus && sf::Keyboard::isKeyPressed(KEYS[k]);
+			bool pressed = false;
+			if (down && !wasDown[k]) {
+				pressed = true;
+				nextRepeat[k] = now + REPEAT_DELAY_SECONDS;
+			}
+			else if (down && REPEATS[k] && now >= nextRepeat[k]) {
+				pressed = true;
+				nextRepeat[k] += REPEAT_INTERVAL_SECONDS;
+			}
+			wasDown[k] = down;
+
+			if (pressed && !queue.push(KeyPress{ KEYS[k], now })) {
+				dropped++;
+			}
+		}
+
+		sf::sleep(sf::microseconds(POLL_MICROSECONDS));
+	}
+}
@@ -0,0 +1,79 @@
+// The InputThread watches the keyboard on a thread of its own (about 1000 times a
+// second) and queues every key press with the time it happened, on the game clock.
+// The game loop takes the presses whenever it runs (see TetrisGame::onKeyPressed()),
+// and the game applies each one at its time rather than at the frame it was seen in,
+// so the frame rate adds no input latency to the simulation.
+//
+// - The keyboard is read with sf::Keyboard::isKeyPressed(): window events can only
+//   be read on the window's thread. So the game loop tells the thread whether the
+//   window has focus (see setFocused()); keys pressed in other windows are ignored.
+// - A held move key (left, right, down) repeats like the keyboard's own auto-repeat:
+//   after REPEAT_DELAY_SECONDS, then every REPEAT_INTERVAL_SECONDS.
+// - The presses are passed through an SpscQueue: the thread never waits for the game
+//   loop, and the game loop never waits for the thread.
+// - sf::sleep() paces the polling (on Windows it raises the timer resolution, so a
+//   1 ms sleep is about 1 ms, not a 15 ms scheduler quantum).
+
+#ifndef INPUTTHREAD_H
+#define INPUTTHREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <SFML/System/Clock.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include "SpscQueue.h"
+
+class InputThread
+{
+public:
+	// a key press, at a time on the game clock (seconds)
+	struct KeyPress {
+		sf::Keyboard::Key key;
+		double time;
+	};
+
+	// CONSTANTS
+	static const int POLL_MICROSECONDS = 1000;				// the time between 2 looks at the keyboard
+	static const int QUEUE_CAPACITY = 256;					// the key presses waiting for the game loop
+	static constexpr double REPEAT_DELAY_SECONDS = 0.25;	// a held key repeats after this long,
+	static constexpr double REPEAT_INTERVAL_SECONDS = 0.05;	// then this often
+
+	// MEMBER FUNCTIONS
+
+	// constructor - start watching the keyboard
+	//   gameClock: the clock the key presses are timed with (it must outlive the thread)
+	explicit InputThread(const sf::Clock& gameClock);
+
+	// destructor - stop the thread
+	~InputThread();
+
+	InputThread(const InputThread&) = delete;
+	InputThread& operator=(const InputThread&) = delete;
+
+	// tell the thread whether the window has focus (the keys are ignored while it hasn't)
+	void setFocused(bool hasFocus);
+
+	// take the next key press (the oldest first), return false if there is none
+	bool pop(KeyPress& press);
+
+	// return the # of key presses lost because the game loop didn't take them in time
+	std::uint64_t getDroppedCount() const;
+
+	// return the time on a clock in seconds (with microsecond resolution)
+	static double getSeconds(const sf::Clock& clock);
+
+private:
+	// the body of the thread: poll the keys until the destructor stops it
+	void run();
+
+	// MEMBER VARIABLES
+	const sf::Clock& clock;
+	SpscQueue<KeyPress> queue{ QUEUE_CAPACITY };
+	std::atomic<bool> running{ true };
+	std::atomic<bool> focused{ true };
+	std::atomic<std::uint64_t> dropped{ 0 };
+	std::thread thread;					// (last: it starts once the members above are ready)
+};
+
+#endif /* INPUTTHREAD_H */
@@ -0,0 +1,77 @@
+#include "LatencySimulator.h"
+#include "ParallelGameRunner.h"
+
+// constructors
+LatencySimulator::LatencySimulator()
+{
+}
+
+LatencySimulator::LatencySimulator(const Settings& settings)
+	: settings(settings)
+{
+}
+
+// change the conditions (for the packets sent from now on)
+void LatencySimulator::setSettings(const Settings& newSettings)
+{
+	settings = newSettings;
+	randomCount = 0;
+}
+
+const LatencySimulator::Settings& LatencySimulator::getSettings() const
+{
+	return settings;
+}
+
+// send a packet at time now
+void LatencySimulator::send(const std::uint8_t* data, std::size_t size, double now)
+{
+	sent++;
+	if (nextRandom() < settings.lossRate) {
+		lost++;
+		return;
+	}
+
+	Packet packet;
+	packet.arrival = now + settings.latencySeconds + settings.jitterSeconds * nextRandom();
+	packet.sequence = sent;
+	packet.bytes.assign(data, data + size);
+	inFlight.push(std::move(packet));
+}
+
+// take the next packet that has arrived by time now
+bool LatencySimulator::receive(std::vector<std::uint8_t>& packet, double now)
+{
+	if (inFlight.empty() || inFlight.top().arrival > now) {
+		return false;
+	}
+
+	packet = inFlight.top().bytes;
+	inFlight.pop();
+	return true;
+}
+
+std::size_t LatencySimulator::getPendingCount() const
+{
+	return inFlight.size();
+}
+
+std::uint64_t LatencySimulator::getLostCount() const
+{
+	return lost;
+}
+
+// orders the queue by arrival (the earliest on top)
+bool LatencySimulator::LaterArrival::operator()(const Packet& a, const Packet& b) const
+{
+	if (a.arrival != b.arrival) {
+		return a.arrival > b.arrival;
+	}
+	return a.sequence > b.sequence;
+}
+
+// return a pseudo-random number in [0, 1)
+double LatencySimulator::nextRandom()
+{
+	return (ParallelGameRunner::getGameSeed(settings.seed, randomCount++) >> 11) * (1.0 / 9007199254740992.0);
+}
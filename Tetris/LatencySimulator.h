@@ -0,0 +1,79 @@
+// The LatencySimulator stands between a sender and a receiver of packets (eg: the
+// two players of a versus game, see VersusConnection) and delivers each packet late:
+// after a base latency plus a random jitter, and maybe not at all (packet loss).
+// Jitter means packets can arrive in a different order than they were sent, like on
+// a real network.
+//
+// It has no clock of its own: the time is passed in (in seconds, from any origin),
+// so tests can run it on a virtual clock, and its randomness comes from a seed,
+// so a simulated connection is deterministic.
+
+#ifndef LATENCYSIMULATOR_H
+#define LATENCYSIMULATOR_H
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+class LatencySimulator
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// the conditions to simulate
+	struct Settings {
+		double latencySeconds = 0.0;	// the one-way delay of every packet
+		double jitterSeconds = 0.0;		// up to this much more delay (uniformly random, per packet)
+		double lossRate = 0.0;			// the fraction of packets that are dropped (0 to 1)
+		std::uint64_t seed = 0;			// seeds the jitter & the loss
+	};
+
+	// MEMBER FUNCTIONS
+
+	// constructors (the default delivers every packet at once)
+	LatencySimulator();
+	explicit LatencySimulator(const Settings& settings);
+
+	// change the conditions (for the packets sent from now on)
+	void setSettings(const Settings& settings);
+	const Settings& getSettings() const;
+
+	// send a packet at time now: it is delivered by receive() once its delay has passed
+	//   (unless it is lost)
+	void send(const std::uint8_t* data, std::size_t size, double now);
+
+	// take the next packet that has arrived by time now (the earliest first),
+	//   return false if none has
+	bool receive(std::vector<std::uint8_t>& packet, double now);
+
+	// return the # of packets sent but not yet received (not counting lost ones)
+	std::size_t getPendingCount() const;
+	// return the # of packets lost so far
+	std::uint64_t getLostCount() const;
+
+private:
+	// a packet on its way
+	struct Packet {
+		double arrival;					// the time it can be received
+		std::uint64_t sequence;			// (orders packets that arrive at the same time)
+		std::vector<std::uint8_t> bytes;
+	};
+
+	// orders the queue by arrival (the earliest on top)
+	struct LaterArrival {
+		bool operator()(const Packet& a, const Packet& b) const;
+	};
+
+	// return a pseudo-random number in [0, 1)
+	double nextRandom();
+
+	// MEMBER VARIABLES
+	Settings settings;
+	std::priority_queue<Packet, std::vector<Packet>, LaterArrival> inFlight;
+	std::uint64_t randomCount = 0;	// the # of random numbers drawn (for the jitter & loss)
+	std::uint64_t sent = 0;			// the # of packets sent
+	std::uint64_t lost = 0;			// the # of packets lost
+};
+
+#endif /* LATENCYSIMULATOR_H */
@@ -0,0 +1,118 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// destructor - unmap the file (if any)
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+// map a file (unmapping the current one, if any), return false if it can't
+//   be opened or mapped
+bool MappedFile::open(const std::string& path, Access accessHint)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		accessHint == Access::SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize)) {
+		CloseHandle(fileHandle);
+		return false;
+	}
+	file = fileHandle;
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+	opened = true;
+
+	// (an empty file can't be mapped: it is open, without data)
+	if (size > 0) {
+		mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (view == nullptr) {
+			close();
+			return false;
+		}
+		data = static_cast<const std::uint8_t*>(view);
+	}
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0) {
+		::close(fd);
+		return false;
+	}
+	size = static_cast<std::size_t>(status.st_size);
+	opened = true;
+
+	// (an empty file can't be mapped: it is open, without data)
+	if (size > 0) {
+		void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (view == MAP_FAILED) {
+			::close(fd);
+			close();
+			return false;
+		}
+		madvise(view, size, accessHint == Access::SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM);
+		data = static_cast<const std::uint8_t*>(view);
+	}
+	::close(fd);	// (the mapping keeps the file open)
+#endif
+	return true;
+}
+
+// unmap the file
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+	if (mapping != nullptr) {
+		CloseHandle(mapping);
+	}
+	if (file != nullptr) {
+		CloseHandle(file);
+	}
+	mapping = nullptr;
+	file = nullptr;
+#else
+	if (data != nullptr) {
+		munmap(const_cast<std::uint8_t*>(data), size);
+	}
+#endif
+	data = nullptr;
+	size = 0;
+	opened = false;
+}
+
+bool MappedFile::isOpen() const
+{
+	return opened;
+}
+
+const std::uint8_t* MappedFile::getData() const
+{
+	return data;
+}
+
+std::size_t MappedFile::getSize() const
+{
+	return size;
+}
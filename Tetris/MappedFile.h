@@ -0,0 +1,54 @@
+// A MappedFile maps a whole file into memory, read only (mmap on POSIX systems,
+// a file mapping on Windows), so a large file can be read in place: the operating
+// system pages it in as it is touched, nothing is copied into buffers, and many
+// threads can read it at once.
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class MappedFile
+{
+public:
+	// how the file will be read (a hint for the system's read ahead)
+	enum class Access { SEQUENTIAL, RANDOM };
+
+	MappedFile() = default;
+	// destructor - unmap the file (if any)
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// map a file (unmapping the current one, if any), return false if it can't
+	//   be opened or mapped
+	bool open(const std::string& path, Access accessHint = Access::SEQUENTIAL);
+
+	// unmap the file
+	void close();
+
+	// return true while a file is mapped
+	bool isOpen() const;
+
+	// return the file's bytes (nullptr if nothing is mapped or the file is empty)
+	const std::uint8_t* getData() const;
+
+	// return the size of the file
+	std::size_t getSize() const;
+
+private:
+	// MEMBER VARIABLES
+
+	const std::uint8_t* data = nullptr;
+	std::size_t size = 0;
+	bool opened = false;
+#ifdef _WIN32
+	void* file = nullptr;		// (the file & mapping HANDLEs)
+	void* mapping = nullptr;
+#endif
+};
+
+#endif /* MAPPEDFILE_H */
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include "ParallelGameRunner.h"
+
+double ParallelGameRunner::Results::getMeanScore() const
+{
+	return gamesPlayed == 0 ? 0.0 : static_cast<double>(totalScore) / gamesPlayed;
+}
+
+// play settings.gameCount games using policies made by makePolicy, and return the results
+ParallelGameRunner::Results ParallelGameRunner::run(const Settings& settings, const PolicyFactory& makePolicy)
+{
+	assert(settings.gameCount <= 0xFFFFFFFFULL && "game indices must fit in 32 bits");
+	assert(settings.scores == nullptr || settings.scores->size() >= settings.gameCount);
+
+	int threadCount = settings.threadCount;
+	if (threadCount <= 0) {
+		threadCount = static_cast<int>(std::thread::hardware_concurrency());
+		if (threadCount <= 0) {
+			threadCount = 1;
+		}
+	}
+
+	// give every worker an even share of the games to start with
+	std::vector<WorkRange> work(threadCount);
+	for (int w = 0; w < threadCount; w++) {
+		std::uint64_t begin = settings.gameCount * w / threadCount;
+		std::uint64_t end = settings.gameCount * (w + 1) / threadCount;
+		work[w].range.store(pack(static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end)));
+	}
+
+	std::vector<WorkerResults> workerResults(threadCount);
+	auto start = std::chrono::steady_clock::now();
+
+	// worker 0 runs on this thread
+	std::vector<std::thread> threads;
+	for (int w = 1; w < threadCount; w++) {
+		threads.emplace_back(workerLoop, w, std::cref(settings), std::cref(makePolicy), std::ref(work), std::ref(workerResults[w]));
+	}
+	workerLoop(0, settings, makePolicy, work, workerResults[0]);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	// merge the per-worker results
+	Results results;
+	bool anyGames = false;
+	for (const WorkerResults& worker : workerResults) {
+		const Results& r = worker.results;
+		results.gamesPlayed += r.gamesPlayed;
+		results.gamesOver += r.gamesOver;
+		results.totalScore += r.totalScore;
+		results.totalShapes += r.totalShapes;
+		results.steals += r.steals;
+		if (worker.anyGames) {
+			results.minScore = anyGames ? std::min(results.minScore, r.minScore) : r.minScore;
+			results.maxScore = anyGames ? std::max(results.maxScore, r.maxScore) : r.maxScore;
+			anyGames = true;
+		}
+	}
+	results.threadCount = threadCount;
+	results.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	return results;
+}
+
+// return the seed of game gameIndex (a SplitMix64 mix of baseSeed and the index)
+std::uint64_t ParallelGameRunner::getGameSeed(std::uint64_t baseSeed, std::uint64_t gameIndex)
+{
+	std::uint64_t z = baseSeed + (gameIndex + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// return a factory of policies that pick pseudo-random actions
+ParallelGameRunner::PolicyFactory ParallelGameRunner::makeRandomPolicyFactory(std::uint64_t seed)
+{
+	return [seed]() -> Policy {
+		std::uint64_t gameSeed = 0;
+		std::uint64_t state = 0;
+
+		return [seed, gameSeed, state](const TetrisEngine& engine) mutable -> TetrisEngine::Action {
+			// restart the sequence for every game, so the actions only depend on the game
+			if (engine.getRandomizer().getSeed() != gameSeed || state == 0) {
+				gameSeed = engine.getRandomizer().getSeed();
+				state = getGameSeed(seed, gameSeed) | 1;
+			}
+
+			const TetrisEngine::Action choices[] = {
+				TetrisEngine::Action::NONE, TetrisEngine::Action::LEFT,
+				TetrisEngine::Action::RIGHT, TetrisEngine::Action::ROTATE,
+				TetrisEngine::Action::LEFT, TetrisEngine::Action::RIGHT,
+				TetrisEngine::Action::DOWN, TetrisEngine::Action::DROP
+			};
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			return choices[state >> 61];
+		};
+	};
+}
+
+std::uint64_t ParallelGameRunner::pack(std::uint32_t begin, std::uint32_t end)
+{
+	return static_cast<std::uint64_t>(begin) | (static_cast<std::uint64_t>(end) << 32);
+}
+
+// take the game at the front of a range, return false if the range is empty
+bool ParallelGameRunner::popFront(WorkRange& work, std::uint32_t& gameIndex)
+{
+	std::uint64_t range = work.range.load(std::memory_order_acquire);
+
+	for (;;) {
+		std::uint32_t begin = static_cast<std::uint32_t>(range);
+		std::uint32_t end = static_cast<std::uint32_t>(range >> 32);
+		if (begin >= end) {
+			return false;
+		}
+		if (work.range.compare_exchange_weak(range, pack(begin + 1, end), std::memory_order_acq_rel)) {
+			gameIndex = begin;
+			return true;
+		}
+	}
+}
+
+// steal the back half of victim's range into thief's (empty) range
+bool ParallelGameRunner::stealHalf(WorkRange& victim, WorkRange& thief)
+{
+	std::uint64_t range = victim.range.load(std::memory_order_acquire);
+
+	for (;;) {
+		std::uint32_t begin = static_cast<std::uint32_t>(range);
+		std::uint32_t end = static_cast<std::uint32_t>(range >> 32);
+		if (begin >= end) {
+			return false;
+		}
+		std::uint32_t middle = begin + (end - begin) / 2;
+		if (victim.range.compare_exchange_weak(range, pack(begin, middle), std::memory_order_acq_rel)) {
+			// the thief's range is empty, so nobody else can be changing it
+			thief.range.store(pack(middle, end), std::memory_order_release);
+			return true;
+		}
+	}
+}
+
+// the body of each worker thread
+void ParallelGameRunner::workerLoop(int workerIndex, const Settings& settings, const PolicyFactory& makePolicy,
+	std::vector<WorkRange>& work, WorkerResults& out)
+{
+	// per-thread state: nothing here is touched by any other thread
+	TetrisEngine engine(0, settings.randomizerMode);
+	Policy policy = makePolicy();
+	int workerCount = static_cast<int>(work.size());
+
+	for (;;) {
+		std::uint32_t gameIndex;
+		if (popFront(work[workerIndex], gameIndex)) {
+			playGame(gameIndex, settings, engine, policy, out);
+			continue;
+		}
+
+		// out of work: try to steal from the other workers (starting with the next one)
+		bool stole = false;
+		for (int i = 1; i < workerCount && !stole; i++) {
+			stole = stealHalf(work[(workerIndex + i) % workerCount], work[workerIndex]);
+		}
+		if (!stole) {
+			return;	// every range is empty, and no new games are ever added
+		}
+		out.results.steals++;
+	}
+}
+
+// play one game to completion, add it to results
+void ParallelGameRunner::playGame(std::uint64_t gameIndex, const Settings& settings, TetrisEngine& engine,
+	Policy& policy, WorkerResults& out)
+{
+	engine.reset(getGameSeed(settings.baseSeed, gameIndex));
+
+	while (!engine.isGameOver() && engine.getShapesPlaced() < settings.maxShapesPerGame) {
+		engine.step(policy(engine), settings.secondsPerStep);
+	}
+
+	Results& r = out.results;
+	int score = engine.getScore();
+	r.gamesPlayed++;
+	r.gamesOver += engine.isGameOver() ? 1 : 0;
+	r.totalScore += score;
+	r.totalShapes += engine.getShapesPlaced();
+	r.minScore = out.anyGames ? std::min(r.minScore, score) : score;
+	r.maxScore = out.anyGames ? std::max(r.maxScore, score) : score;
+	out.anyGames = true;
+
+	if (settings.scores != nullptr) {
+		(*settings.scores)[gameIndex] = score;
+	}
+}
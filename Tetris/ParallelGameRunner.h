@@ -0,0 +1,111 @@
+// The ParallelGameRunner plays a large number of independent headless games
+// (TetrisEngine) across all the cores of a machine, eg: to evaluate a bot's
+// heuristics over millions of games in a single process.
+//
+// - Work distribution: every worker thread starts with an even share of the game
+//   indices (a [begin,end) range). A worker takes games from the front of its own
+//   range, and when it runs dry it steals half of what is left in another worker's
+//   range (from the back). Both operations are a single compare-and-swap on the
+//   packed range, so there are no locks and no shared work queue.
+// - Isolation: each worker owns its engine, its policy instance (created by the
+//   PolicyFactory on that thread) and its result accumulators. Nothing is shared
+//   while games run; the per-worker results are merged after the threads join.
+// - Determinism: game i is always seeded with getGameSeed(baseSeed, i), so a game's
+//   result does not depend on which thread played it (or how many threads there are).
+
+#ifndef PARALLELGAMERUNNER_H
+#define PARALLELGAMERUNNER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "TetrisEngine.h"
+
+class ParallelGameRunner
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// a policy picks the action for each step of a game
+	typedef std::function<TetrisEngine::Action(const TetrisEngine&)> Policy;
+	// creates one policy per worker thread (so a policy may keep state without locking)
+	typedef std::function<Policy()> PolicyFactory;
+
+	// what to run
+	struct Settings {
+		std::uint64_t gameCount = 1000;		// the # of games to play
+		std::uint64_t baseSeed = 0;			// game i is seeded with getGameSeed(baseSeed, i)
+		int threadCount = 0;				// the # of worker threads (0 = one per hardware thread)
+		int maxShapesPerGame = 1000;		// a game that reaches this many shapes is stopped
+		double secondsPerStep = 0.05;		// the virtual time that passes every step
+		PieceRandomizer::Mode randomizerMode = PieceRandomizer::Mode::RANDOM;
+		std::vector<int>* scores = nullptr;	// optional: receives the score of game i at [i]
+	};
+
+	// the aggregated results of a run
+	struct Results {
+		std::uint64_t gamesPlayed = 0;		// the # of games played
+		std::uint64_t gamesOver = 0;		// the # of games that ended (the others hit maxShapesPerGame)
+		std::uint64_t totalScore = 0;		// the sum of all scores
+		std::uint64_t totalShapes = 0;		// the sum of all shapes placed
+		std::uint64_t steals = 0;			// the # of successful steals between workers
+		int minScore = 0;					// the lowest score of any game
+		int maxScore = 0;					// the highest score of any game
+		int threadCount = 0;				// the # of worker threads used
+		double seconds = 0.0;				// wall clock time of the run
+
+		// return the mean score per game
+		double getMeanScore() const;
+	};
+
+	// play settings.gameCount games using policies made by makePolicy, and return the results
+	static Results run(const Settings& settings, const PolicyFactory& makePolicy);
+
+	// return the seed of game gameIndex (a SplitMix64 mix of baseSeed and the index)
+	static std::uint64_t getGameSeed(std::uint64_t baseSeed, std::uint64_t gameIndex);
+
+	// return a factory of policies that pick pseudo-random actions (mostly moves
+	// & rotations, sometimes a drop). the actions of a game only depend on seed and
+	// the game's seed, so results stay deterministic.
+	static PolicyFactory makeRandomPolicyFactory(std::uint64_t seed);
+
+private:
+	// CONSTANTS
+	static const int CACHE_LINE_SIZE = 64;
+
+	// a worker's share of the game indices: [begin, end) packed into one 64 bit word
+	// (begin in the low 32 bits) so it can be updated with a single compare-and-swap.
+	// padded to its own cache line so workers don't slow each other down.
+	struct WorkRange {
+		std::atomic<std::uint64_t> range{ 0 };
+		char padding[CACHE_LINE_SIZE - sizeof(std::atomic<std::uint64_t>)];
+	};
+
+	// a worker's private results (merged after the run), padded like WorkRange
+	struct WorkerResults {
+		char padding[CACHE_LINE_SIZE];
+		Results results;
+		bool anyGames = false;
+	};
+
+	static std::uint64_t pack(std::uint32_t begin, std::uint32_t end);
+
+	// take the game at the front of a range, return false if the range is empty
+	static bool popFront(WorkRange& work, std::uint32_t& gameIndex);
+
+	// steal the back half of victim's range into thief's (empty) range,
+	// return false if there was nothing to steal
+	static bool stealHalf(WorkRange& victim, WorkRange& thief);
+
+	// the body of each worker thread
+	static void workerLoop(int workerIndex, const Settings& settings, const PolicyFactory& makePolicy,
+		std::vector<WorkRange>& work, WorkerResults& out);
+
+	// play one game to completion, add it to results
+	static void playGame(std::uint64_t gameIndex, const Settings& settings, TetrisEngine& engine,
+		Policy& policy, WorkerResults& out);
+};
+
+#endif /* PARALLELGAMERUNNER_H */
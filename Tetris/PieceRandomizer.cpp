@@ -0,0 +1,122 @@
+#include "PieceRandomizer.h"
+
+// constructor - start a sequence from seed
+PieceRandomizer::PieceRandomizer(std::uint64_t seed, Mode mode)
+{
+	state.mode = mode;
+	this->seed(seed);
+}
+
+// restart the sequence from a seed (keeps the mode)
+void PieceRandomizer::seed(std::uint64_t seed)
+{
+	state.seed = seed;
+	state.counter = 0;
+	state.bagIndex = BAG_SIZE;
+	for (int i = 0; i < BAG_SIZE; i++) {
+		state.bag[i] = static_cast<std::uint8_t>(i);
+	}
+}
+
+std::uint64_t PieceRandomizer::getSeed() const
+{
+	return state.seed;
+}
+
+// change the mode, restarting the sequence from the current seed
+void PieceRandomizer::setMode(Mode mode)
+{
+	state.mode = mode;
+	seed(state.seed);
+}
+
+PieceRandomizer::Mode PieceRandomizer::getMode() const
+{
+	return state.mode;
+}
+
+// return the next shape in the sequence
+Tetromino::TetShape PieceRandomizer::nextShape()
+{
+	if (state.mode == Mode::RANDOM) {
+		return static_cast<Tetromino::TetShape>(nextBelow(BAG_SIZE));
+	}
+
+	if (state.bagIndex >= BAG_SIZE) {
+		refillBag();
+	}
+	return static_cast<Tetromino::TetShape>(state.bag[state.bagIndex++]);
+}
+
+// skip over the next shapeCount shapes, as if nextShape() was called shapeCount times
+void PieceRandomizer::skip(std::uint64_t shapeCount)
+{
+	if (state.mode == Mode::RANDOM) {
+		// one random number per shape
+		state.counter += shapeCount;
+		return;
+	}
+
+	// finish the current bag
+	while (shapeCount > 0 && state.bagIndex < BAG_SIZE) {
+		state.bagIndex++;
+		shapeCount--;
+	}
+
+	// skip whole bags (each bag shuffle uses BAG_SIZE-1 random numbers)
+	std::uint64_t wholeBags = shapeCount / BAG_SIZE;
+	state.counter += wholeBags * (BAG_SIZE - 1);
+	shapeCount -= wholeBags * BAG_SIZE;
+
+	// deal the remainder from a new bag
+	if (shapeCount > 0) {
+		refillBag();
+		state.bagIndex = static_cast<std::uint8_t>(shapeCount);
+	}
+}
+
+PieceRandomizer::State PieceRandomizer::getState() const
+{
+	return state;
+}
+
+void PieceRandomizer::setState(const State& state)
+{
+	this->state = state;
+}
+
+// return the next random number (and advance the counter)
+//   SplitMix64 finalizer applied to seed + counter * golden ratio
+std::uint64_t PieceRandomizer::nextRandom()
+{
+	std::uint64_t z = state.seed + (++state.counter) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// return a random number in the range [0, bound)
+//   (maps the top 32 bits onto the range with a multiply, which always uses
+//   exactly one random number - this keeps skip() simple)
+int PieceRandomizer::nextBelow(int bound)
+{
+	std::uint64_t r = nextRandom() >> 32;
+	return static_cast<int>((r * static_cast<std::uint64_t>(bound)) >> 32);
+}
+
+// shuffle all the shapes into a new bag (Fisher-Yates, uses BAG_SIZE-1 random numbers)
+void PieceRandomizer::refillBag()
+{
+	for (int i = 0; i < BAG_SIZE; i++) {
+		state.bag[i] = static_cast<std::uint8_t>(i);
+	}
+
+	for (int i = BAG_SIZE - 1; i > 0; i--) {
+		int j = nextBelow(i + 1);
+		std::uint8_t temp = state.bag[i];
+		state.bag[i] = state.bag[j];
+		state.bag[j] = temp;
+	}
+
+	state.bagIndex = 0;
+}
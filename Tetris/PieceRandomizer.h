@@ -0,0 +1,87 @@
+// The PieceRandomizer picks the sequence of tetromino shapes for a single game.
+// Each game owns its own randomizer (there is no hidden global state like rand()),
+// so games are reproducible from their seed and can run on many threads at once.
+//
+// The generator is counter based: the n-th random number is a pure function of
+// (seed, n) (a SplitMix64 style mix of seed + n). This makes it fast, and lets us
+// snapshot/restore the state as plain data or skip ahead without drawing numbers.
+//
+// There are 2 modes:
+//   - RANDOM: every shape is picked independently (uniformly) from the 7 shapes.
+//   - BAG:    the 7 shapes are shuffled into a "bag" and dealt out one at a time,
+//             a new bag is shuffled when it is empty (so droughts are bounded).
+
+#ifndef PIECERANDOMIZER_H
+#define PIECERANDOMIZER_H
+
+#include <cstdint>
+#include "Tetromino.h"
+
+class PieceRandomizer
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// how shapes are picked
+	enum class Mode : std::uint8_t {
+		RANDOM,	// each shape is picked independently
+		BAG,	// shapes are dealt from a shuffled bag of all 7 shapes
+		COUNT
+	};
+
+	// CONSTANTS
+	static const int BAG_SIZE = static_cast<int>(Tetromino::TetShape::COUNT);
+
+	// the complete state of a randomizer (plain data: copy it to snapshot, assign it to restore)
+	struct State {
+		std::uint64_t seed;			// the seed the randomizer was started with
+		std::uint64_t counter;		// the # of random numbers drawn so far
+		std::uint8_t bag[BAG_SIZE];	// the current bag of shapes (BAG mode)
+		std::uint8_t bagIndex;		// the next shape to deal from bag (BAG_SIZE = bag is empty)
+		Mode mode;					// how shapes are picked
+	};
+
+	// constructor - start a sequence from seed
+	explicit PieceRandomizer(std::uint64_t seed = 0, Mode mode = Mode::RANDOM);
+
+	// restart the sequence from a seed (keeps the mode)
+	void seed(std::uint64_t seed);
+
+	// return the seed the current sequence was started with
+	std::uint64_t getSeed() const;
+
+	// change the mode, restarting the sequence from the current seed
+	void setMode(Mode mode);
+
+	// return the mode
+	Mode getMode() const;
+
+	// return the next shape in the sequence
+	Tetromino::TetShape nextShape();
+
+	// skip over the next shapeCount shapes, as if nextShape() was called shapeCount times
+	//   (without generating the skipped shapes)
+	void skip(std::uint64_t shapeCount);
+
+	// return a copy of the complete state (snapshot)
+	State getState() const;
+
+	// restore a state previously returned by getState()
+	void setState(const State& state);
+
+private:
+	// return the next random number (and advance the counter)
+	std::uint64_t nextRandom();
+
+	// return a random number in the range [0, bound)
+	int nextBelow(int bound);
+
+	// shuffle all the shapes into a new bag (uses exactly BAG_SIZE-1 random numbers)
+	void refillBag();
+
+	// MEMBER VARIABLES
+	State state;
+};
+
+#endif /* PIECERANDOMIZER_H */
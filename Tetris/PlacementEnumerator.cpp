@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <cassert>
+#include "PlacementEnumerator.h"
+
+// constructor - allocate all buffers
+PlacementEnumerator::PlacementEnumerator()
+	: legalX(), reachableX(),
+	placed(CELL_KEY_COUNT, 0),
+	placements(CELL_KEY_COUNT)
+{
+}
+
+// enumerate the placements of a shape spawned on a board (at the board's spawnLoc,
+//   in rotation 0). returns the # of placements (0 if the shape can't be spawned)
+int PlacementEnumerator::enumerate(const Gameboard& board, Tetromino::TetShape shape)
+{
+	GridTetromino start;
+	start.setShape(shape);
+	start.setGridLoc(board.getSpawnLoc());
+	return enumerate(board, start);
+}
+
+// enumerate the placements reachable from a tetromino's current position & rotation
+//   (eg: the falling shape of a game). returns the # of placements
+int PlacementEnumerator::enumerate(const Gameboard& board, const GridTetromino& start)
+{
+	shape = static_cast<int>(start.getShape());
+	startX = start.getGridLoc().getX();
+	startY = start.getGridLoc().getY();
+	startRotation = start.getRotation();
+	assert(startY >= 0 && "the start position must not be above the grid");
+
+	// a new generation "clears" placed (really clear it once every 2^32 calls)
+	if (++generation == 0) {
+		std::fill(placed.begin(), placed.end(), 0);
+		generation = 1;
+	}
+	placementCount = 0;
+
+	buildLegalTable(board);
+	if (!fits(startRotation, startX, startY)) {
+		return 0;
+	}
+
+	// the start row is entered at the start state, every row below is entered
+	//   by moving down from the row above
+	for (int rotation = 0; rotation < TetrominoTable::ROTATION_COUNT; rotation++) {
+		reachableX[rotation][startY] = 0;
+	}
+	reachableX[startRotation][startY] = static_cast<std::uint16_t>(1 << startX);
+
+	for (int y = startY; y < Gameboard::MAX_Y; y++) {
+		if (y > startY) {
+			for (int rotation = 0; rotation < TetrominoTable::ROTATION_COUNT; rotation++) {
+				reachableX[rotation][y] = reachableX[rotation][y - 1] & legalX[rotation][y];
+			}
+		}
+		fillRow(y);
+		addPlacements(y);
+	}
+
+	return placementCount;
+}
+
+int PlacementEnumerator::getPlacementCount() const
+{
+	return placementCount;
+}
+
+const PlacementEnumerator::Placement& PlacementEnumerator::getPlacement(int index) const
+{
+	assert(index >= 0 && index < placementCount);
+	return placements[index];
+}
+
+// return true if the last enumerate() reached a placement's position & rotation
+bool PlacementEnumerator::isReachable(const Placement& placement) const
+{
+	return isReachable(placement.rotation, placement.x, placement.y);
+}
+
+// fill path with the actions that move the start position (of the last enumerate())
+//   to a placement, return the # of actions
+int PlacementEnumerator::getPath(const Placement& placement, std::vector<Action>& path) const
+{
+	path.clear();
+
+	// walk back from the placement to the start (so the path is built back to front):
+	//   up whenever the row above was reached at the same rotation & x, otherwise
+	//   back along the row to where the piece entered it
+	int rotation = placement.rotation;
+	int x = placement.x;
+	int y = placement.y;
+	assert(isReachable(rotation, x, y));
+
+	while (y > startY || rotation != startRotation || x != startX) {
+		if (y > startY && isReachable(rotation, x, y - 1)) {
+			path.push_back(Action::DOWN);
+			y--;
+		}
+		else {
+			findPathInRow(y, rotation, x, path);
+		}
+	}
+
+	std::reverse(path.begin(), path.end());
+	return static_cast<int>(path.size());
+}
+
+// return a placement as a GridTetromino (to lock it, draw it, etc.)
+GridTetromino PlacementEnumerator::getPlacedShape(const Placement& placement) const
+{
+	GridTetromino placedShape;
+	placedShape.setShape(static_cast<Tetromino::TetShape>(shape));
+	placedShape.setRotation(placement.rotation);
+	placedShape.setGridLoc(placement.x, placement.y);
+	return placedShape;
+}
+
+// Search ========================================================
+
+// fill legalX for the shape on a board: for each rotation & row, the grid loc x
+//   is legal when none of the blocks overlap the board or its left, right & lower borders.
+void PlacementEnumerator::buildLegalTable(const Gameboard& board)
+{
+	Gameboard::RowMask boardRows[Gameboard::MAX_Y];
+	for (int row = 0; row < Gameboard::MAX_Y; row++) {
+		boardRows[row] = board.getRowMask(row);
+	}
+
+	for (int rotation = 0; rotation < TetrominoTable::ROTATION_COUNT; rotation++) {
+		const TetrominoTable::Orientation& orientation = TetrominoTable::getOrientation(shape, rotation);
+
+		// the x's that keep every block within the left & right borders
+		unsigned withinBorders = ((1u << (Gameboard::MAX_X - orientation.maxX)) - 1)
+			& ~((1u << -orientation.minX) - 1);
+
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			if (y + orientation.maxY >= Gameboard::MAX_Y) {
+				legalX[rotation][y] = 0;
+				continue;
+			}
+
+			// bit x of blocked is set when a block at x + blockX lands on a filled cell
+			//   (all 10 x's are tested at once, one shift per block)
+			unsigned blocked = 0;
+			for (int b = 0; b < TetrominoTable::BLOCK_COUNT; b++) {
+				int row = y + orientation.blockY[b];
+				int blockX = orientation.blockX[b];
+				if (row >= 0) {
+					unsigned cells = boardRows[row];
+					blocked |= blockX >= 0 ? cells >> blockX : cells << -blockX;
+				}
+			}
+
+			legalX[rotation][y] = static_cast<std::uint16_t>(withinBorders & ~blocked);
+		}
+	}
+}
+
+// flood fill a row's reachable states (reachableX[*][y]) with LEFT, RIGHT & ROTATE
+void PlacementEnumerator::fillRow(int y)
+{
+	bool changed = true;
+
+	while (changed) {
+		changed = false;
+
+		for (int rotation = 0; rotation < TetrominoTable::ROTATION_COUNT; rotation++) {
+			unsigned reached = reachableX[rotation][y];
+			if (reached == 0) {
+				continue;
+			}
+
+			// LEFT & RIGHT: spread the reached bits through the runs of legal bits
+			//   (doubling the distance each step, so 4 steps cover the whole row)
+			unsigned left = reached, leftLegal = legalX[rotation][y];
+			unsigned right = reached, rightLegal = leftLegal;
+			for (int distance = 1; distance < 16; distance *= 2) {
+				left |= leftLegal & (left >> distance);
+				leftLegal &= leftLegal >> distance;
+				right |= rightLegal & (right << distance);
+				rightLegal &= rightLegal << distance;
+			}
+			reached = left | right;
+			reachableX[rotation][y] = static_cast<std::uint16_t>(reached);
+
+			// ROTATE: into the next rotation wherever it is legal
+			int next = (rotation + 1) % TetrominoTable::ROTATION_COUNT;
+			unsigned rotated = reachableX[next][y] | (reached & legalX[next][y]);
+			if (rotated != reachableX[next][y]) {
+				reachableX[next][y] = static_cast<std::uint16_t>(rotated);
+				changed = true;
+			}
+		}
+	}
+}
+
+// record the placements of row y (unless their cells are already a placement)
+void PlacementEnumerator::addPlacements(int y)
+{
+	for (int rotation = 0; rotation < TetrominoTable::ROTATION_COUNT; rotation++) {
+		unsigned below = y + 1 < Gameboard::MAX_Y ? legalX[rotation][y + 1] : 0;
+		unsigned landed = reachableX[rotation][y] & ~below;
+		if (landed == 0) {
+			continue;
+		}
+
+		// the cells of a placement are identified by its canonical rotation & bounding box corner
+		const TetrominoTable::Orientation& orientation = TetrominoTable::getOrientation(shape, rotation);
+		int keyRow = orientation.canonicalRotation * CELL_KEY_ROWS + (CELL_KEY_ROWS - Gameboard::MAX_Y) + y + orientation.minY;
+
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			if ((landed >> x) & 1) {
+				int key = keyRow * Gameboard::MAX_X + x + orientation.minX;
+				if (placed[key] != generation) {
+					placed[key] = generation;
+
+					Placement& placement = placements[placementCount++];
+					placement.x = static_cast<std::int8_t>(x);
+					placement.y = static_cast<std::int8_t>(y);
+					placement.rotation = static_cast<std::int8_t>(rotation);
+				}
+			}
+		}
+	}
+}
+
+// return true if the shape at a rotation & grid loc is legal (see legalX)
+bool PlacementEnumerator::fits(int rotation, int x, int y) const
+{
+	return static_cast<unsigned>(x) < static_cast<unsigned>(Gameboard::MAX_X)
+		&& static_cast<unsigned>(y) < static_cast<unsigned>(Gameboard::MAX_Y)
+		&& ((legalX[rotation][y] >> x) & 1) != 0;
+}
+
+// return true if a state was reached by the last enumerate()
+bool PlacementEnumerator::isReachable(int rotation, int x, int y) const
+{
+	return static_cast<unsigned>(x) < static_cast<unsigned>(Gameboard::MAX_X)
+		&& y >= startY && y < Gameboard::MAX_Y
+		&& ((reachableX[rotation][y] >> x) & 1) != 0;
+}
+
+// find the shortest path within row y, from a state where the piece entered
+//   the row (or the start state) to [rotation, x]. Append the actions to path
+//   back to front, and move [rotation, x] to the state the path begins at.
+void PlacementEnumerator::findPathInRow(int y, int& rotation, int& x, std::vector<Action>& path) const
+{
+	const int ROW_STATES = TetrominoTable::ROTATION_COUNT * Gameboard::MAX_X;
+	int queue[ROW_STATES];
+	int nextStates[ROW_STATES];			// [state] = the state it moves to (towards the target)
+	Action nextActions[ROW_STATES];		// [state] = the action that moves it there
+	bool seen[ROW_STATES] = {};
+	int queueTail = 0;
+
+	// search backwards from the target, over the reachable states of the row
+	int target = rotation * Gameboard::MAX_X + x;
+	queue[queueTail++] = target;
+	seen[target] = true;
+
+	for (int queueHead = 0; queueHead < queueTail; queueHead++) {
+		int state = queue[queueHead];
+		int r = state / Gameboard::MAX_X;
+		int sx = state % Gameboard::MAX_X;
+
+		bool isEntry = (y == startY) ? (r == startRotation && sx == startX) : isReachable(r, sx, y - 1);
+		if (isEntry) {
+			// follow the moves from here to the target, then flip them (back to front)
+			int pathStart = static_cast<int>(path.size());
+			for (int s = state; s != target; s = nextStates[s]) {
+				path.push_back(nextActions[s]);
+			}
+			std::reverse(path.begin() + pathStart, path.end());
+			rotation = r;
+			x = sx;
+			return;
+		}
+
+		// the states that move to this one: from the right (LEFT), from the left (RIGHT),
+		//   from the previous rotation (ROTATE)
+		const int fromRotation[3] = { r, r, (r + TetrominoTable::ROTATION_COUNT - 1) % TetrominoTable::ROTATION_COUNT };
+		const int fromX[3] = { sx + 1, sx - 1, sx };
+		const Action fromAction[3] = { Action::LEFT, Action::RIGHT, Action::ROTATE };
+		for (int i = 0; i < 3; i++) {
+			if (isReachable(fromRotation[i], fromX[i], y)) {
+				int from = fromRotation[i] * Gameboard::MAX_X + fromX[i];
+				if (!seen[from]) {
+					seen[from] = true;
+					nextStates[from] = state;
+					nextActions[from] = fromAction[i];
+					queue[queueTail++] = from;
+				}
+			}
+		}
+	}
+
+	assert(false && "every reachable state is connected to the row's entry states");
+}
@@ -0,0 +1,128 @@
+// The PlacementEnumerator is a move generator for bots: given a board and a shape,
+// it finds every distinct position the shape can be locked in, and the inputs
+// (TetrisEngine actions) that get it there.
+//
+// - Search: a breadth first search over the piece states (x, y, rotation) reachable
+//   from the start position with LEFT, RIGHT, DOWN and ROTATE. Because the search
+//   follows the same moves as a player, it finds slides and tucks under overhangs
+//   that a "rotate, shift, drop" generator misses.
+//   The search is done a row at a time, with all 10 x's of a rotation in one bitmask:
+//   a row's reachable states are the states entered from the row above (DOWN),
+//   flood filled with LEFT/RIGHT (a few shifts) and ROTATE (an AND with the next
+//   rotation's legal x's) until nothing changes. Pieces never move up, so one pass
+//   from the start row to the bottom finds every reachable state.
+// - Placements: a state is a placement when the piece can't move down from it.
+//   States that cover the same cells (eg: an I in rotation 0 or 2) are the same
+//   placement, and are only reported once.
+// - Paths: getPath() rebuilds the inputs to a placement on demand (a bot usually
+//   only needs the path of the placement it picks). Paths move the piece as high
+//   up as possible: moving down is only delayed when the piece has to slide or
+//   rotate lower down (eg: to tuck under an overhang).
+// - Memory: every buffer is allocated once by the constructor and reused, and the
+//   placements of a cell set are marked with a generation number, so enumerate()
+//   neither allocates nor clears anything. Reuse one enumerator per thread.
+//
+// Note: paths don't include gravity. Applying a path and then DROP (or DOWN)
+// locks the piece in the placement, as long as no tick happens in between.
+
+#ifndef PLACEMENTENUMERATOR_H
+#define PLACEMENTENUMERATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "TetrisEngine.h"
+#include "TetrominoTable.h"
+
+class PlacementEnumerator
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	typedef TetrisEngine::Action Action;
+
+	// a reachable lock position: the gridLoc & rotation index of the locked tetromino
+	struct Placement {
+		std::int8_t x;
+		std::int8_t y;
+		std::int8_t rotation;
+	};
+
+	// CONSTANTS
+
+	// the # of distinct cell sets: every rotation at every bounding box top left corner
+	//   (the top of a bounding box can be up to 2 rows above the grid)
+	static const int CELL_KEY_ROWS = Gameboard::MAX_Y + 2;
+	static const int CELL_KEY_COUNT = TetrominoTable::ROTATION_COUNT * CELL_KEY_ROWS * Gameboard::MAX_X;
+
+	// constructor - allocate all buffers
+	PlacementEnumerator();
+
+	// enumerate the placements of a shape spawned on a board (at the board's spawnLoc,
+	//   in rotation 0). returns the # of placements (0 if the shape can't be spawned)
+	int enumerate(const Gameboard& board, Tetromino::TetShape shape);
+
+	// enumerate the placements reachable from a tetromino's current position & rotation
+	//   (eg: the falling shape of a game). returns the # of placements
+	int enumerate(const Gameboard& board, const GridTetromino& start);
+
+	// return the # of placements found by the last enumerate()
+	int getPlacementCount() const;
+
+	// return a placement found by the last enumerate()
+	const Placement& getPlacement(int index) const;
+
+	// return true if the last enumerate() reached a placement's position & rotation
+	//   (eg: to check that a remembered placement can still be reached from a new start)
+	bool isReachable(const Placement& placement) const;
+
+	// fill path with the actions that move the start position (of the last enumerate())
+	//   to a placement, return the # of actions
+	int getPath(const Placement& placement, std::vector<Action>& path) const;
+
+	// return a placement as a GridTetromino (to lock it, draw it, etc.)
+	GridTetromino getPlacedShape(const Placement& placement) const;
+
+private:
+	// fill legalX for the shape on a board: for each rotation & row, the grid loc x
+	//   is legal when none of the blocks overlap the board or its left, right & lower borders.
+	void buildLegalTable(const Gameboard& board);
+
+	// flood fill a row's reachable states (reachableX[*][y]) with LEFT, RIGHT & ROTATE
+	void fillRow(int y);
+
+	// record the placements of row y (unless their cells are already a placement)
+	void addPlacements(int y);
+
+	// return true if the shape at a rotation & grid loc is legal (see legalX)
+	bool fits(int rotation, int x, int y) const;
+
+	// return true if a state was reached by the last enumerate()
+	bool isReachable(int rotation, int x, int y) const;
+
+	// find the shortest path within row y, from a state where the piece entered
+	//   the row (or the start state) to [rotation, x]. Append the actions to path
+	//   back to front, and move [rotation, x] to the state the path begins at.
+	void findPathInRow(int y, int& rotation, int& x, std::vector<Action>& path) const;
+
+	// MEMBER VARIABLES
+
+	int shape = 0;									// the shape being enumerated
+	int startX = 0;									// the start position of the shape
+	int startY = 0;
+	int startRotation = 0;
+
+	// [rotation][y] = a bit for each legal x (built once per enumerate())
+	std::uint16_t legalX[TetrominoTable::ROTATION_COUNT][Gameboard::MAX_Y];
+	// [rotation][y] = a bit for each x the search reached
+	std::uint16_t reachableX[TetrominoTable::ROTATION_COUNT][Gameboard::MAX_Y];
+
+	std::uint32_t generation = 0;					// marks the placements of this enumerate()
+	std::vector<std::uint32_t> placed;				// [cell key] = the generation that placed those cells
+	std::vector<Placement> placements;				// the placements found
+	int placementCount = 0;
+};
+
+#endif /* PLACEMENTENUMERATOR_H */
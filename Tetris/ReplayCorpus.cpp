@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "ReplayCorpus.h"
+
+// map a corpus file, return false if it can't be mapped or isn't a (complete) corpus
+bool ReplayCorpus::open(const std::string& path)
+{
+	close();
+	if (!file.open(path, MappedFile::Access::SEQUENTIAL) || file.getSize() < HEADER_BYTES) {
+		close();
+		return false;
+	}
+
+	const std::uint8_t* p = file.getData();
+	std::uint32_t magic = static_cast<std::uint32_t>(ReplayFormat::readBytes(p, 4));
+	std::uint16_t version = static_cast<std::uint16_t>(ReplayFormat::readBytes(p, 2));
+	std::uint16_t headerBytes = static_cast<std::uint16_t>(ReplayFormat::readBytes(p, 2));
+	std::uint64_t games = ReplayFormat::readBytes(p, 8);
+	std::uint64_t index = ReplayFormat::readBytes(p, 8);
+	std::uint64_t size = ReplayFormat::readBytes(p, 8);
+
+	// (a corpus that was cut short, or never closed, doesn't have the size it claims)
+	std::uint64_t indexBytes = (games + 1) * INDEX_ENTRY_BYTES;
+	if (magic != MAGIC || version == 0 || version > VERSION || headerBytes < HEADER_BYTES
+		|| size != file.getSize() || index < headerBytes || index > size
+		|| games >= size / INDEX_ENTRY_BYTES || size - index != indexBytes)
+	{
+		close();
+		return false;
+	}
+
+	gameCount = games;
+	indexOffset = index;
+	return true;
+}
+
+// unmap the corpus
+void ReplayCorpus::close()
+{
+	file.close();
+	gameCount = 0;
+	indexOffset = 0;
+}
+
+std::uint64_t ReplayCorpus::getGameCount() const
+{
+	return gameCount;
+}
+
+std::size_t ReplayCorpus::getSize() const
+{
+	return file.getSize();
+}
+
+// return the replay of a game (in the mapped file) & its size,
+//   nullptr if the index is corrupt
+const std::uint8_t* ReplayCorpus::getReplay(std::uint64_t gameIndex, std::size_t& size) const
+{
+	if (gameIndex >= gameCount) {
+		size = 0;
+		return nullptr;
+	}
+
+	const std::uint8_t* p = file.getData() + indexOffset + gameIndex * INDEX_ENTRY_BYTES;
+	std::uint64_t begin = ReplayFormat::readBytes(p, 8);
+	std::uint64_t end = ReplayFormat::readBytes(p, 8);
+	if (begin < HEADER_BYTES || begin > end || end > indexOffset) {
+		size = 0;
+		return nullptr;
+	}
+
+	size = static_cast<std::size_t>(end - begin);
+	return file.getData() + begin;
+}
+
+// make a player view a game (without copying it), return false if it isn't a replay
+bool ReplayCorpus::view(std::uint64_t gameIndex, ReplayPlayer& player) const
+{
+	std::size_t size;
+	const std::uint8_t* replay = getReplay(gameIndex, size);
+	return replay != nullptr && player.view(replay, size);
+}
+
+// return the range of games [begin, end) of shard # shard (of shardCount even shards)
+void ReplayCorpus::getShard(int shard, int shardCount, std::uint64_t& begin, std::uint64_t& end) const
+{
+	// (spread the remainder over the first shards, so shards differ by 1 game at most)
+	std::uint64_t shards = static_cast<std::uint64_t>(std::max(shardCount, 1));
+	std::uint64_t index = static_cast<std::uint64_t>(std::min(std::max(shard, 0), static_cast<int>(shards)));
+	begin = gameCount / shards * index + std::min(index, gameCount % shards);
+	end = std::min(begin + gameCount / shards + (index < gameCount % shards ? 1 : 0), gameCount);
+}
+
+// visit every game of a shard (skipping the games that aren't replays), in order
+void ReplayCorpus::forEachGame(int shard, int shardCount, const GameVisitor& visit) const
+{
+	std::uint64_t begin, end;
+	getShard(shard, shardCount, begin, end);
+
+	ReplayPlayer player;
+	for (std::uint64_t game = begin; game < end; game++) {
+		if (view(game, player)) {
+			visit(game, player);
+		}
+	}
+}
+
+// visit every game on threadCount threads, one shard per thread, return the # of shards
+int ReplayCorpus::forEachGameParallel(int threadCount, const ShardVisitor& visit) const
+{
+	int shardCount = threadCount > 0 ? threadCount : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	auto visitShard = [this, shardCount, &visit](int shard) {
+		forEachGame(shard, shardCount, [shard, &visit](std::uint64_t gameIndex, ReplayPlayer& player) {
+			visit(shard, gameIndex, player);
+		});
+	};
+
+	// (the calling thread scans the first shard)
+	std::vector<std::thread> threads;
+	for (int shard = 1; shard < shardCount; shard++) {
+		threads.emplace_back(visitShard, shard);
+	}
+	visitShard(0);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	return shardCount;
+}
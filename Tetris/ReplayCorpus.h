@@ -0,0 +1,81 @@
+// A ReplayCorpus is a large file of many replays (eg: every game of a tournament),
+// written by the ReplayCorpusWriter and read in place for bulk analysis: the file is
+// memory mapped (see MappedFile), and each game is handed to a ReplayPlayer as a
+// view into the mapping, so scanning a corpus copies nothing and decodes the games'
+// events on the fly (into a headless engine, or not at all).
+//
+// A corpus is (all fields little endian):
+// - Header (HEADER_BYTES): a magic number & version, the header's size, the # of
+//   games, the offset of the index and the size of the corpus.
+// - Replays: the games' replay files (see ReplayFormat), as is, one after the other.
+// - Index: the offset of each replay, then the offset of the index (8 bytes each),
+//   so game i spans [offset i, offset i + 1) and is found in constant time.
+//
+// The games can be scanned in shards (even ranges of games), one per thread: every
+// thread has its own player (and engine), nothing is shared but the read only map.
+
+#ifndef REPLAYCORPUS_H
+#define REPLAYCORPUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "MappedFile.h"
+#include "ReplayPlayer.h"
+
+class ReplayCorpus
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// visits a game: its index, and a player viewing it (not started)
+	typedef std::function<void(std::uint64_t gameIndex, ReplayPlayer& player)> GameVisitor;
+	// visits a game of a shard (called on the shard's thread)
+	typedef std::function<void(int shard, std::uint64_t gameIndex, ReplayPlayer& player)> ShardVisitor;
+
+	// CONSTANTS
+	static const std::uint32_t MAGIC = 0x43505254;	// "TRPC" (little endian)
+	static const std::uint16_t VERSION = 1;
+	static const int HEADER_BYTES = 32;
+	static const int INDEX_ENTRY_BYTES = 8;
+
+	// map a corpus file, return false if it can't be mapped or isn't a (complete) corpus
+	bool open(const std::string& path);
+
+	// unmap the corpus
+	void close();
+
+	// return the # of games
+	std::uint64_t getGameCount() const;
+
+	// return the size of the corpus (bytes)
+	std::size_t getSize() const;
+
+	// return the replay of a game (in the mapped file) & its size,
+	//   nullptr if the index is corrupt
+	const std::uint8_t* getReplay(std::uint64_t gameIndex, std::size_t& size) const;
+
+	// make a player view a game (without copying it), return false if it isn't a replay
+	bool view(std::uint64_t gameIndex, ReplayPlayer& player) const;
+
+	// return the range of games [begin, end) of shard # shard (of shardCount even shards)
+	void getShard(int shard, int shardCount, std::uint64_t& begin, std::uint64_t& end) const;
+
+	// visit every game of a shard (skipping the games that aren't replays), in order
+	void forEachGame(int shard, int shardCount, const GameVisitor& visit) const;
+
+	// visit every game on threadCount threads (0 = one per hardware thread), one
+	//   shard per thread, return the # of shards
+	int forEachGameParallel(int threadCount, const ShardVisitor& visit) const;
+
+private:
+	// MEMBER VARIABLES
+
+	MappedFile file;
+	std::uint64_t gameCount = 0;
+	std::uint64_t indexOffset = 0;
+};
+
+#endif /* REPLAYCORPUS_H */
@@ -0,0 +1,98 @@
+#include <iterator>
+#include "ReplayCorpus.h"
+#include "ReplayCorpusWriter.h"
+#include "ReplayFormat.h"
+
+// destructor - close() the corpus (if open)
+ReplayCorpusWriter::~ReplayCorpusWriter()
+{
+	close();
+}
+
+// start a new corpus file, return false if it can't be created
+bool ReplayCorpusWriter::open(const std::string& path)
+{
+	close();
+
+	offsets.clear();
+	failed = false;
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+
+	// (a blank header, until close())
+	std::vector<std::uint8_t> header(ReplayCorpus::HEADER_BYTES, 0);
+	file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+	size = header.size();
+	return static_cast<bool>(file);
+}
+
+// append a replay, return false if it isn't a replay or it couldn't be written
+bool ReplayCorpusWriter::add(const std::uint8_t* data, std::size_t replaySize)
+{
+	ReplayFormat::Header header;
+	if (!file.is_open() || ReplayFormat::readHeader(data, replaySize, header) == 0) {
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(replaySize));
+	if (!file) {
+		failed = true;
+		return false;
+	}
+	offsets.push_back(size);
+	size += replaySize;
+	return true;
+}
+
+// append a replay file
+bool ReplayCorpusWriter::addFile(const std::string& path)
+{
+	std::ifstream replay(path, std::ios::binary);
+	if (!replay) {
+		return false;
+	}
+
+	std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(replay)), std::istreambuf_iterator<char>());
+	return add(bytes.data(), bytes.size());
+}
+
+// write the index & header and close the file
+bool ReplayCorpusWriter::close()
+{
+	if (!file.is_open()) {
+		return false;
+	}
+
+	std::uint64_t indexOffset = size;
+	std::vector<std::uint8_t> bytes;
+	bytes.reserve((offsets.size() + 1) * ReplayCorpus::INDEX_ENTRY_BYTES);
+	for (std::uint64_t offset : offsets) {
+		ReplayFormat::writeBytes(offset, 8, bytes);
+	}
+	ReplayFormat::writeBytes(indexOffset, 8, bytes);
+	file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	size += bytes.size();
+
+	bytes.clear();
+	ReplayFormat::writeBytes(ReplayCorpus::MAGIC, 4, bytes);
+	ReplayFormat::writeBytes(ReplayCorpus::VERSION, 2, bytes);
+	ReplayFormat::writeBytes(ReplayCorpus::HEADER_BYTES, 2, bytes);
+	ReplayFormat::writeBytes(offsets.size(), 8, bytes);
+	ReplayFormat::writeBytes(indexOffset, 8, bytes);
+	ReplayFormat::writeBytes(size, 8, bytes);
+	file.seekp(0);
+	file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+	static_assert(4 + 2 + 2 + 8 + 8 + 8 == ReplayCorpus::HEADER_BYTES, "the corpus header layout");
+
+	bool written = static_cast<bool>(file) && !failed;
+	file.close();
+	return written;
+}
+
+std::uint64_t ReplayCorpusWriter::getGameCount() const
+{
+	return offsets.size();
+}
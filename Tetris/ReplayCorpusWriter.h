@@ -0,0 +1,56 @@
+// The ReplayCorpusWriter gathers replays (files, or replays in memory) into a
+// ReplayCorpus file: the replays are appended as they are added (so a corpus of
+// millions of games is written in one pass, with only its index in memory), and
+// the index & header are written by close().
+//
+// Until it is closed, a corpus has a blank header: a corpus whose writer didn't
+// finish isn't taken for a complete one.
+
+#ifndef REPLAYCORPUSWRITER_H
+#define REPLAYCORPUSWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class ReplayCorpusWriter
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	ReplayCorpusWriter() = default;
+	// destructor - close() the corpus (if open)
+	~ReplayCorpusWriter();
+
+	ReplayCorpusWriter(const ReplayCorpusWriter&) = delete;
+	ReplayCorpusWriter& operator=(const ReplayCorpusWriter&) = delete;
+
+	// start a new corpus file, return false if it can't be created
+	bool open(const std::string& path);
+
+	// append a replay, return false if it isn't a replay (it isn't added) or it
+	//   couldn't be written
+	bool add(const std::uint8_t* data, std::size_t size);
+	// (same as above) from a replay file
+	bool addFile(const std::string& path);
+
+	// write the index & header and close the file, return false if anything
+	//   couldn't be written (the corpus isn't valid)
+	bool close();
+
+	// return the # of games added
+	std::uint64_t getGameCount() const;
+
+private:
+	// MEMBER VARIABLES
+
+	std::ofstream file;
+	std::vector<std::uint64_t> offsets;		// the offset of each replay
+	std::uint64_t size = 0;					// the # of bytes written so far
+	bool failed = false;
+};
+
+#endif /* REPLAYCORPUSWRITER_H */
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include "ReplayFormat.h"
+
+static_assert(static_cast<int>(ReplayFormat::EventType::DROP) == static_cast<int>(TetrisEngine::Action::DROP),
+	"actions are stored as events of the same value");
+static_assert(static_cast<int>(ReplayFormat::EventType::COUNT) <= (1 << ReplayFormat::TYPE_BITS),
+	"every event type fits in TYPE_BITS");
+static_assert(Gameboard::MAX_CONTENT + 1 <= 0xF, "every block content fits in a keyframe's 4 bits");
+
+namespace {
+	std::uint64_t toBits(double value)
+	{
+		std::uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	double fromBits(std::uint64_t bits)
+	{
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
+
+// return the header of a game about to be played (or just reset) on an engine
+ReplayFormat::Header ReplayFormat::makeHeader(const TetrisEngine& engine)
+{
+	Header header;
+	header.version = VERSION;
+	header.boardWidth = static_cast<std::uint8_t>(Gameboard::MAX_X);
+	header.boardHeight = static_cast<std::uint8_t>(Gameboard::MAX_Y);
+	header.maxSecondsPerTick = engine.getMaxSecondsPerTick();
+	header.minSecondsPerTick = engine.getMinSecondsPerTick();
+	header.randomizer = engine.getStartRandomizerState();
+	return header;
+}
+
+// return true if an engine plays by the rules of a header
+bool ReplayFormat::hasSameRules(const Header& header, const TetrisEngine& engine)
+{
+	return header.boardWidth == Gameboard::MAX_X
+		&& header.boardHeight == Gameboard::MAX_Y
+		&& header.maxSecondsPerTick == engine.getMaxSecondsPerTick()
+		&& header.minSecondsPerTick == engine.getMinSecondsPerTick();
+}
+
+// append a header to out
+void ReplayFormat::writeHeader(const Header& header, std::vector<std::uint8_t>& out)
+{
+	writeBytes(MAGIC, 4, out);
+	writeBytes(header.version, 2, out);
+	writeBytes(HEADER_BYTES, 2, out);
+	writeBytes(header.boardWidth, 1, out);
+	writeBytes(header.boardHeight, 1, out);
+	writeBytes(toBits(header.maxSecondsPerTick), 8, out);
+	writeBytes(toBits(header.minSecondsPerTick), 8, out);
+	writeBytes(header.randomizer.seed, 8, out);
+	writeBytes(header.randomizer.counter, 8, out);
+	for (int i = 0; i < PieceRandomizer::BAG_SIZE; i++) {
+		writeBytes(header.randomizer.bag[i], 1, out);
+	}
+	writeBytes(header.randomizer.bagIndex, 1, out);
+	writeBytes(static_cast<std::uint8_t>(header.randomizer.mode), 1, out);
+
+	static_assert(4 + 2 + 2 + 1 + 1 + 8 + 8 + 8 + 8 + PieceRandomizer::BAG_SIZE + 1 + 1 == HEADER_BYTES, "the header layout");
+}
+
+// read a header from the start of data, return the # of bytes it takes
+//   (0 if it isn't a header of a version this code can read)
+std::size_t ReplayFormat::readHeader(const std::uint8_t* data, std::size_t size, Header& header)
+{
+	if (size < HEADER_BYTES) {
+		return 0;
+	}
+
+	const std::uint8_t* p = data;
+	if (readBytes(p, 4) != MAGIC) {
+		return 0;
+	}
+	header.version = static_cast<std::uint16_t>(readBytes(p, 2));
+	std::size_t headerBytes = static_cast<std::size_t>(readBytes(p, 2));
+	// (later versions may add fields at the end of the header: skip over them)
+	if (header.version == 0 || header.version > VERSION || headerBytes < HEADER_BYTES || headerBytes > size) {
+		return 0;
+	}
+
+	header.boardWidth = static_cast<std::uint8_t>(readBytes(p, 1));
+	header.boardHeight = static_cast<std::uint8_t>(readBytes(p, 1));
+	header.maxSecondsPerTick = fromBits(readBytes(p, 8));
+	header.minSecondsPerTick = fromBits(readBytes(p, 8));
+	header.randomizer.seed = readBytes(p, 8);
+	header.randomizer.counter = readBytes(p, 8);
+	for (int i = 0; i < PieceRandomizer::BAG_SIZE; i++) {
+		header.randomizer.bag[i] = static_cast<std::uint8_t>(readBytes(p, 1));
+	}
+	header.randomizer.bagIndex = static_cast<std::uint8_t>(readBytes(p, 1));
+	std::uint8_t mode = static_cast<std::uint8_t>(readBytes(p, 1));
+	if (mode >= static_cast<std::uint8_t>(PieceRandomizer::Mode::COUNT) || header.randomizer.bagIndex > PieceRandomizer::BAG_SIZE) {
+		return 0;
+	}
+	header.randomizer.mode = static_cast<PieceRandomizer::Mode>(mode);
+
+	return headerBytes;
+}
+
+// append an event to out
+void ReplayFormat::writeEvent(EventType type, std::uint32_t time, std::vector<std::uint8_t>& out)
+{
+	writeVarint((static_cast<std::uint64_t>(time) << TYPE_BITS) | static_cast<std::uint64_t>(type), out);
+}
+
+// append a keyframe to out:
+//   varints: event offset, event count, time, score, shapes placed, ticks
+//   bytes: flags (game over, shape placed since the last update), current | next shape << 4,
+//     current rotation, x & y
+//   doubles: seconds per tick, elapsed seconds, seconds since the last tick
+//   randomizer: counter (varint), bag, bag index (the seed & mode are the header's)
+//   board: the top non empty row, then the cells of each row from there down,
+//     2 per byte (content + 1, 0 if empty)
+//   (nothing is appended if a block's content doesn't fit)
+bool ReplayFormat::writeKeyframe(const Keyframe& keyframe, std::vector<std::uint8_t>& out)
+{
+	const TetrisEngine::State& state = keyframe.state;
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			if (state.cells[y][x] < Gameboard::EMPTY_BLOCK || state.cells[y][x] > Gameboard::MAX_CONTENT) {
+				return false;
+			}
+		}
+	}
+
+	writeVarint(keyframe.eventOffset, out);
+	writeVarint(keyframe.eventCount, out);
+	writeVarint(keyframe.time, out);
+	writeVarint(static_cast<std::uint64_t>(state.score), out);
+	writeVarint(static_cast<std::uint64_t>(state.shapesPlaced), out);
+	writeVarint(static_cast<std::uint64_t>(state.ticks), out);
+
+	writeBytes((state.gameOver ? 1 : 0) | (state.shapePlacedSinceLastUpdate ? 2 : 0), 1, out);
+	writeBytes(static_cast<std::uint64_t>(state.currentShape) | (static_cast<std::uint64_t>(state.nextShape) << 4), 1, out);
+	writeBytes(static_cast<std::uint8_t>(state.currentRotation), 1, out);
+	writeBytes(static_cast<std::uint8_t>(state.currentX), 1, out);
+	writeBytes(static_cast<std::uint8_t>(state.currentY), 1, out);
+
+	writeBytes(toBits(state.secondsPerTick), 8, out);
+	writeBytes(toBits(state.elapsedSeconds), 8, out);
+	writeBytes(toBits(state.secondsSinceLastTick), 8, out);
+
+	writeVarint(state.randomizer.counter, out);
+	for (int i = 0; i < PieceRandomizer::BAG_SIZE; i++) {
+		writeBytes(state.randomizer.bag[i], 1, out);
+	}
+	writeBytes(state.randomizer.bagIndex, 1, out);
+
+	int top = 0;
+	while (top < Gameboard::MAX_Y && std::all_of(std::begin(state.cells[top]), std::end(state.cells[top]),
+		[](std::int8_t cell) { return cell == Gameboard::EMPTY_BLOCK; })) {
+		top++;
+	}
+	writeBytes(top, 1, out);
+	for (int y = top; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X; x += 2) {
+			writeBytes((state.cells[y][x] + 1) | ((state.cells[y][x + 1] + 1) << 4), 1, out);
+		}
+	}
+
+	static_assert(Gameboard::MAX_X % 2 == 0, "a row is stored 2 cells per byte");
+	return true;
+}
+
+// read a keyframe at data (of a replay with header), return false if it is
+//   corrupt or the data ends first
+bool ReplayFormat::readKeyframe(const std::uint8_t* data, const std::uint8_t* end, const Header& header, Keyframe& keyframe)
+{
+	TetrisEngine::State& state = keyframe.state;
+	const int FIXED_BYTES = 5 + 3 * 8;	// (the flags, shapes & position, and the doubles)
+
+	std::uint64_t eventOffset, score, shapesPlaced, ticks;
+	if (!readVarint(data, end, eventOffset) || !readVarint(data, end, keyframe.eventCount)
+		|| !readVarint(data, end, keyframe.time) || !readVarint(data, end, score)
+		|| !readVarint(data, end, shapesPlaced) || !readVarint(data, end, ticks)
+		|| end - data < FIXED_BYTES)
+	{
+		return false;
+	}
+	keyframe.eventOffset = static_cast<std::uint32_t>(eventOffset);
+	state.score = static_cast<int>(score);
+	state.shapesPlaced = static_cast<int>(shapesPlaced);
+	state.ticks = static_cast<int>(ticks);
+
+	std::uint8_t flags = static_cast<std::uint8_t>(readBytes(data, 1));
+	std::uint8_t shapes = static_cast<std::uint8_t>(readBytes(data, 1));
+	state.currentRotation = static_cast<std::int8_t>(readBytes(data, 1));
+	state.currentX = static_cast<std::int8_t>(readBytes(data, 1));
+	state.currentY = static_cast<std::int8_t>(readBytes(data, 1));
+	const int SHAPE_COUNT = static_cast<int>(Tetromino::TetShape::COUNT);
+	if ((shapes & 0xF) >= SHAPE_COUNT || (shapes >> 4) >= SHAPE_COUNT
+		|| state.currentRotation < 0 || state.currentRotation >= Tetromino::ROTATION_COUNT)
+	{
+		return false;
+	}
+	state.gameOver = (flags & 1) != 0;
+	state.shapePlacedSinceLastUpdate = (flags & 2) != 0;
+	state.currentShape = static_cast<Tetromino::TetShape>(shapes & 0xF);
+	state.nextShape = static_cast<Tetromino::TetShape>(shapes >> 4);
+
+	state.secondsPerTick = fromBits(readBytes(data, 8));
+	state.elapsedSeconds = fromBits(readBytes(data, 8));
+	state.secondsSinceLastTick = fromBits(readBytes(data, 8));
+
+	state.startRandomizer = header.randomizer;
+	state.randomizer = header.randomizer;
+	if (!readVarint(data, end, state.randomizer.counter) || end - data < PieceRandomizer::BAG_SIZE + 2) {
+		return false;
+	}
+	for (int i = 0; i < PieceRandomizer::BAG_SIZE; i++) {
+		state.randomizer.bag[i] = static_cast<std::uint8_t>(readBytes(data, 1));
+	}
+	state.randomizer.bagIndex = static_cast<std::uint8_t>(readBytes(data, 1));
+	if (state.randomizer.bagIndex > PieceRandomizer::BAG_SIZE) {
+		return false;
+	}
+
+	int top = static_cast<int>(readBytes(data, 1));
+	if (top > Gameboard::MAX_Y || end - data < (Gameboard::MAX_Y - top) * Gameboard::MAX_X / 2) {
+		return false;
+	}
+	// (a cell holds content + 1: EMPTY_BLOCK to Gameboard::MAX_CONTENT)
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X; x += 2) {
+			int pair = y < top ? 0 : static_cast<int>(readBytes(data, 1));
+			if ((pair & 0xF) > Gameboard::MAX_CONTENT + 1 || (pair >> 4) > Gameboard::MAX_CONTENT + 1) {
+				return false;
+			}
+			state.cells[y][x] = static_cast<std::int8_t>((pair & 0xF) - 1);
+			state.cells[y][x + 1] = static_cast<std::int8_t>((pair >> 4) - 1);
+		}
+	}
+	return true;
+}
+
+// append the keyframe index (entries in order of shapes placed) & the trailer to out:
+//   the entries (shapes placed, keyframe offset: 4 bytes each), then the trailer
+//   (entries offset, entry count, interval, INDEX_MAGIC: 4 bytes each)
+void ReplayFormat::writeIndex(const std::vector<IndexEntry>& entries, std::uint32_t interval, std::uint32_t entriesOffset, std::vector<std::uint8_t>& out)
+{
+	for (const IndexEntry& entry : entries) {
+		writeBytes(entry.shapesPlaced, 4, out);
+		writeBytes(entry.keyframeOffset, 4, out);
+	}
+	writeBytes(entriesOffset, 4, out);
+	writeBytes(entries.size(), 4, out);
+	writeBytes(interval, 4, out);
+	writeBytes(INDEX_MAGIC, 4, out);
+}
+
+// read the keyframe index from the trailer at the end of a replay's data
+//   (whose events start at eventsStart), return false if there is none
+bool ReplayFormat::readIndex(const std::uint8_t* data, std::size_t size, std::size_t eventsStart, Index& index)
+{
+	if (size < eventsStart + INDEX_TRAILER_BYTES) {
+		return false;
+	}
+
+	const std::uint8_t* p = data + size - INDEX_TRAILER_BYTES;
+	index.entriesOffset = static_cast<std::uint32_t>(readBytes(p, 4));
+	index.entryCount = static_cast<std::uint32_t>(readBytes(p, 4));
+	index.interval = static_cast<std::uint32_t>(readBytes(p, 4));
+	if (readBytes(p, 4) != INDEX_MAGIC || index.interval == 0 || index.entriesOffset < eventsStart) {
+		return false;
+	}
+	// (the entries end where the trailer starts)
+	return static_cast<std::uint64_t>(index.entriesOffset) + static_cast<std::uint64_t>(index.entryCount) * INDEX_ENTRY_BYTES
+		== size - INDEX_TRAILER_BYTES;
+}
+
+// return entry i (< index.entryCount) of a replay's keyframe index
+ReplayFormat::IndexEntry ReplayFormat::readIndexEntry(const std::uint8_t* data, const Index& index, std::uint32_t i)
+{
+	const std::uint8_t* p = data + index.entriesOffset + static_cast<std::size_t>(i) * INDEX_ENTRY_BYTES;
+	IndexEntry entry;
+	entry.shapesPlaced = static_cast<std::uint32_t>(readBytes(p, 4));
+	entry.keyframeOffset = static_cast<std::uint32_t>(readBytes(p, 4));
+	return entry;
+}
+
+// append the byteCount low bytes of a value to out, little endian
+void ReplayFormat::writeBytes(std::uint64_t value, int byteCount, std::vector<std::uint8_t>& out)
+{
+	for (int i = 0; i < byteCount; i++) {
+		out.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+	}
+}
+
+// read a little endian value of byteCount bytes at data (and advance it)
+std::uint64_t ReplayFormat::readBytes(const std::uint8_t*& data, int byteCount)
+{
+	std::uint64_t value = 0;
+	for (int i = 0; i < byteCount; i++) {
+		value |= static_cast<std::uint64_t>(*data++) << (8 * i);
+	}
+	return value;
+}
+
+// append an unsigned LEB128 varint to out (7 bits per byte, the high bit set on all but the last)
+void ReplayFormat::writeVarint(std::uint64_t value, std::vector<std::uint8_t>& out)
+{
+	while (value >= 0x80) {
+		out.push_back(static_cast<std::uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<std::uint8_t>(value));
+}
+
+// return the event type of an action (actions are events of the same value)
+ReplayFormat::EventType ReplayFormat::toEventType(TetrisEngine::Action action)
+{
+	return static_cast<EventType>(action);
+}
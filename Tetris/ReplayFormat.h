@@ -0,0 +1,189 @@
+// ReplayFormat defines the binary format of a recorded game (a replay), shared by
+// the ReplayRecorder (which writes replays) and the ReplayPlayer (which reads them).
+//
+// A replay is a header followed by a stream of events:
+// - Header: a magic number & version, the rules the game was played with (board
+//   size, tick rates) and the state of the randomizer when the game was reset, so
+//   the game's shapes can be dealt again. All fields are little endian.
+// - Events: everything that changed the game, in order: the player's actions, the
+//   ticks, and the "settles" (the update() that spawned the next shape after one
+//   was locked). Each event is one varint: (time since the last event << 3) | event
+//   type, where time is in 1/64ths of a second (about a frame), so an event is a
+//   single byte when it follows the previous one within 1/4 of a second, and 2 bytes
+//   within 32 seconds.
+// - End: an END event, followed by the final # of shapes placed and score (varints),
+//   so a player can check that it reproduced the game.
+// - Keyframes (optional): the full state of the game every few shapes placed (right
+//   after their settle), each with the offset of the event that follows it, then an
+//   index of the keyframes (fixed size entries) and a 16 byte trailer that locates
+//   the index from the end of the replay. A player can seek to any shape # by
+//   reading one index entry, restoring its keyframe and applying the few events
+//   since, instead of replaying the game from its start. (A replay that was cut short
+//   has no keyframes: it can still be played from its start.)
+//
+// Replaying the events through a TetrisEngine is deterministic: the engine's state
+// only changes on actions, ticks & settles, and the replay has all of them (the
+// time between them is kept for viewers, it isn't needed to reproduce the game).
+
+#ifndef REPLAYFORMAT_H
+#define REPLAYFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PieceRandomizer.h"
+#include "TetrisEngine.h"
+
+class ReplayFormat
+{
+public:
+	// the kinds of events (the actions have the values of TetrisEngine::Action)
+	enum class EventType : std::uint8_t {
+		END,		// the end of the replay
+		ROTATE,		// an applyAction()
+		LEFT,
+		RIGHT,
+		DOWN,
+		DROP,
+		TICK,		// a tick() (during an update())
+		SETTLE,		// an update() that handled a placed shape
+		COUNT
+	};
+
+	// an event (decoded)
+	struct Event {
+		EventType type;
+		std::uint32_t time;			// the time since the previous event (in TIME_UNITS_PER_SECOND)
+	};
+
+	// the state of the game right after a settle, and where the replay continues from it
+	struct Keyframe {
+		std::uint32_t eventOffset;		// the offset (in the replay) of the next event
+		std::uint64_t eventCount;		// the # of events before it
+		std::uint64_t time;				// the time of the last event before it (in TIME_UNITS_PER_SECOND)
+		TetrisEngine::State state;
+	};
+
+	// an entry of the keyframe index
+	struct IndexEntry {
+		std::uint32_t shapesPlaced;		// the # of shapes placed at the keyframe
+		std::uint32_t keyframeOffset;	// the offset (in the replay) of the keyframe
+	};
+
+	// the keyframe index (read from the trailer)
+	struct Index {
+		std::uint32_t interval;			// the # of shapes placed between keyframes
+		std::uint32_t entryCount;
+		std::uint32_t entriesOffset;	// the offset (in the replay) of the first entry
+	};
+
+	// the start of a replay
+	struct Header {
+		std::uint16_t version;
+		std::uint8_t boardWidth;
+		std::uint8_t boardHeight;
+		double maxSecondsPerTick;
+		double minSecondsPerTick;
+		PieceRandomizer::State randomizer;	// the randomizer state at reset()
+	};
+
+	// CONSTANTS
+	static const std::uint32_t MAGIC = 0x4C505254;	// "TRPL" (little endian)
+	static const std::uint16_t VERSION = 1;
+	static const int HEADER_BYTES = 51;				// the size of a version 1 header
+	static const int TYPE_BITS = 3;
+	static const int TIME_UNITS_PER_SECOND = 64;
+	static const int MAX_VARINT_BYTES = 10;
+	static const std::uint32_t INDEX_MAGIC = 0x58505254;	// "TRPX" (little endian)
+	static const int INDEX_ENTRY_BYTES = 8;
+	static const int INDEX_TRAILER_BYTES = 16;
+
+	// return the header of a game about to be played (or just reset) on an engine
+	static Header makeHeader(const TetrisEngine& engine);
+
+	// return true if an engine plays by the rules of a header
+	static bool hasSameRules(const Header& header, const TetrisEngine& engine);
+
+	// append a header to out
+	static void writeHeader(const Header& header, std::vector<std::uint8_t>& out);
+
+	// read a header from the start of data, return the # of bytes it takes
+	//   (0 if it isn't a header of a version this code can read)
+	static std::size_t readHeader(const std::uint8_t* data, std::size_t size, Header& header);
+
+	// append an event to out
+	static void writeEvent(EventType type, std::uint32_t time, std::vector<std::uint8_t>& out);
+
+	// read an event at data (and advance it), return false if the data ends first
+	//   (inline, with readVarint(): they are the inner loop of reading a replay)
+	static bool readEvent(const std::uint8_t*& data, const std::uint8_t* end, Event& event);
+
+	// append a keyframe to out, return false (& append nothing) if a block's content
+	//   can't be stored (outside EMPTY_BLOCK to Gameboard::MAX_CONTENT)
+	static bool writeKeyframe(const Keyframe& keyframe, std::vector<std::uint8_t>& out);
+
+	// read a keyframe at data (of a replay with header), return false if it is
+	//   corrupt or the data ends first
+	static bool readKeyframe(const std::uint8_t* data, const std::uint8_t* end, const Header& header, Keyframe& keyframe);
+
+	// append the keyframe index (entries in order of shapes placed) & the trailer to out,
+	//   where the index starts at entriesOffset in the replay
+	static void writeIndex(const std::vector<IndexEntry>& entries, std::uint32_t interval, std::uint32_t entriesOffset, std::vector<std::uint8_t>& out);
+
+	// read the keyframe index from the trailer at the end of a replay's data
+	//   (whose events start at eventsStart), return false if there is none
+	static bool readIndex(const std::uint8_t* data, std::size_t size, std::size_t eventsStart, Index& index);
+
+	// return entry i (< index.entryCount) of a replay's keyframe index
+	static IndexEntry readIndexEntry(const std::uint8_t* data, const Index& index, std::uint32_t i);
+
+	// append the byteCount low bytes of a value to out, little endian
+	static void writeBytes(std::uint64_t value, int byteCount, std::vector<std::uint8_t>& out);
+
+	// read a little endian value of byteCount bytes at data (and advance it)
+	//   (the caller checks that the data has them)
+	static std::uint64_t readBytes(const std::uint8_t*& data, int byteCount);
+
+	// append an unsigned LEB128 varint to out
+	static void writeVarint(std::uint64_t value, std::vector<std::uint8_t>& out);
+
+	// read a varint at data (and advance it), return false if the data ends first
+	static bool readVarint(const std::uint8_t*& data, const std::uint8_t* end, std::uint64_t& value);
+
+	// return the event type of an action (actions are events of the same value)
+	static EventType toEventType(TetrisEngine::Action action);
+};
+
+// read an event at data (and advance it), return false if the data ends first
+inline bool ReplayFormat::readEvent(const std::uint8_t*& data, const std::uint8_t* end, Event& event)
+{
+	std::uint64_t value;
+	if (!readVarint(data, end, value)) {
+		return false;
+	}
+	event.type = static_cast<EventType>(value & ((1 << TYPE_BITS) - 1));
+	event.time = static_cast<std::uint32_t>(value >> TYPE_BITS);
+	return true;
+}
+
+// read a varint at data (and advance it), return false if the data ends first
+inline bool ReplayFormat::readVarint(const std::uint8_t*& data, const std::uint8_t* end, std::uint64_t& value)
+{
+	// (most events are a single byte)
+	if (data < end && *data < 0x80) {
+		value = *data++;
+		return true;
+	}
+
+	value = 0;
+	for (int i = 0; i < MAX_VARINT_BYTES && data < end; i++) {
+		std::uint8_t byte = *data++;
+		value |= static_cast<std::uint64_t>(byte & 0x7F) << (7 * i);
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif /* REPLAYFORMAT_H */
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include "ReplayPlayer.h"
+
+// load a replay file, return false if it can't be read or isn't a replay
+bool ReplayPlayer::load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		loaded = false;
+		atEnd = true;
+		return false;
+	}
+
+	std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return load(bytes.data(), bytes.size());
+}
+
+// load a replay from memory (the data is copied)
+bool ReplayPlayer::load(const std::uint8_t* bytes, std::size_t size)
+{
+	copy.assign(bytes, bytes + size);
+	return view(copy.data(), copy.size());
+}
+
+// load a replay from memory without copying it
+bool ReplayPlayer::view(const std::uint8_t* bytes, std::size_t size)
+{
+	data = bytes;
+	dataSize = size;
+	eventsStart = ReplayFormat::readHeader(data, dataSize, header);
+	loaded = (eventsStart != 0);
+	if (!loaded || !ReplayFormat::readIndex(data, dataSize, eventsStart, index)) {
+		index = ReplayFormat::Index{};
+	}
+	position = eventsStart;
+	atEnd = !loaded;
+	complete = false;
+	time = 0;
+	eventCount = 0;
+	return loaded;
+}
+
+const ReplayFormat::Header& ReplayPlayer::getHeader() const
+{
+	return header;
+}
+
+// reset an engine to the start of the replay, return false if the engine
+//   doesn't play by the replay's rules
+bool ReplayPlayer::start(TetrisEngine& engine)
+{
+	if (!loaded || !ReplayFormat::hasSameRules(header, engine)) {
+		return false;
+	}
+
+	engine.reset(header.randomizer);
+	position = eventsStart;
+	atEnd = false;
+	complete = false;
+	time = 0;
+	eventCount = 0;
+	return true;
+}
+
+// apply the next event to the engine, return false at the end of the replay
+bool ReplayPlayer::step(TetrisEngine& engine)
+{
+	ReplayFormat::Event event;
+	if (!nextEvent(event)) {
+		return false;
+	}
+
+	switch (event.type) {
+	case ReplayFormat::EventType::TICK:
+		engine.tick();
+		break;
+
+	case ReplayFormat::EventType::SETTLE:
+		engine.settle();
+		break;
+
+	default:
+		engine.applyAction(static_cast<TetrisEngine::Action>(event.type));
+		break;
+	}
+	return true;
+}
+
+// read the next event without applying it, return false at the end of the replay
+bool ReplayPlayer::nextEvent(ReplayFormat::Event& event)
+{
+	if (atEnd) {
+		return false;
+	}
+
+	const std::uint8_t* p = data + position;
+	const std::uint8_t* end = data + dataSize;
+	if (!ReplayFormat::readEvent(p, end, event)) {
+		atEnd = true;	// cut short
+		return false;
+	}
+
+	if (event.type == ReplayFormat::EventType::END) {
+		complete = ReplayFormat::readVarint(p, end, finalShapesPlaced) && ReplayFormat::readVarint(p, end, finalScore);
+		atEnd = true;
+	}
+	else if (event.type == ReplayFormat::EventType::COUNT) {
+		atEnd = true;	// not an event: the data is corrupt
+	}
+
+	position = p - data;
+	time += event.time;
+	if (atEnd) {
+		return false;
+	}
+	eventCount++;
+	return true;
+}
+
+// read up to maxCount next events without applying them, return the # read
+std::size_t ReplayPlayer::nextEvents(ReplayFormat::Event events[], std::size_t maxCount)
+{
+	if (atEnd || maxCount == 0) {
+		return 0;
+	}
+
+	// (a tight loop on locals, up to the event that ends the replay)
+	const std::uint8_t* p = data + position;
+	const std::uint8_t* end = data + dataSize;
+	std::uint64_t elapsed = 0;
+	std::size_t count = 0;
+	for (; count < maxCount; count++) {
+		const std::uint8_t* next = p;
+		ReplayFormat::Event& event = events[count];
+		if (!ReplayFormat::readEvent(next, end, event)
+			|| event.type == ReplayFormat::EventType::END || event.type == ReplayFormat::EventType::COUNT)
+		{
+			break;
+		}
+		p = next;
+		elapsed += event.time;
+	}
+	position = p - data;
+	time += elapsed;
+	eventCount += count;
+
+	// (the next event ends the replay: nextEvent() reads its end)
+	if (count == 0) {
+		ReplayFormat::Event last;
+		nextEvent(last);
+	}
+	return count;
+}
+
+// apply every remaining event to the engine
+void ReplayPlayer::play(TetrisEngine& engine)
+{
+	while (step(engine)) {
+	}
+}
+
+// move the engine to right after the settle of the shapeCount-th shape placed,
+//   from the closest keyframe
+bool ReplayPlayer::seek(TetrisEngine& engine, int shapeCount)
+{
+	if (!start(engine)) {
+		return false;
+	}
+
+	// keyframe i is normally at shape (i + 1) * interval (or later, if the game
+	//   settled a shape without its keyframe being kept)
+	std::uint32_t i = static_cast<std::uint32_t>(std::max(shapeCount, 0)) / std::max(index.interval, 1u);
+	i = std::min(i, index.entryCount);
+	ReplayFormat::IndexEntry entry{};
+	for (; i > 0; i--) {
+		entry = ReplayFormat::readIndexEntry(data, index, i - 1);
+		if (entry.shapesPlaced <= static_cast<std::uint32_t>(shapeCount)) {
+			break;
+		}
+	}
+
+	ReplayFormat::Keyframe keyframe;
+	if (i > 0 && entry.keyframeOffset < dataSize
+		&& ReplayFormat::readKeyframe(data + entry.keyframeOffset, data + dataSize, header, keyframe)
+		&& keyframe.eventOffset >= eventsStart && keyframe.eventOffset < dataSize)
+	{
+		engine.setState(keyframe.state);
+		position = keyframe.eventOffset;
+		eventCount = keyframe.eventCount;
+		time = keyframe.time;
+	}
+
+	while (engine.getShapesPlaced() < shapeCount && step(engine)) {
+	}
+	return true;
+}
+
+std::uint32_t ReplayPlayer::getKeyframeCount() const
+{
+	return index.entryCount;
+}
+
+bool ReplayPlayer::isAtEnd() const
+{
+	return atEnd;
+}
+
+bool ReplayPlayer::isComplete() const
+{
+	return complete;
+}
+
+// return true if the replay is complete and the engine reached its final
+//   # of shapes placed & score
+bool ReplayPlayer::isVerified(const TetrisEngine& engine) const
+{
+	return complete
+		&& static_cast<std::uint64_t>(engine.getShapesPlaced()) == finalShapesPlaced
+		&& static_cast<std::uint64_t>(engine.getScore()) == finalScore;
+}
+
+double ReplayPlayer::getSeconds() const
+{
+	return static_cast<double>(time) / ReplayFormat::TIME_UNITS_PER_SECOND;
+}
+
+std::uint64_t ReplayPlayer::getEventCount() const
+{
+	return eventCount;
+}
@@ -0,0 +1,113 @@
+// The ReplayPlayer plays a recorded game (see ReplayFormat) back through a
+// headless TetrisEngine: it resets the engine to the replay's randomizer state,
+// then applies the replay's events one at a time (an action is an applyAction(),
+// a tick is a tick() and a settle is a settle()).
+//
+// The engine ends up in the same state as the recorded game after every event (but
+// for its clock: the replay's ticks are events of their own, only a seek() to a
+// keyframe restores the clock), so
+// a replay can be watched (step() at the pace of getSeconds()), checked
+// (play() then isVerified()) or analysed, eg: by a bot scoring every placement.
+//
+// A replay with keyframes can be seek()'d to any shape #: the player restores the
+// closest keyframe before it (found in constant time through the replay's index)
+// and only applies the events since, so scrubbing through a long game costs about
+// the same as stepping through a few dozen shapes.
+//
+// A replay that was cut short (the recording program crashed) plays up to where
+// its data ends: it just isn't complete.
+
+#ifndef REPLAYPLAYER_H
+#define REPLAYPLAYER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ReplayFormat.h"
+#include "TetrisEngine.h"
+
+class ReplayPlayer
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	ReplayPlayer() = default;
+	// (not copyable: a loaded replay's data points into the player's own copy)
+	ReplayPlayer(const ReplayPlayer&) = delete;
+	ReplayPlayer& operator=(const ReplayPlayer&) = delete;
+
+	// load a replay file, return false if it can't be read or isn't a replay
+	bool load(const std::string& path);
+	// (same as above) from memory (the data is copied)
+	bool load(const std::uint8_t* data, std::size_t size);
+	// (same as above) without copying the data: it must outlive the player's use
+	//   of it (eg: a replay in a memory mapped ReplayCorpus)
+	bool view(const std::uint8_t* data, std::size_t size);
+
+	// return the header of the loaded replay
+	const ReplayFormat::Header& getHeader() const;
+
+	// reset an engine to the start of the replay, return false if the engine
+	//   doesn't play by the replay's rules (nothing was loaded, or other tick rates)
+	bool start(TetrisEngine& engine);
+
+	// apply the next event to the engine, return false at the end of the replay
+	bool step(TetrisEngine& engine);
+
+	// read the next event without applying it (to scan a replay's events without
+	//   an engine), return false at the end of the replay
+	bool nextEvent(ReplayFormat::Event& event);
+	// (same as above) for up to maxCount events at once, return the # read
+	//   (0 at the end of the replay). The fastest way to scan a replay's events.
+	std::size_t nextEvents(ReplayFormat::Event events[], std::size_t maxCount);
+
+	// apply every remaining event to the engine
+	void play(TetrisEngine& engine);
+
+	// move the engine to right after the settle of the shapeCount-th shape placed
+	//   (the next shape was just spawned), or to the end of the replay if it has
+	//   fewer shapes, from the closest keyframe. Return false if the engine doesn't
+	//   play by the replay's rules
+	bool seek(TetrisEngine& engine, int shapeCount);
+
+	// return the # of keyframes (0 for a replay recorded without them, or cut short)
+	std::uint32_t getKeyframeCount() const;
+
+	// return true once every event was applied
+	bool isAtEnd() const;
+
+	// return true if the replay ended with its END (it wasn't cut short)
+	bool isComplete() const;
+
+	// return true if the replay is complete and the engine reached its final
+	//   # of shapes placed & score
+	bool isVerified(const TetrisEngine& engine) const;
+
+	// return the time of the last event applied (seconds since the game started)
+	double getSeconds() const;
+
+	// return the # of events applied since start()
+	std::uint64_t getEventCount() const;
+
+private:
+	// MEMBER VARIABLES
+
+	const std::uint8_t* data = nullptr;	// the replay (copy's or a view's)
+	std::size_t dataSize = 0;
+	std::vector<std::uint8_t> copy;		// the replay, when it was load()'ed
+	ReplayFormat::Header header{};
+	bool loaded = false;
+	std::size_t eventsStart = 0;		// the offset of the first event
+	std::size_t position = 0;			// the offset of the next event
+	bool atEnd = true;
+	bool complete = false;
+	std::uint64_t finalShapesPlaced = 0;	// (from the end of a complete replay)
+	std::uint64_t finalScore = 0;
+	std::uint64_t time = 0;				// (in ReplayFormat::TIME_UNITS_PER_SECOND)
+	std::uint64_t eventCount = 0;
+	ReplayFormat::Index index{};		// the keyframe index (entryCount is 0 if there is none)
+};
+
+#endif /* REPLAYPLAYER_H */
@@ -0,0 +1,274 @@
+#include <cmath>
+#include <fstream>
+#include "ReplayRecorder.h"
+
+// constructor - start the writer thread
+ReplayRecorder::ReplayRecorder()
+{
+	buffer.reserve(BUFFER_BYTES);
+	writer = std::thread(&ReplayRecorder::writerLoop, this);
+}
+
+// destructor - finish writing everything recorded, stop the writer thread
+ReplayRecorder::~ReplayRecorder()
+{
+	if (recording) {
+		Job close{ Job::Type::CLOSE };
+		queueBuffer(&close);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	jobCondition.notify_one();
+	writer.join();
+}
+
+// start recording the game an engine was just reset for, to a new file
+void ReplayRecorder::start(const std::string& path, const TetrisEngine& engine)
+{
+	if (recording) {
+		stop(engine);
+	}
+
+	// (the writer opens the file when it is woken up for the first buffer)
+	Job open{ Job::Type::OPEN, path };
+	queueJob(open, false);
+
+	recording = true;
+	lastTime = 0;
+	lastTicks = engine.getTicks();
+	lastShapesPlaced = engine.getShapesPlaced();
+	bytesRecorded = 0;
+	eventCount = 0;
+	replayKeyframeInterval = keyframeInterval;
+	keyframes.clear();
+	keyframeIndex.clear();
+
+	std::size_t size = buffer.size();
+	ReplayFormat::writeHeader(ReplayFormat::makeHeader(engine), buffer);
+	bytesRecorded += buffer.size() - size;
+}
+
+// record an action, after it was applied to the engine
+void ReplayRecorder::recordAction(const TetrisEngine& engine, TetrisEngine::Action action)
+{
+	// (the engine ignores actions once the game is over)
+	if (!recording || action == TetrisEngine::Action::NONE || engine.isGameOver()) {
+		return;
+	}
+	writeEvent(ReplayFormat::toEventType(action), engine);
+}
+
+// record the ticks & settle of an update, after it was applied to the engine
+void ReplayRecorder::recordUpdate(const TetrisEngine& engine)
+{
+	if (!recording) {
+		return;
+	}
+
+	// an update ticks (at most once) before it handles a placed shape
+	for (; lastTicks < engine.getTicks(); lastTicks++) {
+		writeEvent(ReplayFormat::EventType::TICK, engine);
+	}
+	if (engine.getShapesPlaced() != lastShapesPlaced) {
+		lastShapesPlaced = engine.getShapesPlaced();
+		writeEvent(ReplayFormat::EventType::SETTLE, engine);
+		if (replayKeyframeInterval > 0 && lastShapesPlaced % replayKeyframeInterval == 0) {
+			writeKeyframe(engine);
+		}
+	}
+}
+
+// end the replay (with the engine's final score & the keyframes) and close its file
+void ReplayRecorder::stop(const TetrisEngine& engine)
+{
+	if (!recording) {
+		return;
+	}
+
+	writeEvent(ReplayFormat::EventType::END, engine);
+	std::size_t size = buffer.size();
+	ReplayFormat::writeVarint(static_cast<std::uint64_t>(engine.getShapesPlaced()), buffer);
+	ReplayFormat::writeVarint(static_cast<std::uint64_t>(engine.getScore()), buffer);
+
+	if (!keyframeIndex.empty()) {
+		std::uint32_t keyframesOffset = static_cast<std::uint32_t>(bytesRecorded + (buffer.size() - size));
+		for (ReplayFormat::IndexEntry& entry : keyframeIndex) {
+			entry.keyframeOffset += keyframesOffset;
+		}
+		buffer.insert(buffer.end(), keyframes.begin(), keyframes.end());
+		ReplayFormat::writeIndex(keyframeIndex, static_cast<std::uint32_t>(replayKeyframeInterval),
+			keyframesOffset + static_cast<std::uint32_t>(keyframes.size()), buffer);
+	}
+	bytesRecorded += buffer.size() - size;
+
+	Job close{ Job::Type::CLOSE };
+	queueBuffer(&close);
+	recording = false;
+}
+
+// set the # of shapes placed between keyframes (0 records no keyframes)
+void ReplayRecorder::setKeyframeInterval(int shapeCount)
+{
+	keyframeInterval = shapeCount;
+}
+
+bool ReplayRecorder::isRecording() const
+{
+	return recording;
+}
+
+// wait until everything recorded so far is in its file
+void ReplayRecorder::flush()
+{
+	queueBuffer();
+	jobCondition.notify_one();	// (in case only an OPEN is waiting)
+
+	std::unique_lock<std::mutex> lock(mutex);
+	idleCondition.wait(lock, [this] { return jobs.empty() && !writing; });
+}
+
+bool ReplayRecorder::hasFailed() const
+{
+	return failed.load();
+}
+
+std::uint64_t ReplayRecorder::getBytesRecorded() const
+{
+	return bytesRecorded;
+}
+
+// Game loop side ================================================
+
+// append an event stamped with the engine's clock
+void ReplayRecorder::writeEvent(ReplayFormat::EventType type, const TetrisEngine& engine)
+{
+	std::uint32_t time = static_cast<std::uint32_t>(std::llround(engine.getElapsedSeconds() * ReplayFormat::TIME_UNITS_PER_SECOND));
+	std::uint32_t elapsed = time >= lastTime ? time - lastTime : 0;
+	lastTime = time;
+
+	std::size_t size = buffer.size();
+	ReplayFormat::writeEvent(type, elapsed, buffer);
+	bytesRecorded += buffer.size() - size;
+	eventCount++;
+
+	if (buffer.size() >= BUFFER_BYTES) {
+		queueBuffer();
+	}
+}
+
+// keep a keyframe of the engine's state (right after a settle): it continues
+//   with the next event to be recorded
+void ReplayRecorder::writeKeyframe(const TetrisEngine& engine)
+{
+	ReplayFormat::Keyframe keyframe;
+	keyframe.eventOffset = static_cast<std::uint32_t>(bytesRecorded);
+	keyframe.eventCount = eventCount;
+	keyframe.time = lastTime;
+	keyframe.state = engine.getState();
+
+	ReplayFormat::IndexEntry entry;
+	entry.shapesPlaced = static_cast<std::uint32_t>(engine.getShapesPlaced());
+	entry.keyframeOffset = static_cast<std::uint32_t>(keyframes.size());
+
+	// (a board the format can't store gets no keyframe: seeks play from an earlier one)
+	if (ReplayFormat::writeKeyframe(keyframe, keyframes)) {
+		keyframeIndex.push_back(entry);
+	}
+}
+
+// hand the buffer to the writer thread (and take a spare one), followed by
+//   another job if there is one
+void ReplayRecorder::queueBuffer(Job* nextJob)
+{
+	if (buffer.empty() && nextJob == nullptr) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!buffer.empty()) {
+			Job write{ Job::Type::WRITE };
+			write.bytes.swap(buffer);
+			jobs.push_back(std::move(write));
+			if (!spareBuffers.empty()) {
+				buffer.swap(spareBuffers.back());
+				spareBuffers.pop_back();
+			}
+		}
+		if (nextJob != nullptr) {
+			jobs.push_back(std::move(*nextJob));
+		}
+	}
+	jobCondition.notify_one();
+
+	buffer.reserve(BUFFER_BYTES);
+}
+
+// add a job to the writer thread's queue, wake it up if it has to act now
+void ReplayRecorder::queueJob(Job& job, bool wakeWriter)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(std::move(job));
+	}
+	if (wakeWriter) {
+		jobCondition.notify_one();
+	}
+}
+
+// Writer thread =================================================
+
+// the body of the writer thread: do the jobs, in order, until stopped
+void ReplayRecorder::writerLoop()
+{
+	std::ofstream file;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+		jobCondition.wait(lock, [this] { return stopping || !jobs.empty(); });
+		if (jobs.empty()) {
+			return;		// stopping, and everything is written
+		}
+
+		Job job = std::move(jobs.front());
+		jobs.pop_front();
+		writing = true;
+		lock.unlock();
+
+		switch (job.type) {
+		case Job::Type::OPEN:
+			file.open(job.path, std::ios::binary | std::ios::trunc);
+			if (!file) {
+				failed = true;
+			}
+			break;
+
+		case Job::Type::WRITE:
+			if (file.is_open()) {
+				file.write(reinterpret_cast<const char*>(job.bytes.data()), static_cast<std::streamsize>(job.bytes.size()));
+				if (!file) {
+					failed = true;
+				}
+			}
+			break;
+
+		case Job::Type::CLOSE:
+			file.close();
+			file.clear();
+			break;
+		}
+
+		lock.lock();
+		writing = false;
+		if (job.type == Job::Type::WRITE) {
+			job.bytes.clear();
+			spareBuffers.push_back(std::move(job.bytes));
+		}
+		if (jobs.empty()) {
+			idleCondition.notify_all();
+		}
+	}
+}
@@ -0,0 +1,142 @@
+// The ReplayRecorder records games to replay files (see ReplayFormat), eg: to
+// reproduce a bug report, or to study how a game was lost.
+//
+// The game calls it after each thing that can change the game: recordAction()
+// after an applyAction(), and recordUpdate() after an update() (which finds the
+// ticks & settles from the engine's counters). An event is appended to a memory
+// buffer as a 1 or 2 byte varint, so recording costs the game loop a few
+// instructions per event.
+//
+// Every KEYFRAME_INTERVAL shapes placed (see setKeyframeInterval()), the recorder
+// also keeps a keyframe of the game's state; stop() appends them, with their index,
+// after the END so a player can seek through the replay.
+//
+// The file itself is written by the recorder's own writer thread: full buffers
+// (and the opening & closing of files) are handed to it through a queue, and empty
+// buffers come back to be reused. The game loop never waits on the disk: it only
+// takes the queue's lock when a buffer fills up (every few KB) or a replay starts
+// or stops.
+
+#ifndef REPLAYRECORDER_H
+#define REPLAYRECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ReplayFormat.h"
+#include "TetrisEngine.h"
+
+class ReplayRecorder
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// CONSTANTS
+	static const int BUFFER_BYTES = 4096;	// the size of the buffers handed to the writer thread
+	static const int KEYFRAME_INTERVAL = 32;// the default # of shapes placed between keyframes
+
+	// constructor - start the writer thread
+	ReplayRecorder();
+	// destructor - finish writing everything recorded, stop the writer thread
+	//   (a replay that wasn't stopped is left without its END)
+	~ReplayRecorder();
+
+	ReplayRecorder(const ReplayRecorder&) = delete;
+	ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+	// start recording the game an engine was just reset for, to a new file
+	//   (stops the replay being recorded, if any, first)
+	void start(const std::string& path, const TetrisEngine& engine);
+
+	// record an action, after it was applied to the engine
+	void recordAction(const TetrisEngine& engine, TetrisEngine::Action action);
+
+	// record the ticks & settle of an update, after it was applied to the engine
+	void recordUpdate(const TetrisEngine& engine);
+
+	// end the replay (with the engine's final score) and close its file
+	void stop(const TetrisEngine& engine);
+
+	// set the # of shapes placed between keyframes (0 records no keyframes)
+	//   for the replays started after this call
+	void setKeyframeInterval(int shapeCount);
+
+	// return true between start() and stop()
+	bool isRecording() const;
+
+	// wait until everything recorded so far is in its file
+	void flush();
+
+	// return true if a file couldn't be opened or written
+	bool hasFailed() const;
+
+	// return the # of bytes recorded for the current (or last) replay
+	std::uint64_t getBytesRecorded() const;
+
+private:
+	// a request to the writer thread
+	struct Job {
+		enum class Type { OPEN, WRITE, CLOSE };
+
+		// constructor - a job of a type (& the file to open, for OPEN)
+		explicit Job(Type type, const std::string& path = std::string())
+			: type(type), path(path)
+		{
+		}
+
+		Type type;
+		std::string path;					// (OPEN)
+		std::vector<std::uint8_t> bytes;	// (WRITE)
+	};
+
+	// append an event stamped with the engine's clock
+	void writeEvent(ReplayFormat::EventType type, const TetrisEngine& engine);
+
+	// keep a keyframe of the engine's state (right after a settle)
+	void writeKeyframe(const TetrisEngine& engine);
+
+	// hand the buffer to the writer thread (and take a spare one), followed by
+	//   another job if there is one (one lock & wake up for both)
+	void queueBuffer(Job* nextJob = nullptr);
+
+	// add a job to the writer thread's queue, wake it up if it has to act now
+	void queueJob(Job& job, bool wakeWriter);
+
+	// the body of the writer thread: do the jobs, in order, until stopped
+	void writerLoop();
+
+	// MEMBER VARIABLES
+
+	// game loop side
+	bool recording = false;
+	std::vector<std::uint8_t> buffer;		// the events not yet handed to the writer
+	std::uint32_t lastTime = 0;				// the engine's clock at the last event (in time units)
+	int lastTicks = 0;						// the engine's counters at the last recordUpdate()
+	int lastShapesPlaced = 0;
+	std::uint64_t bytesRecorded = 0;
+	std::uint64_t eventCount = 0;			// the # of events recorded (END included)
+	int keyframeInterval = KEYFRAME_INTERVAL;
+	int replayKeyframeInterval = 0;			// (the interval of the replay being recorded)
+	std::vector<std::uint8_t> keyframes;	// the keyframes of the replay (appended by stop())
+	std::vector<ReplayFormat::IndexEntry> keyframeIndex;	// (offsets from the start of keyframes)
+
+	// shared with the writer thread
+	std::mutex mutex;
+	std::condition_variable jobCondition;	// a job was queued (or stopping)
+	std::condition_variable idleCondition;	// the queue is empty & nothing is being written
+	std::deque<Job> jobs;
+	std::vector<std::vector<std::uint8_t>> spareBuffers;
+	bool writing = false;
+	bool stopping = false;
+	std::atomic<bool> failed{ false };
+
+	std::thread writer;						// (started last, by the constructor)
+};
+
+#endif /* REPLAYRECORDER_H */
@@ -0,0 +1,43 @@
+#include <algorithm>
+#include <SFML/System/Sleep.hpp>
+#include "SimulationThread.h"
+
+// constructor - start running the game loop
+SimulationThread::SimulationThread(TetrisGame& game, InputThread& input, const sf::Clock& gameClock)
+	: game(game), input(input), clock(gameClock), thread(&SimulationThread::run, this)
+{
+}
+
+// destructor - stop the thread (after the game loop in progress)
+SimulationThread::~SimulationThread()
+{
+	running = false;
+	thread.join();
+}
+
+// the body of the thread: run the game loop until the destructor stops it
+//   (the loops are scheduled a step apart, so a late wake up doesn't delay the next ones)
+void SimulationThread::run()
+{
+	InputThread::KeyPress press;
+	double nextLoop = InputThread::getSeconds(clock);
+
+	while (running) {
+		// handle the key presses since the last game loop (at the time they happened)
+		FrameTimings::Clock::time_point inputStart = FrameTimings::now();
+		while (input.pop(press)) {
+			game.onKeyPressed(press.key, press.time);
+		}
+		game.getTimings().record(FrameTimings::Phase::INPUT, inputStart);
+		game.getTimings().setDroppedInputCount(input.getDroppedCount());
+
+		game.processGameLoop(InputThread::getSeconds(clock));
+
+		// (after a stall, start the schedule again rather than run the missed loops)
+		double now = InputThread::getSeconds(clock);
+		nextLoop = std::max(nextLoop + TetrisGame::SIMULATION_STEP_SECONDS, now - TetrisGame::SIMULATION_STEP_SECONDS);
+		if (nextLoop > now) {
+			sf::sleep(sf::microseconds(static_cast<sf::Int64>((nextLoop - now) * 1000000.0)));
+		}
+	}
+}
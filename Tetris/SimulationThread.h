@@ -0,0 +1,48 @@
+// The SimulationThread runs a TetrisGame's game loop on a thread of its own, so the
+// game's timing doesn't depend on the window's: a slow frame (eg: window.display()
+// waiting for vsync, or a long draw) no longer delays the key presses, ticks & bot.
+//
+// - About every SIMULATION_STEP_SECONDS, the thread takes the key presses from the
+//   InputThread (see TetrisGame::onKeyPressed()) and calls TetrisGame::processGameLoop(),
+//   which publishes a frame (a snapshot of what is shown) through a TripleBuffer.
+// - The render thread (the window's) only calls TetrisGame::draw(), which draws the
+//   latest frame published: the two threads share no other state, and no locks.
+// - The game, the input thread & the clock must outlive this thread (declare it after them).
+
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include <atomic>
+#include <thread>
+#include <SFML/System/Clock.hpp>
+#include "InputThread.h"
+#include "TetrisGame.h"
+
+class SimulationThread
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// constructor - start running the game loop
+	//   gameClock: the clock the key presses are timed with (see InputThread())
+	SimulationThread(TetrisGame& game, InputThread& input, const sf::Clock& gameClock);
+
+	// destructor - stop the thread (after the game loop in progress)
+	~SimulationThread();
+
+	SimulationThread(const SimulationThread&) = delete;
+	SimulationThread& operator=(const SimulationThread&) = delete;
+
+private:
+	// the body of the thread: run the game loop until the destructor stops it
+	void run();
+
+	// MEMBER VARIABLES
+	TetrisGame& game;
+	InputThread& input;
+	const sf::Clock& clock;
+	std::atomic<bool> running{ true };
+	std::thread thread;					// (last: it starts once the members above are ready)
+};
+
+#endif /* SIMULATIONTHREAD_H */
@@ -25,22 +25,38 @@
 
 
 #include <SFML/Graphics.hpp>
+#include <cstdlib>
 #include <iostream>
+#include <random>
 #include <stdio.h>      /* printf, NULL */
-#include <stdlib.h>     /* srand, rand */
 #include <time.h>       /* time */
+#include <string.h>     /* strcmp */
 #include "TetrisGame.h"
+#include "InputThread.h"
+#include "SimulationThread.h"
 #include "TestSuite.h"
+#include "Benchmark.h"
 
 
-int main()
+int main(int argc, char* argv[])
 {
-	// seed randomizer
-	srand(time(NULL));
-
 	// run some sanity tests on our classes to ensure they're working as expected.
 	TestSuite::runTestSuite();
 
+	// "--benchmark": measure the headless simulation throughput instead of playing
+	if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+		Benchmark::runBenchmarks();
+		return 0;
+	}
+
+	// "... --timings <path>" (after any other arguments): measure the game's loops &
+	//   frames, & write the histograms to path on exit (the T key shows them in an overlay)
+	const char* timingsPath = nullptr;
+	if (argc > 2 && strcmp(argv[argc - 2], "--timings") == 0) {
+		timingsPath = argv[argc - 1];
+		argc -= 2;
+	}
+
 	sf::Sprite blockSprite;			// the tetromino block sprite
 	sf::Texture blockTexture;		// the tetromino block texture
 	sf::Sprite backgroundSprite;	// the background sprite
@@ -53,64 +69,103 @@ int main()
 	blockTexture.loadFromFile("Images/tiles.png");	// load the tetris block sprite
 	blockSprite.setTexture(blockTexture);
 
-	// create the game window
-	sf::RenderWindow window(sf::VideoMode(640, 800), "Tetris Game Window");
+	// "--versus <local port> <remote address> <remote port> [latency ms] [jitter ms]":
+	//   play versus a remote player over UDP, eg: on one machine, in 2 windows:
+	//   Tetris.exe --versus 5000 127.0.0.1 5001   &   Tetris.exe --versus 5001 127.0.0.1 5000
+	//   (the optional latency & jitter delay the packets sent, to try a slow network)
+	bool versus = argc > 4 && strcmp(argv[1], "--versus") == 0;
+	VersusConnection connection;
+	if (versus) {
+		if (!connection.open(static_cast<unsigned short>(atoi(argv[2])), argv[3], static_cast<unsigned short>(atoi(argv[4])))) {
+			std::cout << "Could not open the versus connection" << std::endl;
+			return 1;
+		}
+		if (argc > 5) {
+			LatencySimulator::Settings settings;
+			settings.latencySeconds = atof(argv[5]) / 1000.0;
+			settings.jitterSeconds = (argc > 6) ? atof(argv[6]) / 1000.0 : 0.0;
+			settings.seed = static_cast<std::uint64_t>(time(NULL));
+			connection.setSimulatedLatency(settings);
+		}
+	}
+
+	// create the game window (twice as wide for a versus game: the remote player's game on the right)
+	const int WINDOW_WIDTH = 640;
+	sf::RenderWindow window(sf::VideoMode(versus ? WINDOW_WIDTH * 2 : WINDOW_WIDTH, 800), "Tetris Game Window");
 
 	window.setFramerateLimit(30);				// set a max framerate of 30 FPS
 
 	const Point gameboardOffset{ 54, 125 };		// the pixel offset of the top left of the gameboard 
 	const Point nextShapeOffset{ 490, 210 };	// the pixel offset of the next shape Tetromino
 
-	// set up a tetris game
-	TetrisGame game(window, blockSprite, gameboardOffset, nextShapeOffset);
+	// set up a tetris game (seeded from the clock, so each run plays a different sequence)
+	TetrisGame game(window, blockSprite, gameboardOffset, nextShapeOffset, static_cast<std::uint64_t>(time(NULL)));
+
+	// "--record <path prefix>": record every game to a replay file, eg:
+	//   Tetris.exe --record replays/game-   (writes replays/game-1.replay, game-2.replay, ...)
+	if (argc > 2 && strcmp(argv[1], "--record") == 0) {
+		game.startRecording(argv[2]);
+	}
+
+	if (versus) {
+		std::random_device device;
+		std::uint64_t nonce = (static_cast<std::uint64_t>(device()) << 32 | device()) ^ static_cast<std::uint64_t>(time(NULL));
+		game.startVersus(connection, Point{ gameboardOffset.getX() + WINDOW_WIDTH, gameboardOffset.getY() },
+			Point{ nextShapeOffset.getX() + WINDOW_WIDTH, nextShapeOffset.getY() }, nonce);
+	}
+
+	if (timingsPath) {
+		game.getTimings().setEnabled(true);
+	}
 
-	// set up a clock so we can determine seconds per game loop
+	// set up the game clock (never restarted: the game loops & key presses are timed on it)
 	sf::Clock clock;
 
+	// watch the keyboard on a thread of its own, so each key press is timed when it
+	//   happens rather than when the game loop next runs
+	InputThread input(clock);
+
+	// run the game loop on a thread of its own, so a slow frame (eg: display() waiting)
+	//   doesn't delay the game: this thread only draws the latest frame the game published
+	SimulationThread simulation(game, input, clock);
+
 	// create an event for handling userInput from the GUI (graphical user interface)
 	sf::Event guiEvent;
 
-	// the main game loop
+	// the render loop (the game loop runs on the simulation thread)
 	while (window.isOpen())
 	{
-		// handle any window or keyboard events that have occured since the last game loop
+		// handle any window events that have occured since the last frame
 		while (window.pollEvent(guiEvent))
 		{
 			if (guiEvent.type == sf::Event::Closed)	// handle close button clicked
 			{
 				window.close();
 			}
-			else if (guiEvent.type == sf::Event::KeyPressed) // handle key press
+			else if (guiEvent.type == sf::Event::GainedFocus || guiEvent.type == sf::Event::LostFocus)
 			{
-				game.onKeyPressed(guiEvent);
+				input.setFocused(guiEvent.type == sf::Event::GainedFocus);
 			}
 		}
 
-		// how long since the last loop (fraction of a second)		
-		float elapsedTime = clock.getElapsedTime().asSeconds();
-		clock.restart();
-
-		// handle any window or keyboard events that have occured since the last game loop
-		sf::Event event;
-		while (window.pollEvent(event))
-		{
-			if (event.type == sf::Event::Closed)
-			{
-				window.close();
-			}
-			else if (event.type == sf::Event::KeyPressed)
-			{
-				game.onKeyPressed(event);	// handle key press
-			}
-		}
-
-		game.processGameLoop(elapsedTime);	// handle tetris game logic in here.
-
 		// Draw the game to the screen
 		window.clear(sf::Color::White);	// clear the entire window
 		window.draw(backgroundSprite);	// draw the background (onto the window) 				
+		if (versus) {
+			// (the remote player's half of the window)
+			backgroundSprite.setPosition(WINDOW_WIDTH, 0);
+			window.draw(backgroundSprite);
+			backgroundSprite.setPosition(0, 0);
+		}
 		game.draw();					// draw the game (onto the window)
+
+		FrameTimings::Clock::time_point presentStart = FrameTimings::now();
 		window.display();				// re-display the entire window
+		game.onFramePresented(presentStart, InputThread::getSeconds(clock));
+	}
+
+	if (timingsPath && !game.getTimings().writeToFile(timingsPath)) {
+		std::cout << "Could not write the timings to " << timingsPath << std::endl;
 	}
 
 	return 0;
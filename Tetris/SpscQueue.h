@@ -0,0 +1,90 @@
+// The SpscQueue passes items from one thread (the producer) to one other thread
+// (the consumer) without locks, eg: the key presses of the InputThread to the game loop.
+//
+// It is a fixed size ring buffer: the producer only writes the tail and the consumer
+// only writes the head, so each side is a load, a copy and a store (release/acquire
+// ordering makes the copied item visible before the index that publishes it).
+// Neither side ever waits: push() fails when the queue is full, pop() when it is empty.
+// The head and tail are on cache lines of their own, so the two threads don't slow
+// each other down by writing to the same line.
+//
+// (a template: the whole class is in this header)
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+template <typename T>
+class SpscQueue
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// MEMBER FUNCTIONS
+
+	// constructor - room for capacity items (rounded up to a power of 2)
+	explicit SpscQueue(std::size_t capacity)
+	{
+		std::size_t size = 2;
+		while (size < capacity) {
+			size *= 2;
+		}
+		slots.resize(size);
+		mask = size - 1;
+	}
+
+	// (producer) add an item at the tail, return false if the queue is full
+	bool push(const T& item)
+	{
+		std::size_t tailIndex = tail.index.load(std::memory_order_relaxed);
+		if (tailIndex - head.index.load(std::memory_order_acquire) > mask) {
+			return false;
+		}
+
+		slots[tailIndex & mask] = item;
+		tail.index.store(tailIndex + 1, std::memory_order_release);
+		return true;
+	}
+
+	// (consumer) take the item at the head, return false if the queue is empty
+	bool pop(T& item)
+	{
+		std::size_t headIndex = head.index.load(std::memory_order_relaxed);
+		if (headIndex == tail.index.load(std::memory_order_acquire)) {
+			return false;
+		}
+
+		item = slots[headIndex & mask];
+		head.index.store(headIndex + 1, std::memory_order_release);
+		return true;
+	}
+
+	// return the # of items the queue can hold
+	std::size_t getCapacity() const
+	{
+		return slots.size();
+	}
+
+private:
+	// CONSTANTS
+	static const int CACHE_LINE_SIZE = 64;
+
+	// an index that only one of the threads writes (the # of items pushed, or popped),
+	//   padded to its own cache line
+	struct Index {
+		std::atomic<std::size_t> index{ 0 };
+		char padding[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+	};
+
+	// MEMBER VARIABLES
+	std::vector<T> slots;	// the ring buffer
+	std::size_t mask;		// (slots.size() - 1)
+	Index head;				// the next item to pop (written by the consumer)
+	Index tail;				// the next item to push (written by the producer)
+};
+
+#endif /* SPSCQUEUE_H */
@@ -2,10 +2,33 @@
 #define TESTSUITE_H
 
 #include <vector>
+#include <algorithm>
 #include <assert.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <thread>
 #include "Point.h"
 #include "Tetromino.h"
 #include "GridTetromino.h"
+#include "TetrisEngine.h"
+#include "PieceRandomizer.h"
+#include "BatchEngine.h"
+#include "ParallelGameRunner.h"
+#include "PlacementEnumerator.h"
+#include "BoardFeatures.h"
+#include "BeamSearchBot.h"
+#include "TranspositionTable.h"
+#include "ReplayCorpus.h"
+#include "ReplayCorpusWriter.h"
+#include "ReplayFormat.h"
+#include "ReplayPlayer.h"
+#include "ReplayRecorder.h"
+#include "LatencySimulator.h"
+#include "VersusSession.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include "FrameTimings.h"
 
 
 #ifdef GAMEBOARD_H
@@ -29,7 +52,21 @@ public:
 
 #ifdef GAMEBOARD_H
 		TestSuite::testGameboardClass();
+		TestSuite::testBoardFeaturesClass();
 #endif
+		TestSuite::testPieceRandomizerClass();
+		TestSuite::testTetrisEngineClass();
+		TestSuite::testBatchEngineClass();
+		TestSuite::testParallelGameRunnerClass();
+		TestSuite::testPlacementEnumeratorClass();
+		TestSuite::testBeamSearchBotClass();
+		TestSuite::testTranspositionTableClass();
+		TestSuite::testReplayClasses();
+		TestSuite::testReplayCorpusClasses();
+		TestSuite::testVersusSessionClass();
+		TestSuite::testSpscQueueClass();
+		TestSuite::testTripleBufferClass();
+		TestSuite::testFrameTimingsClasses();
 
 		std::cout << "TestSuite complete -----------------------" << "\n";
 		return true;
@@ -59,10 +96,19 @@ public:
 
 
 		// test getBlockLocsMappedToGrid()
-		gt.blockLocs = { Point(1,2) };
+		gt.setShape(Tetromino::TetShape::I);	// I blocks: [0,0] [0,-1] [0,1] [0,2]
 		gt.setGridLoc(5, 5);
-		std::vector<Point> locs = gt.getBlockLocsMappedToGrid();
-		assert(locs[0].getX() == 6 && locs[0].getY() == 7);
+		Tetromino::BlockLocs locs = gt.getBlockLocsMappedToGrid();
+		assert(locs[3].getX() == 5 && locs[3].getY() == 7);
+
+		// test getRowMasksMappedToGrid() & getMappedTopRow()
+		Gameboard::RowMask masks[Tetromino::BLOCK_COUNT];
+		assert(gt.getRowMasksMappedToGrid(masks) == 4);	// a vertical I covers 4 rows
+		assert(gt.getMappedTopRow() == 4);
+		assert(masks[0] == (1 << 5) && masks[3] == (1 << 5));
+		gt.rotateClockwise();	// horizontal I: [-1,0] [0,0] [1,0] [2,0]
+		assert(gt.getRowMasksMappedToGrid(masks) == 1 && gt.getMappedTopRow() == 5);
+		assert(masks[0] == ((1 << 4) | (1 << 5) | (1 << 6) | (1 << 7)));
 
 
 		std::cout << "passed!" << "\n";
@@ -94,36 +140,55 @@ public:
 			t.getShape() == Tetromino::TetShape::T &&
 			"default Tetromino not initialized to valid shape.");
 
-		assert(t.blockLocs.size() == Constants::BLOCK_COUNT &&
+		assert(t.getBlockLocs().size() == Constants::BLOCK_COUNT &&
 			"default Tetromino has no blockLocs - likely because no default set in constructor");
 
 		t.setShape(Tetromino::TetShape::S);
-		assert(t.blockLocs.size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
+		assert(t.getBlockLocs().size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
 		t.setShape(Tetromino::TetShape::Z);
-		assert(t.blockLocs.size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
+		assert(t.getBlockLocs().size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
 		t.setShape(Tetromino::TetShape::L);
-		assert(t.blockLocs.size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
+		assert(t.getBlockLocs().size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
 		t.setShape(Tetromino::TetShape::J);
-		assert(t.blockLocs.size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
+		assert(t.getBlockLocs().size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
 		t.setShape(Tetromino::TetShape::O);
-		assert(t.blockLocs.size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
+		assert(t.getBlockLocs().size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
 		t.setShape(Tetromino::TetShape::I);
-		assert(t.blockLocs.size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
+		assert(t.getBlockLocs().size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
 		t.setShape(Tetromino::TetShape::T);
-		assert(t.blockLocs.size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
+		assert(t.getBlockLocs().size() == Constants::BLOCK_COUNT && "Tetromino shape size should be 4");
 
 
-		// test the rotate functionality of a single block
-		t.blockLocs.clear();
-		t.blockLocs.push_back(Point(1, 2));
+		// test the rotate functionality of a single block (the L's [1,-1] block)
+		t.setShape(Tetromino::TetShape::L);
+		assert(t.getRotation() == 0);
 		t.rotateClockwise();
-		assert(t.blockLocs[0].getX() == 2 && t.blockLocs[0].getY() == -1 && "Tetromino::rotateCW() failed");
+		assert(t.getBlockLocs()[3].getX() == -1 && t.getBlockLocs()[3].getY() == -1 && "Tetromino::rotateCW() failed");
 		t.rotateClockwise();
-		assert(t.blockLocs[0].getX() == -1 && t.blockLocs[0].getY() == -2 && "Tetromino::rotateCW() failed");
+		assert(t.getBlockLocs()[3].getX() == -1 && t.getBlockLocs()[3].getY() == 1 && "Tetromino::rotateCW() failed");
 		t.rotateClockwise();
-		assert(t.blockLocs[0].getX() == -2 && t.blockLocs[0].getY() == 1 && "Tetromino::rotateCW() failed");
+		assert(t.getBlockLocs()[3].getX() == 1 && t.getBlockLocs()[3].getY() == 1 && "Tetromino::rotateCW() failed");
 		t.rotateClockwise();
-		assert(t.blockLocs[0].getX() == 1 && t.blockLocs[0].getY() == 2 && "Tetromino::rotateCW() failed");
+		assert(t.getBlockLocs()[3].getX() == 1 && t.getBlockLocs()[3].getY() == -1 && "Tetromino::rotateCW() failed");
+		assert(t.getRotation() == 0 && "4 rotations should return to the spawn orientation");
+
+		// test that every precomputed orientation matches rotating each block
+		// 90 degrees clockwise with Point (swapXY() then multiplyY(-1))
+		for (int shape = 0; shape < (int)Tetromino::TetShape::COUNT; shape++) {
+			t.setShape((Tetromino::TetShape)shape);
+			Tetromino::BlockLocs expected = t.getBlockLocs();
+			for (int rotation = 1; rotation < Tetromino::ROTATION_COUNT; rotation++) {
+				t.rotateClockwise();
+				for (int i = 0; i < Tetromino::BLOCK_COUNT; i++) {
+					expected[i].swapXY();
+					expected[i].multiplyY(-1);
+					assert(t.getBlockLocs()[i].getX() == expected[i].getX()
+						&& t.getBlockLocs()[i].getY() == expected[i].getY() && "TetrominoTable rotation mismatch");
+				}
+			}
+		}
+		t.setRotation(-1);
+		assert(t.getRotation() == Tetromino::ROTATION_COUNT - 1 && "Tetromino::setRotation() should wrap");
 
 		std::cout << "passed!" << "\n";
 		return true;
@@ -221,6 +286,13 @@ public:
 		g.setContent(Point(0, 0), 5);
 		assert(g.getContent(0, 0) == 5);
 
+		// the largest content is kept whole (& hashed as kept)
+		std::uint64_t hashBefore = g.getHash();
+		g.setContent(0, 0, Gameboard::MAX_CONTENT);
+		assert(g.getContent(0, 0) == Gameboard::MAX_CONTENT);
+		g.setContent(0, 0, 5);
+		assert(g.getHash() == hashBefore);
+
 		// test setContent(std::vector<Point> locs, int content);
 		std::vector<Point> pointsToSet = { Point(0,0), Point(1,1) };
 		g.setContent(pointsToSet, 4);
@@ -327,6 +399,24 @@ public:
 		assert(g.getContent(1, 3) == 2);	// row 2 copied into row 3
 		assert(g.getContent(1, 4) == Gameboard::EMPTY_BLOCK);	// row 4 is still empty
 
+		// test removeCompletedRows() with a 4 row clear split around surviving rows
+		g.empty();
+		for (int y = 10; y < Gameboard::MAX_Y; y++) {
+			g.fillRow(y, y - 10);
+		}
+		g.setContent(0, 11, Gameboard::EMPTY_BLOCK);	// rows 11, 13 & 16 survive
+		g.setContent(0, 13, Gameboard::EMPTY_BLOCK);
+		g.setContent(0, 16, Gameboard::EMPTY_BLOCK);
+		int clearedRows[Gameboard::MAX_Y];
+		assert(g.removeCompletedRows(clearedRows) == 6);
+		assert(clearedRows[0] == 10 && clearedRows[1] == 12 && clearedRows[2] == 14
+			&& clearedRows[3] == 15 && clearedRows[4] == 17 && clearedRows[5] == 18); // reported top to bottom
+		assert(g.getContent(1, 16) == 1 && g.getContent(1, 17) == 3 && g.getContent(1, 18) == 6);
+		assert(g.getContent(0, 18) == Gameboard::EMPTY_BLOCK && g.getRowMask(18) == (Gameboard::FULL_ROW_MASK & ~1));
+		for (int y = 0; y < 16; y++) {
+			assert(g.getRowMask(y) == 0);	// everything above the survivors is empty
+		}
+
 
 		// test areLocsEmpty()
 		g.empty();
@@ -339,6 +429,86 @@ public:
 		testPoints.push_back(Point(2, 2));
 		assert(g.areLocsEmpty(testPoints) == false);  // should return false since 2,2 contains content 2
 
+		// test getRowMask() & areRowMasksEmpty()
+		g.empty();
+		assert(g.getRowMask(0) == 0);
+		g.setContent(3, 5, 1);
+		g.setContent(4, 5, 1);
+		assert(g.getRowMask(5) == ((1 << 3) | (1 << 4)));	// are both bits set?
+		g.setContent(3, 5, Gameboard::EMPTY_BLOCK);
+		assert(g.getRowMask(5) == (1 << 4));	// did clearing a cell clear its bit?
+		assert(g.getRowMask(-1) == 0 && g.getRowMask(Gameboard::MAX_Y) == 0); // rows off the grid are empty
+		Gameboard::RowMask masks[] = { (1 << 4), (1 << 4) };
+		assert(g.areRowMasksEmpty(3, masks, 2) == true);	// rows 3 & 4 are empty
+		assert(g.areRowMasksEmpty(4, masks, 2) == false);	// row 5 overlaps at column 4
+		assert(g.areRowMasksEmpty(-2, masks, 2) == true);	// rows above the grid are disregarded
+		g.fillRow(6, 1);
+		assert(g.getRowMask(6) == Gameboard::FULL_ROW_MASK);
+		g.copyRowIntoRow(6, 7);
+		assert(g.getRowMask(7) == Gameboard::FULL_ROW_MASK);	// did the mask get copied with the row?
+		g.removeCompletedRows();
+		assert(g.getRowMask(5) == 0 && g.getRowMask(7) == (1 << 4));	// did row 5 move down two rows?
+
+		// test getHash() & getOccupancyHash()
+		g.empty();
+		assert(g.getHash() == 0 && g.getOccupancyHash() == 0);	// an empty board hashes to 0
+		g.setContent(3, 4, 2);
+		std::uint64_t oneBlockHash = g.getHash();
+		assert(oneBlockHash != 0 && g.getOccupancyHash() != 0);
+		g.setContent(3, 4, 5);
+		assert(g.getHash() != oneBlockHash);	// a color change changes the hash...
+		std::uint64_t oneBlockOccupancy = g.getOccupancyHash();
+		g.setContent(3, 4, 2);
+		assert(g.getHash() == oneBlockHash && g.getOccupancyHash() == oneBlockOccupancy);	// ...but not the occupancy
+		g.setContent(3, 4, Gameboard::EMPTY_BLOCK);
+		assert(g.getHash() == 0 && g.getOccupancyHash() == 0);
+		g.setContent(3, 5, 2);
+		assert(g.getHash() != oneBlockHash);	// the same block in a different row
+		g.setContent(3, 5, Gameboard::EMPTY_BLOCK);
+		g.setContent(4, 4, 2);
+		assert(g.getHash() != oneBlockHash);	// the same block in a different column
+
+		// hashes are kept in sync by fillRow(), copyRowIntoRow() & removeCompletedRows():
+		// build a board by row operations, and the same board cell by cell
+		g.empty();
+		g.setContent(1, 10, 3);
+		g.setContent(2, 12, 4);
+		g.fillRow(11, 6);
+		g.fillRow(14, 1);
+		g.copyRowIntoRow(10, 13);
+		g.setContent(9, 15, 2);
+		g.fillRow(17, 0);
+		g.removeCompletedRows();	// removes rows 11, 14 & 17
+		Gameboard expected;
+		expected.setContent(1, 13, 3);	// row 10 moved down 3 rows
+		expected.setContent(2, 14, 4);	// row 12 moved down 2 rows
+		expected.setContent(1, 15, 3);	// row 13 moved down 2 rows
+		expected.setContent(9, 16, 2);	// row 15 moved down 1 row
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			for (int x = 0; x < Gameboard::MAX_X; x++) {
+				assert(g.getContent(x, y) == expected.getContent(x, y));
+			}
+		}
+		assert(g.getHash() == expected.getHash() && g.getOccupancyHash() == expected.getOccupancyHash());
+		expected.setContent(9, 16, 4);
+		assert(g.getHash() != expected.getHash() && g.getOccupancyHash() == expected.getOccupancyHash());
+
+		// every change to the grid changes its version (and nothing else does)
+		std::uint32_t version = expected.getVersion();
+		expected.setContent(9, 16, 4);
+		expected.areLocsEmpty(std::vector<Point>{ Point(9, 16) });
+		assert(expected.getVersion() == version && "unchanged content, unchanged version");
+		expected.setContent(9, 16, Gameboard::EMPTY_BLOCK);
+		assert(expected.getVersion() != version);
+		version = expected.getVersion();
+		expected.fillRow(Gameboard::MAX_Y - 1, 2);
+		assert(expected.getVersion() != version);
+		version = expected.getVersion();
+		assert(expected.removeCompletedRows() == 1 && expected.getVersion() != version);
+		version = expected.getVersion();
+		expected.insertGarbageRows(1, 0, 3);
+		assert(expected.getVersion() != version);
+
 		// lastly do a visual printout of an empty board
 		g.empty();
 		g.printToConsole();
@@ -357,8 +527,1406 @@ public:
 		std::cout << "passed!" << "\n";
 		return true;
 	}
+
+	// check a board's features against a scan of every cell
+	static bool areFeaturesCorrect(const Gameboard& g)
+	{
+		const BoardFeatures& f = g.getFeatures();
+		int heights[Gameboard::MAX_X];
+		int aggregateHeight = 0, maxHeight = 0, holes = 0, bumpiness = 0, wellDepth = 0;
+
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			heights[x] = 0;
+			int columnHoles = 0;
+			for (int y = Gameboard::MAX_Y - 1; y >= 0; y--) {
+				if (g.getContent(x, y) != Gameboard::EMPTY_BLOCK) {
+					heights[x] = Gameboard::MAX_Y - y;
+				}
+			}
+			for (int y = Gameboard::MAX_Y - heights[x]; y < Gameboard::MAX_Y; y++) {
+				columnHoles += (g.getContent(x, y) == Gameboard::EMPTY_BLOCK);
+			}
+			if (f.getColumnHeight(x) != heights[x] || f.getColumnHoles(x) != columnHoles) {
+				return false;
+			}
+			aggregateHeight += heights[x];
+			maxHeight = std::max(maxHeight, heights[x]);
+			holes += columnHoles;
+		}
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			if (x + 1 < Gameboard::MAX_X) {
+				bumpiness += std::abs(heights[x] - heights[x + 1]);
+			}
+			int left = x > 0 ? heights[x - 1] : Gameboard::MAX_Y;
+			int right = x + 1 < Gameboard::MAX_X ? heights[x + 1] : Gameboard::MAX_Y;
+			wellDepth += std::max(0, std::min(left, right) - heights[x]);
+		}
+
+		return f.getAggregateHeight() == aggregateHeight && f.getMaxHeight() == maxHeight
+			&& f.getHoles() == holes && f.getBumpiness() == bumpiness && f.getWellDepth() == wellDepth;
+	}
+
+	// check getDropDistance() against moving every legal shape position down a row at a time
+	static bool areDropDistancesCorrect(const Gameboard& g)
+	{
+		for (int shape = 0; shape < (int)Tetromino::TetShape::COUNT; shape++) {
+			for (int rotation = 0; rotation < Tetromino::ROTATION_COUNT; rotation++) {
+				for (int x = 0; x < Gameboard::MAX_X; x++) {
+					for (int y = 0; y < Gameboard::MAX_Y; y++) {
+						GridTetromino t;
+						t.setShape((Tetromino::TetShape)shape);
+						t.setRotation(rotation);
+						t.setGridLoc(x, y);
+						if (!isLegalOn(g, t)) {
+							continue;
+						}
+
+						int expected = 0;
+						GridTetromino moved = t;
+						moved.move(0, 1);
+						while (isLegalOn(g, moved)) {
+							expected++;
+							moved.move(0, 1);
+						}
+
+						int bottoms[Tetromino::BLOCK_COUNT];
+						int columnCount = t.getColumnBottomsMappedToGrid(bottoms);
+						if (g.getFeatures().getDropDistance(t.getMappedLeftColumn(), bottoms, columnCount) != expected) {
+							return false;
+						}
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	// return true if a tetromino is within the left, right & lower borders of a board
+	//   and doesn't overlap its blocks
+	static bool isLegalOn(const Gameboard& g, const GridTetromino& t)
+	{
+		for (const Point& loc : t.getBlockLocsMappedToGrid()) {
+			if (loc.getX() < 0 || loc.getX() >= Gameboard::MAX_X || loc.getY() >= Gameboard::MAX_Y) {
+				return false;
+			}
+		}
+		return g.areLocsEmpty(t.getBlockLocsMappedToGrid());
+	}
+
+	static bool testBoardFeaturesClass()
+	{
+		std::cout << " testBoardFeaturesClass...";
+
+		Gameboard g;
+		const BoardFeatures& f = g.getFeatures();
+		assert(f.getAggregateHeight() == 0 && f.getHoles() == 0 && f.getBumpiness() == 0 && f.getWellDepth() == 0);
+
+		// columns of height 3 (with a hole in the middle), 1 & 2
+		g.setContent(2, Gameboard::MAX_Y - 1, 1);
+		g.setContent(2, Gameboard::MAX_Y - 3, 1);
+		g.setContent(3, Gameboard::MAX_Y - 1, 1);
+		g.setContent(4, Gameboard::MAX_Y - 1, 1);
+		g.setContent(4, Gameboard::MAX_Y - 2, 1);
+		assert(f.getColumnHeight(2) == 3 && f.getColumnHoles(2) == 1);
+		assert(f.getColumnHeight(3) == 1 && f.getMaxHeight() == 3);
+		assert(f.getAggregateHeight() == 6 && f.getHoles() == 1);
+		assert(f.getBumpiness() == 3 + 2 + 1 + 2);	// |0-3| + |3-1| + |1-2| + |2-0|
+		assert(f.getWellDepth() == 1);				// column 3 is 1 below its lower neighbour
+		assert(areFeaturesCorrect(g));
+
+		// fill the hole, then complete the bottom row
+		g.setContent(2, Gameboard::MAX_Y - 2, 1);
+		assert(f.getHoles() == 0);
+		g.fillRow(Gameboard::MAX_Y - 1, 1);
+		assert(f.getCompletedRows() == (1u << (Gameboard::MAX_Y - 1)));
+		assert(g.removeCompletedRows() == 1);
+		assert(f.getColumnHeight(2) == 2 && f.getColumnHeight(3) == 0 && f.getCompletedRows() == 0);
+		assert(areFeaturesCorrect(g));
+
+		// the features stay correct through a game (locks, copies, row removals)
+		TetrisEngine engine(21);
+		for (int step = 0; step < 4000; step++) {
+			engine.step((TetrisEngine::Action)(step * 5 % (int)TetrisEngine::Action::COUNT), 0.8);
+			if (engine.isGameOver()) {
+				engine.reset();
+			}
+			assert(areFeaturesCorrect(engine.getBoard()));
+			if (step % 250 == 0) {
+				assert(areDropDistancesCorrect(engine.getBoard()));
+			}
+		}
+
+		// the drop distance from under an overhang: a roof at row 10 over column 0
+		Gameboard roofed;
+		roofed.setContent(0, 10, 1);
+		roofed.setContent(0, 16, 1);
+		GridTetromino under;
+		under.setShape(Tetromino::TetShape::I);	// vertical I, blocks at rows 11 to 14
+		under.setGridLoc(0, 12);
+		int bottoms[Tetromino::BLOCK_COUNT];
+		int columnCount = under.getColumnBottomsMappedToGrid(bottoms);
+		assert(columnCount == 1 && bottoms[0] == 14);
+		assert(roofed.getFeatures().getDropDistance(under.getMappedLeftColumn(), bottoms, columnCount) == 1);
+		assert(areDropDistancesCorrect(roofed));
+
+		// evaluate a placement on a copy: add the blocks & remove the completed rows
+		Gameboard board;
+		for (int x = 0; x < Gameboard::MAX_X - 1; x++) {
+			board.setContent(x, Gameboard::MAX_Y - 1, 1);
+			board.setContent(x, Gameboard::MAX_Y - 2, 1);
+		}
+		GridTetromino piece;
+		piece.setShape(Tetromino::TetShape::I);	// vertical I into the well at x = 9
+		piece.setGridLoc(Gameboard::MAX_X - 1, Gameboard::MAX_Y - 3);
+		Gameboard::RowMask masks[Tetromino::BLOCK_COUNT];
+		int rowCount = piece.getRowMasksMappedToGrid(masks);
+		BoardFeatures candidate = board.getFeatures();
+		candidate.addRowMasks(piece.getMappedTopRow(), masks, rowCount);
+		assert(candidate.removeCompletedRows() == 2);
+		assert(candidate.getColumnHeight(Gameboard::MAX_X - 1) == 2 && candidate.getAggregateHeight() == 2);
+		for (const Point& loc : piece.getBlockLocsMappedToGrid()) {
+			board.setContent(loc, 1);
+		}
+		board.removeCompletedRows();
+		assert(board.getFeatures().getAggregateHeight() == 2 && board.getFeatures().getWellDepth() == candidate.getWellDepth());
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
 #endif
 
+	static bool testPieceRandomizerClass()
+	{
+		std::cout << " testPieceRandomizerClass...";
+
+		// test that a seed always produces the same sequence (and another seed doesn't)
+		PieceRandomizer a(1234), b(1234), c(4321);
+		bool differs = false;
+		for (int i = 0; i < 100; i++) {
+			Tetromino::TetShape shape = a.nextShape();
+			assert(shape == b.nextShape() && "same seed, different shape");
+			assert((int)shape >= 0 && shape < Tetromino::TetShape::COUNT);
+			differs = differs || (shape != c.nextShape());
+		}
+		assert(differs && "different seeds produced the same sequence");
+
+		// test that every bag deals each of the 7 shapes exactly once
+		PieceRandomizer bag(99, PieceRandomizer::Mode::BAG);
+		for (int b = 0; b < 20; b++) {
+			int counts[PieceRandomizer::BAG_SIZE] = {};
+			for (int i = 0; i < PieceRandomizer::BAG_SIZE; i++) {
+				counts[(int)bag.nextShape()]++;
+			}
+			for (int i = 0; i < PieceRandomizer::BAG_SIZE; i++) {
+				assert(counts[i] == 1 && "a bag must contain every shape once");
+			}
+		}
+
+		// test that skip() lands where calling nextShape() would (in both modes)
+		for (int mode = 0; mode < (int)PieceRandomizer::Mode::COUNT; mode++) {
+			for (int skipCount = 0; skipCount < 30; skipCount += 3) {
+				PieceRandomizer stepped(7, (PieceRandomizer::Mode)mode), skipped(7, (PieceRandomizer::Mode)mode);
+				stepped.nextShape();
+				skipped.nextShape();
+				for (int i = 0; i < skipCount; i++) {
+					stepped.nextShape();
+				}
+				skipped.skip(skipCount);
+				for (int i = 0; i < 10; i++) {
+					assert(stepped.nextShape() == skipped.nextShape() && "PieceRandomizer::skip() mismatch");
+				}
+			}
+		}
+
+		// test snapshot & restore of the state
+		PieceRandomizer::State saved = bag.getState();
+		Tetromino::TetShape first = bag.nextShape();
+		Tetromino::TetShape second = bag.nextShape();
+		bag.setState(saved);
+		assert(bag.nextShape() == first && bag.nextShape() == second);
+
+		// test that engines with the same seed play the same shapes
+		TetrisEngine e1(42), e2(42);
+		for (int i = 0; i < 20; i++) {
+			assert(e1.getCurrentShape().getShape() == e2.getCurrentShape().getShape());
+			assert(e1.getNextShape().getShape() == e2.getNextShape().getShape());
+			e1.reset();
+			e2.reset();
+		}
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static int countBlocks(const Gameboard& g)
+	{
+		int count = 0;
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			for (int y = 0; y < Gameboard::MAX_Y; y++) {
+				if (g.getContent(x, y) != Gameboard::EMPTY_BLOCK) { count++; }
+			}
+		}
+		return count;
+	}
+
+	static bool testTetrisEngineClass()
+	{
+		std::cout << " testTetrisEngineClass...";
+
+		TetrisEngine e;
+
+		// test the initial state
+		assert(e.getScore() == 0 && e.getShapesPlaced() == 0 && !e.isGameOver());
+		assert(countBlocks(e.getBoard()) == 0);
+		assert(e.getCurrentShape().getGridLoc().getX() == Gameboard::MAX_X / 2);
+		assert(e.getCurrentShape().getGridLoc().getY() == 0);
+
+		// test that moves are applied to the currentShape
+		e.applyAction(TetrisEngine::Action::LEFT);
+		assert(e.getCurrentShape().getGridLoc().getX() == Gameboard::MAX_X / 2 - 1);
+		e.applyAction(TetrisEngine::Action::RIGHT);
+		e.applyAction(TetrisEngine::Action::DOWN);
+		assert(e.getCurrentShape().getGridLoc().getX() == Gameboard::MAX_X / 2);
+		assert(e.getCurrentShape().getGridLoc().getY() == 1);
+
+		// test that the virtual clock drives ticks (no real time passes)
+		e.update(e.getSecondsPerTick() / 2);
+		assert(e.getCurrentShape().getGridLoc().getY() == 1);	// half a tick: no move
+		assert(e.getSecondsSinceLastTick() == e.getSecondsPerTick() / 2);
+		e.update(e.getSecondsPerTick());
+		assert(e.getCurrentShape().getGridLoc().getY() == 2);	// a tick moved it down
+		assert(e.getSecondsSinceLastTick() == e.getSecondsPerTick() / 2);	// (the rest carries over)
+
+		// test that a high score never ticks faster than MIN_SECONDS_PER_TICK, so a
+		//   simulation step (TetrisGame::SIMULATION_STEP_SECONDS) moves a shape a row at most
+		const double STEP_SECONDS = 1.0 / 240.0;
+		for (int score = 8; score <= 40; score++) {
+			TetrisEngine fast(static_cast<std::uint64_t>(score));
+			TetrisEngine::State state = fast.getState();
+			state.score = score;
+			fast.setState(state);
+			for (int placement = 0; placement < 3; placement++) {
+				fast.step(TetrisEngine::Action::DROP, 0.0);	// (the tick rate is set as a shape is placed)
+				assert(fast.getSecondsPerTick() == fast.getMinSecondsPerTick());
+			}
+			int lastTicks = fast.getTicks();
+			for (int step = 0; step < 240 && !fast.isGameOver(); step++) {
+				fast.update(STEP_SECONDS);
+				assert(fast.getTicks() - lastTicks <= 1 && "at most a tick per step");
+				lastTicks = fast.getTicks();
+			}
+			assert(fast.getTicks() <= static_cast<int>(1.0 / fast.getMinSecondsPerTick()) && "a second holds at most 1 / MIN ticks");
+		}
+
+		// test that a drop locks the shape and the next update() spawns the next one
+		Tetromino::TetShape next = e.getNextShape().getShape();
+		e.step(TetrisEngine::Action::DROP, 0.0);
+		assert(e.getShapesPlaced() == 1);
+		assert(countBlocks(e.getBoard()) == Tetromino::BLOCK_COUNT);
+		assert(e.getCurrentShape().getShape() == next);
+		assert(e.getCurrentShape().getGridLoc().getY() == 0);
+
+		// test that dropping in the same spot ends the game, and reset() restarts it
+		while (!e.isGameOver()) {
+			e.step(TetrisEngine::Action::DROP, 0.0);
+		}
+		e.step(TetrisEngine::Action::DROP, 0.0);	// ignored once the game is over
+		assert(e.getShapesPlaced() < Gameboard::MAX_Y);
+		e.reset();
+		assert(!e.isGameOver() && e.getShapesPlaced() == 0 && countBlocks(e.getBoard()) == 0);
+
+		// test snapshots: rolling back to one replays the game exactly, in any engine
+		const int STEPS = 300;
+		const int RING = 64;
+		std::vector<TetrisEngine::Snapshot> ring(RING);
+		std::uint64_t hashes[STEPS];
+		int scores[STEPS];
+		TetrisEngine game(17);
+		for (int step = 0; step < STEPS; step++) {
+			game.save(ring[step % RING]);
+			hashes[step] = game.getBoard().getHash() ^ (std::uint64_t)game.getCurrentShape().getGridLoc().getY();
+			scores[step] = game.getScore();
+			game.step((TetrisEngine::Action)(step * 3 % (int)TetrisEngine::Action::COUNT), 0.3);
+			if (game.isGameOver()) {
+				game.reset();
+			}
+		}
+		TetrisEngine rolledBack(99);
+		rolledBack.restore(ring[(STEPS - RING) % RING]);	// (the oldest snapshot kept)
+		for (int step = STEPS - RING; step < STEPS; step++) {
+			assert((rolledBack.getBoard().getHash() ^ (std::uint64_t)rolledBack.getCurrentShape().getGridLoc().getY()) == hashes[step]);
+			assert(rolledBack.getScore() == scores[step]);
+			rolledBack.step((TetrisEngine::Action)(step * 3 % (int)TetrisEngine::Action::COUNT), 0.3);
+			if (rolledBack.isGameOver()) {
+				rolledBack.reset();
+			}
+		}
+		assert(rolledBack.getBoard().getHash() == game.getBoard().getHash());
+		assert(rolledBack.getNextShape().getShape() == game.getNextShape().getShape());
+		assert(rolledBack.getRandomizer().getState().counter == game.getRandomizer().getState().counter);
+		assert(sizeof(TetrisEngine::Snapshot) <= 1024 && "thousands of snapshots are cheap");
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testBatchEngineClass()
+	{
+		std::cout << " testBatchEngineClass...";
+
+		// step a batch and individual engines with the same seeds & actions:
+		// a batch step is the same as applying an action then exactly one tick.
+		const int GAMES = 8;
+		const std::uint64_t SEED = 500;
+		BatchEngine batch(GAMES, SEED);
+		std::vector<TetrisEngine> engines;
+		for (int g = 0; g < GAMES; g++) {
+			engines.push_back(TetrisEngine(SEED + g));
+		}
+
+		std::uint32_t x = 1;
+		TetrisEngine::Action actions[GAMES];
+		for (int s = 0; s < 600; s++) {
+			for (int g = 0; g < GAMES; g++) {
+				x = x * 1664525u + 1013904223u;
+				actions[g] = (TetrisEngine::Action)((x >> 28) % (int)TetrisEngine::Action::COUNT);
+				engines[g].applyAction(actions[g]);
+				engines[g].tick();
+				engines[g].update(0.0);
+				if (engines[g].isGameOver()) {
+					engines[g].reset();
+				}
+			}
+			batch.step(actions);
+
+			for (int g = 0; g < GAMES; g++) {
+				for (int y = 0; y < Gameboard::MAX_Y; y++) {
+					assert(batch.getRowMasks(g)[y] == engines[g].getBoard().getRowMask(y) && "BatchEngine board mismatch");
+				}
+				GridTetromino shape = batch.getCurrentShape(g);
+				assert(shape.getShape() == engines[g].getCurrentShape().getShape());
+				assert(shape.getRotation() == engines[g].getCurrentShape().getRotation());
+				assert(shape.getGridLoc().getX() == engines[g].getCurrentShape().getGridLoc().getX());
+				assert(shape.getGridLoc().getY() == engines[g].getCurrentShape().getGridLoc().getY());
+				assert(batch.getNextShape(g) == engines[g].getNextShape().getShape());
+				assert(batch.getScore(g) == engines[g].getScore());
+			}
+		}
+		assert(batch.getGameSteps() == 600 * GAMES);
+		assert(batch.getShapesPlaced() > 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testParallelGameRunnerClass()
+	{
+		std::cout << " testParallelGameRunnerClass...";
+
+		// range ops
+		ParallelGameRunner::WorkRange victim, thief;
+		std::uint32_t gameIndex = 0;
+		victim.range.store(ParallelGameRunner::pack(10, 20));
+		assert(ParallelGameRunner::popFront(victim, gameIndex) && gameIndex == 10);
+		assert(ParallelGameRunner::stealHalf(victim, thief));
+		assert(victim.range.load() == ParallelGameRunner::pack(11, 15) && "victim keeps the front half");
+		assert(thief.range.load() == ParallelGameRunner::pack(15, 20) && "thief takes the back half");
+		victim.range.store(ParallelGameRunner::pack(3, 3));
+		assert(!ParallelGameRunner::popFront(victim, gameIndex) && "empty range");
+		assert(!ParallelGameRunner::stealHalf(victim, thief) && "nothing to steal");
+
+		// every game is played exactly once, and a game's result doesn't depend
+		// on the thread that played it
+		const int GAMES = 40;
+		std::vector<int> scores1(GAMES, -1);
+		std::vector<int> scores3(GAMES, -1);
+		ParallelGameRunner::Settings settings;
+		settings.gameCount = GAMES;
+		settings.baseSeed = 77;
+		settings.maxShapesPerGame = 60;
+
+		settings.threadCount = 1;
+		settings.scores = &scores1;
+		ParallelGameRunner::Results r1 = ParallelGameRunner::run(settings, ParallelGameRunner::makeRandomPolicyFactory(5));
+		settings.threadCount = 3;
+		settings.scores = &scores3;
+		ParallelGameRunner::Results r3 = ParallelGameRunner::run(settings, ParallelGameRunner::makeRandomPolicyFactory(5));
+
+		assert(r1.gamesPlayed == GAMES && r3.gamesPlayed == GAMES);
+		assert(r1.threadCount == 1 && r3.threadCount == 3);
+		assert(r1.totalScore == r3.totalScore && r1.totalShapes == r3.totalShapes);
+		assert(r1.gamesOver == r3.gamesOver);
+		assert(r1.minScore == r3.minScore && r1.maxScore == r3.maxScore);
+		assert(scores1 == scores3 && "per game scores are deterministic");
+		for (int score : scores1) {
+			assert(score >= 0 && "every game was played");
+		}
+		assert(r1.totalShapes > GAMES && "games ran");
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	// replay a placement's path from the start position, return true if every
+	//   move is legal and it ends in the placement (which can't move down)
+	static bool isPathValid(const PlacementEnumerator& e, const PlacementEnumerator::Placement& p,
+		int rotation, int x, int y)
+	{
+		std::vector<PlacementEnumerator::Action> path;
+		e.getPath(p, path);
+		for (size_t i = 0; i < path.size(); i++) {
+			switch (path[i]) {
+			case PlacementEnumerator::Action::LEFT: x--; break;
+			case PlacementEnumerator::Action::RIGHT: x++; break;
+			case PlacementEnumerator::Action::DOWN: y++; break;
+			case PlacementEnumerator::Action::ROTATE: rotation = (rotation + 1) % Tetromino::ROTATION_COUNT; break;
+			default: return false;
+			}
+			if (!e.fits(rotation, x, y)) {
+				return false;
+			}
+		}
+		return rotation == p.rotation && x == p.x && y == p.y && !e.fits(rotation, x, y + 1);
+	}
+
+	static bool testPlacementEnumeratorClass()
+	{
+		std::cout << " testPlacementEnumeratorClass...";
+
+		PlacementEnumerator e;
+		Gameboard board;
+		Point spawn = board.getSpawnLoc();
+
+		// on an empty board, every distinct orientation can be placed at every column it fits in
+		assert(e.enumerate(board, Tetromino::TetShape::O) == 9);
+		assert(e.enumerate(board, Tetromino::TetShape::I) == 7 + 10 && "horizontal & vertical I only");
+		assert(e.enumerate(board, Tetromino::TetShape::S) == 8 + 9);
+		assert(e.enumerate(board, Tetromino::TetShape::T) == 8 + 9 + 8 + 9);
+		for (int i = 0; i < e.getPlacementCount(); i++) {
+			assert(isPathValid(e, e.getPlacement(i), 0, spawn.getX(), spawn.getY()));
+		}
+
+		// a roof over the left of the bottom 2 rows: an O can only get under it by sliding
+		for (int x = 0; x < 4; x++) {
+			board.setContent(x, Gameboard::MAX_Y - 3, 1);
+		}
+		int count = e.enumerate(board, Tetromino::TetShape::O);
+		bool foundTuck = false;
+		for (int i = 0; i < count; i++) {
+			const PlacementEnumerator::Placement& p = e.getPlacement(i);
+			assert(isPathValid(e, p, 0, spawn.getX(), spawn.getY()));
+			Tetromino::BlockLocs locs = e.getPlacedShape(p).getBlockLocsMappedToGrid();
+			for (const Point& loc : locs) {
+				assert(board.getContent(loc) == Gameboard::EMPTY_BLOCK && "placements don't overlap");
+				if (loc.getX() == 0 && loc.getY() == Gameboard::MAX_Y - 1) {
+					foundTuck = true;
+				}
+			}
+		}
+		assert(foundTuck && "an O can slide under the roof");
+		assert(count == 4 + 4 + 5 && "on the roof (left column 0..3), under it (0..3) & beside it (4..8)");
+
+		// a T that has to rotate under the roof: every path is legal
+		board.setContent(4, Gameboard::MAX_Y - 3, 1);
+		board.setContent(9, Gameboard::MAX_Y - 1, 1);
+		count = e.enumerate(board, Tetromino::TetShape::T);
+		for (int i = 0; i < count; i++) {
+			assert(isPathValid(e, e.getPlacement(i), 0, spawn.getX(), spawn.getY()));
+		}
+
+		// compare with a plain breadth first search over states, on boards from a game
+		TetrisEngine engine(9);
+		for (int step = 0; step < 3000; step++) {
+			engine.step((TetrisEngine::Action)(step * 7 % (int)TetrisEngine::Action::COUNT), 0.8);
+			if (engine.isGameOver()) {
+				engine.reset();
+			}
+			if (step % 100 != 0) {
+				continue;
+			}
+			const GridTetromino& start = engine.getCurrentShape();
+			count = e.enumerate(engine.getBoard(), start);
+
+			const int W = Gameboard::MAX_X, H = Gameboard::MAX_Y;
+			std::vector<bool> seen(Tetromino::ROTATION_COUNT * W * H, false);
+			std::vector<int> queue;
+			std::vector<bool> landed(PlacementEnumerator::CELL_KEY_COUNT, false);
+			int landedCount = 0;
+			int startState = (start.getRotation() * H + start.getGridLoc().getY()) * W + start.getGridLoc().getX();
+			queue.push_back(startState);
+			seen[startState] = true;
+			for (size_t i = 0; i < queue.size(); i++) {
+				int r = queue[i] / (W * H), y = queue[i] / W % H, x = queue[i] % W;
+				if (!e.fits(r, x, y + 1)) {
+					const TetrominoTable::Orientation& o = TetrominoTable::getOrientation((int)start.getShape(), r);
+					int key = (o.canonicalRotation * PlacementEnumerator::CELL_KEY_ROWS + 2 + y + o.minY) * W + x + o.minX;
+					if (!landed[key]) {
+						landed[key] = true;
+						landedCount++;
+					}
+				}
+				const int next[4][3] = { { r, x - 1, y }, { r, x + 1, y }, { r, x, y + 1 }, { (r + 1) % 4, x, y } };
+				for (const int* n : next) {
+					if (e.fits(n[0], n[1], n[2]) && !seen[(n[0] * H + n[2]) * W + n[1]]) {
+						seen[(n[0] * H + n[2]) * W + n[1]] = true;
+						queue.push_back((n[0] * H + n[2]) * W + n[1]);
+					}
+				}
+			}
+			assert(count == landedCount && "the same placements as a plain search");
+			for (int i = 0; i < count; i++) {
+				const PlacementEnumerator::Placement& p = e.getPlacement(i);
+				assert(isPathValid(e, p, start.getRotation(), start.getGridLoc().getX(), start.getGridLoc().getY()));
+			}
+		}
+
+		// a shape that can't be spawned has no placements
+		board.fillRow(0, 1);
+		assert(e.enumerate(board, Tetromino::TetShape::T) == 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testBeamSearchBotClass()
+	{
+		std::cout << " testBeamSearchBotClass...";
+
+		BeamSearchBot::Settings settings;
+		settings.beamWidth = 8;
+		settings.threadCount = 1;
+		BeamSearchBot bot(settings);
+
+		// a decision is a legal placement, reached by its path
+		TetrisEngine engine(5);
+		BeamSearchBot::Decision decision = bot.decide(engine);
+		assert(decision.found);
+		const GridTetromino& start = engine.getCurrentShape();
+		PlacementEnumerator e;
+		e.enumerate(engine.getBoard(), start);
+		assert(isPathValid(e, decision.placement, start.getRotation(), start.getGridLoc().getX(), start.getGridLoc().getY()));
+		assert(bot.getLastStats().nodes > 0 && bot.getLastStats().decisions == 1);
+
+		// a gap the width of an I at the bottom: a lying I fills it
+		Gameboard board;
+		for (int x = 4; x < Gameboard::MAX_X; x++) {
+			board.setContent(x, Gameboard::MAX_Y - 1, 1);
+		}
+		GridTetromino current;
+		current.setShape(Tetromino::TetShape::I);
+		current.setGridLoc(board.getSpawnLoc());
+		decision = bot.decide(board, current, Tetromino::TetShape::O);
+		assert(decision.found);
+		Gameboard placed = board;
+		assert(BeamSearchBot::lockPlacement(placed, Tetromino::TetShape::I, decision.placement) == 1 && "the I completes the row");
+
+		// the same decisions with more threads
+		settings.threadCount = 3;
+		BeamSearchBot threadedBot(settings);
+		TetrisEngine other(5);
+		for (int i = 0; i < 20; i++) {
+			BeamSearchBot::Decision a = bot.decide(engine);
+			BeamSearchBot::Decision b = threadedBot.decide(other);
+			assert(a.found == b.found && a.score == b.score && a.path == b.path && "deterministic across thread counts");
+			for (BeamSearchBot::Action action : a.path) {
+				engine.applyAction(action);
+				other.applyAction(action);
+			}
+			engine.applyAction(BeamSearchBot::Action::DROP);
+			other.applyAction(BeamSearchBot::Action::DROP);
+			engine.update(0.0);
+			other.update(0.0);
+		}
+
+		// played as a policy (with gravity moving the shape off the plan), it clears rows & survives
+		engine.reset(11);
+		for (int step = 0; step < 20000 && engine.getShapesPlaced() < 200; step++) {
+			engine.step(bot.nextAction(engine), 0.25);
+			assert(!engine.isGameOver() && "the bot survives");
+		}
+		assert(engine.getShapesPlaced() >= 200 && engine.getScore() >= 60 && "the bot clears rows");
+
+		// a custom evaluator is used
+		int calls = 0;
+		settings.threadCount = 1;
+		settings.evaluator = [&calls](const BoardFeatures& features, int /*rowsRemoved*/) {
+			calls++;
+			return -static_cast<double>(features.getMaxHeight());
+		};
+		BeamSearchBot customBot(settings);
+		customBot.decide(engine);
+		assert(calls > 0 && static_cast<std::uint64_t>(calls) == customBot.getLastStats().nodes);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testTranspositionTableClass()
+	{
+		std::cout << " testTranspositionTableClass...";
+
+		TranspositionTable table(1);
+		assert(table.getSizeBytes() == 1 << 20 && table.getEntryCount() == (1 << 20) / 16);
+		assert(reinterpret_cast<std::uintptr_t>(table.words) % TranspositionTable::BUCKET_BYTES == 0 && "buckets are cache line aligned");
+		assert(TranspositionTable(3).getSizeBytes() == 2 << 20 && "rounded down to a power of 2");
+
+		// a result comes back as it was stored
+		TranspositionTable::Entry entry;
+		std::uint64_t key = TranspositionTable::makeKey(12345, Tetromino::TetShape::T, Tetromino::TetShape::I);
+		assert(!table.probe(key, entry));
+		TranspositionTable::Placement placement{ -1, 17, 3 };
+		table.store(key, placement, -12.375f, 2);
+		assert(table.probe(key, entry));
+		assert(entry.placement.x == -1 && entry.placement.y == 17 && entry.placement.rotation == 3);
+		assert(entry.score == -12.375f && entry.depth == 2);
+		assert(!table.probe(TranspositionTable::makeKey(12345, Tetromino::TetShape::T), entry) && "the next shape is part of the key");
+		assert(!table.probe(TranspositionTable::makeKey(12346, Tetromino::TetShape::T, Tetromino::TetShape::I), entry));
+
+		// a shallower result doesn't replace a deeper one of the same search, but does a stale one
+		table.store(key, placement, 1.0f, 1);
+		assert(table.probe(key, entry) && entry.score == -12.375f);
+		table.newSearch();
+		table.store(key, placement, 1.0f, 1);
+		assert(table.probe(key, entry) && entry.score == 1.0f && entry.depth == 1);
+
+		// a full bucket replaces its shallowest entry
+		table.clear();
+		std::uint64_t mask = table.bucketCount - 1;
+		for (int i = 0; i < TranspositionTable::ENTRIES_PER_BUCKET; i++) {
+			table.store((static_cast<std::uint64_t>(i + 1) << 40) | 7, placement, 0.0f, i == 2 ? 1 : 5);
+		}
+		table.store((9ULL << 40) | 7, placement, 0.0f, 3);
+		assert(((9ULL << 40) & mask) == 0);
+		assert(table.probe((9ULL << 40) | 7, entry));
+		assert(!table.probe((3ULL << 40) | 7, entry) && "the depth 1 entry was replaced");
+		assert(table.probe((1ULL << 40) | 7, entry) && table.probe((4ULL << 40) | 7, entry));
+
+		// threads storing & probing the same buckets never see a torn entry:
+		//   every hit's data is the data stored with its key
+		table.clear();
+		std::vector<std::thread> threads;
+		std::atomic<int> badHits{ 0 };
+		for (int t = 0; t < 4; t++) {
+			threads.emplace_back([&table, &badHits, t]() {
+				TranspositionTable::Entry e;
+				for (int i = 0; i < 200000; i++) {
+					std::uint64_t k = (static_cast<std::uint64_t>((i * 7 + t) % 64) << 32) | (i % 3);
+					std::int8_t x = static_cast<std::int8_t>(k >> 32) % 10;
+					if (i % 2 == 0) {
+						table.store(k, TranspositionTable::Placement{ x, 5, 1 }, static_cast<float>(k >> 32), 1 + t);
+					}
+					else if (table.probe(k, e) && (e.placement.x != x || e.score != static_cast<float>(k >> 32))) {
+						badHits++;
+					}
+				}
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		assert(badHits == 0);
+
+		// a bot with a table: searching a position again is a table hit, with the same decision
+		BeamSearchBot::Settings settings;
+		settings.beamWidth = 8;
+		settings.threadCount = 2;
+		settings.table = std::make_shared<TranspositionTable>(4);
+		BeamSearchBot bot(settings);
+		TetrisEngine engine(5);
+		BeamSearchBot::Decision first = bot.decide(engine);
+		assert(bot.getLastStats().tableHits == 0 && bot.getLastStats().nodes > 0);
+		BeamSearchBot::Decision again = bot.decide(engine);
+		assert(bot.getLastStats().tableHits == 1 && bot.getLastStats().nodes == 0);
+		assert(again.found && again.path == first.path && again.score == first.score);
+
+		// ...and the table doesn't change the decisions of a search
+		settings.table.reset();
+		BeamSearchBot plainBot(settings);
+		settings.table = std::make_shared<TranspositionTable>(4);
+		BeamSearchBot tableBot(settings);
+		TetrisEngine other(5);
+		engine.reset(5);
+		for (int i = 0; i < 30; i++) {
+			BeamSearchBot::Decision a = plainBot.decide(engine);
+			BeamSearchBot::Decision b = tableBot.decide(other);
+			assert(a.found == b.found && a.path == b.path && a.score == b.score);
+			for (BeamSearchBot::Action action : a.path) {
+				engine.applyAction(action);
+				other.applyAction(action);
+			}
+			engine.applyAction(BeamSearchBot::Action::DROP);
+			other.applyAction(BeamSearchBot::Action::DROP);
+			engine.update(0.0);
+			other.update(0.0);
+		}
+
+		// played as a policy (with gravity forcing searches again), nodes are found in the table
+		engine.reset(11);
+		for (int step = 0; step < 20000 && engine.getShapesPlaced() < 100; step++) {
+			engine.step(tableBot.nextAction(engine), 0.25);
+			assert(!engine.isGameOver());
+		}
+		assert(tableBot.getTotalStats().tableHits > 0);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testReplayClasses()
+	{
+		std::cout << " testReplayClasses...";
+
+		// varints
+		std::vector<std::uint8_t> bytes;
+		const std::uint64_t values[] = { 0, 1, 127, 128, 300, 1ULL << 35, ~0ULL };
+		for (std::uint64_t value : values) {
+			ReplayFormat::writeVarint(value, bytes);
+		}
+		assert(bytes.size() == 1 + 1 + 1 + 2 + 2 + 6 + 10);
+		const std::uint8_t* p = bytes.data();
+		for (std::uint64_t value : values) {
+			std::uint64_t read;
+			assert(ReplayFormat::readVarint(p, bytes.data() + bytes.size(), read) && read == value);
+		}
+		std::uint64_t read;
+		assert(!ReplayFormat::readVarint(p, bytes.data() + bytes.size(), read) && "the data ends");
+
+		// headers
+		TetrisEngine engine(21, PieceRandomizer::Mode::BAG);
+		ReplayFormat::Header header = ReplayFormat::makeHeader(engine);
+		bytes.clear();
+		ReplayFormat::writeHeader(header, bytes);
+		assert(bytes.size() == ReplayFormat::HEADER_BYTES);
+		ReplayFormat::Header readHeader;
+		assert(ReplayFormat::readHeader(bytes.data(), bytes.size(), readHeader) == ReplayFormat::HEADER_BYTES);
+		assert(readHeader.randomizer.seed == 21 && readHeader.randomizer.mode == PieceRandomizer::Mode::BAG);
+		assert(readHeader.maxSecondsPerTick == engine.getMaxSecondsPerTick() && ReplayFormat::hasSameRules(readHeader, engine));
+		assert(ReplayFormat::readHeader(bytes.data(), bytes.size() - 1, readHeader) == 0 && "too short");
+		bytes[4] = ReplayFormat::VERSION + 1;
+		assert(ReplayFormat::readHeader(bytes.data(), bytes.size(), readHeader) == 0 && "a version from the future");
+		bytes[4] = ReplayFormat::VERSION;
+		bytes[0] = 'X';
+		assert(ReplayFormat::readHeader(bytes.data(), bytes.size(), readHeader) == 0 && "not a replay");
+
+		// record 2 games (played like TetrisGame plays them: actions & real time updates
+		//   of uneven lengths), and what they ended like
+		const int GAMES = 2;
+		const std::string paths[GAMES] = { "TestSuite-1.replay", "TestSuite-2.replay" };
+		std::uint64_t endHashes[GAMES];
+		int endScores[GAMES];
+		int endShapes[GAMES];
+		std::uint64_t bytesRecorded = 0;
+		{
+			ReplayRecorder recorder;
+			recorder.start(paths[0], engine);
+			int game = 0;
+			for (int step = 0; game < GAMES; step++) {
+				TetrisEngine::Action action = (TetrisEngine::Action)(step * 7 % (int)TetrisEngine::Action::COUNT);
+				engine.applyAction(action);
+				recorder.recordAction(engine, action);
+				engine.update(0.05 + (step % 5) * 0.09);
+				recorder.recordUpdate(engine);
+				if (engine.isGameOver()) {
+					recorder.stop(engine);
+					bytesRecorded += recorder.getBytesRecorded();
+					endHashes[game] = engine.getBoard().getHash();
+					endScores[game] = engine.getScore();
+					endShapes[game] = engine.getShapesPlaced();
+					engine.reset();
+					if (++game < GAMES) {
+						recorder.start(paths[game], engine);
+					}
+				}
+			}
+			recorder.flush();
+			assert(!recorder.hasFailed());
+		}
+
+		// play them back: the same games (the second one continues the shape sequence of the first)
+		TetrisEngine replayEngine;
+		for (int game = 0; game < GAMES; game++) {
+			ReplayPlayer player;
+			assert(player.load(paths[game]));
+			assert(player.start(replayEngine));
+			player.play(replayEngine);
+			assert(player.isComplete() && player.isVerified(replayEngine));
+			assert(replayEngine.isGameOver());
+			assert(replayEngine.getBoard().getHash() == endHashes[game] && replayEngine.getScore() == endScores[game]);
+			assert(replayEngine.getShapesPlaced() == endShapes[game]);
+			assert(player.getSeconds() > 0.0 && player.getEventCount() > 0);
+		}
+
+		// a replay cut short plays up to where it ends
+		ReplayPlayer player;
+		std::ifstream file(paths[0], std::ios::binary);
+		std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		file.close();
+		assert(player.load(data.data(), data.size() / 2));
+		assert(player.start(replayEngine));
+		player.play(replayEngine);
+		assert(player.isAtEnd() && !player.isComplete() && !player.isVerified(replayEngine));
+		assert(replayEngine.getShapesPlaced() > 0 && replayEngine.getShapesPlaced() < endShapes[0]);
+		assert(player.getKeyframeCount() == 0 && "the keyframes were cut off");
+		assert(player.seek(replayEngine, endShapes[0]) && player.isAtEnd() && "seeks by playing from the start");
+
+		// a bot game (one action per frame, like TetrisGame's autoplay) is a few bytes per piece
+		{
+			BeamSearchBot::Settings settings;
+			settings.beamWidth = 4;
+			settings.threadCount = 1;
+			BeamSearchBot bot(settings);
+			ReplayRecorder recorder;
+			engine.reset();
+			recorder.start(paths[0], engine);
+			while (engine.getShapesPlaced() < 200) {
+				TetrisEngine::Action action = bot.nextAction(engine);
+				engine.applyAction(action);
+				recorder.recordAction(engine, action);
+				engine.update(1.0 / 30);
+				recorder.recordUpdate(engine);
+			}
+			recorder.stop(engine);
+			recorder.flush();
+			assert(recorder.getBytesRecorded() < ReplayFormat::HEADER_BYTES + 200 * 14 && "keyframes included");
+
+			assert(player.load(paths[0]) && player.start(replayEngine));
+			player.play(replayEngine);
+			assert(player.isVerified(replayEngine) && replayEngine.getBoard().getHash() == engine.getBoard().getHash());
+			assert(player.getKeyframeCount() == 200 / ReplayRecorder::KEYFRAME_INTERVAL);
+		}
+
+		// seeking (from a keyframe) reaches the same game as playing up to the same shape
+		auto isSameGame = [](const TetrisEngine& a, const TetrisEngine& b) {
+			return a.getBoard().getHash() == b.getBoard().getHash()
+				&& a.getCurrentShape().getShape() == b.getCurrentShape().getShape()
+				&& a.getCurrentShape().getRotation() == b.getCurrentShape().getRotation()
+				&& a.getCurrentShape().getGridLoc().getX() == b.getCurrentShape().getGridLoc().getX()
+				&& a.getCurrentShape().getGridLoc().getY() == b.getCurrentShape().getGridLoc().getY()
+				&& a.getNextShape().getShape() == b.getNextShape().getShape()
+				&& a.getScore() == b.getScore() && a.getShapesPlaced() == b.getShapesPlaced()
+				&& a.getTicks() == b.getTicks()
+				&& a.getSecondsPerTick() == b.getSecondsPerTick()
+				&& a.getRandomizer().getState().counter == b.getRandomizer().getState().counter;
+		};
+		const int seekShapes[] = { 0, 1, 31, 32, 33, 100, 199, 200, 250, 64, 5 };
+		ReplayPlayer seeker;
+		assert(seeker.load(paths[0]));
+		for (int shapes : seekShapes) {
+			assert(player.start(replayEngine));
+			while (replayEngine.getShapesPlaced() < shapes && player.step(replayEngine)) {
+			}
+			TetrisEngine seekEngine(99);
+			assert(seeker.seek(seekEngine, shapes));
+			assert(isSameGame(seekEngine, replayEngine) && seekEngine.getShapesPlaced() == std::min(shapes, 200));
+			assert(seeker.getEventCount() == player.getEventCount() && seeker.getSeconds() == player.getSeconds());
+			assert(seeker.isAtEnd() == player.isAtEnd());
+
+			// and plays on the same
+			for (int step = 0; step < 40; step++) {
+				seeker.step(seekEngine);
+				player.step(replayEngine);
+			}
+			assert(isSameGame(seekEngine, replayEngine));
+		}
+
+		// a board holding the largest content is keyframed, & seeks to the same board
+		//   (the content is put in the board outside the recorded events: only a seek
+		//   from the keyframe can reach it)
+		{
+			BeamSearchBot::Settings settings;
+			settings.beamWidth = 4;
+			settings.threadCount = 1;
+			BeamSearchBot bot(settings);
+			ReplayRecorder recorder;
+			engine.reset();
+			recorder.start(paths[0], engine);
+			TetrisEngine atKeyframe;
+			while (engine.getShapesPlaced() < ReplayRecorder::KEYFRAME_INTERVAL + 4) {
+				TetrisEngine::Action action = bot.nextAction(engine);
+				engine.applyAction(action);
+				recorder.recordAction(engine, action);
+				int shapesPlaced = engine.getShapesPlaced();
+				engine.update(1.0 / 30);
+				recorder.recordUpdate(engine);
+
+				if (engine.getShapesPlaced() != shapesPlaced && engine.getShapesPlaced() == ReplayRecorder::KEYFRAME_INTERVAL - 1) {
+					// (recolor the lowest block: the rows stay as they are)
+					TetrisEngine::State state = engine.getState();
+					for (int y = Gameboard::MAX_Y - 1, found = 0; y >= 0 && !found; y--) {
+						for (int x = 0; x < Gameboard::MAX_X && !found; x++) {
+							if (state.cells[y][x] != Gameboard::EMPTY_BLOCK) {
+								state.cells[y][x] = Gameboard::MAX_CONTENT;
+								found = 1;
+							}
+						}
+					}
+					engine.setState(state);
+				}
+				if (engine.getShapesPlaced() != shapesPlaced && engine.getShapesPlaced() == ReplayRecorder::KEYFRAME_INTERVAL) {
+					atKeyframe = engine;
+				}
+			}
+			recorder.stop(engine);
+			recorder.flush();
+			assert(!recorder.hasFailed());
+
+			const Gameboard& board = atKeyframe.getBoard();
+			int maxContentBlocks = 0;
+			for (int y = 0; y < Gameboard::MAX_Y; y++) {
+				for (int x = 0; x < Gameboard::MAX_X; x++) {
+					maxContentBlocks += (board.getContent(x, y) == Gameboard::MAX_CONTENT);
+				}
+			}
+			assert(maxContentBlocks == 1 && "the keyframed board holds the largest content");
+
+			ReplayPlayer maxPlayer;
+			assert(maxPlayer.load(paths[0]) && maxPlayer.getKeyframeCount() == 1);
+			TetrisEngine seekEngine(99);
+			assert(maxPlayer.seek(seekEngine, ReplayRecorder::KEYFRAME_INTERVAL));
+			assert(seekEngine.getBoard().getHash() == board.getHash() && "the seek restored the keyframe");
+
+			// a content the format can't store: no keyframe is written
+			ReplayFormat::Keyframe keyframe = {};
+			keyframe.state = engine.getState();
+			keyframe.state.cells[0][0] = Gameboard::MAX_CONTENT + 1;
+			std::vector<std::uint8_t> keyframeBytes(3);
+			assert(!ReplayFormat::writeKeyframe(keyframe, keyframeBytes) && keyframeBytes.size() == 3);
+			keyframe.state.cells[0][0] = Gameboard::MAX_CONTENT;
+			assert(ReplayFormat::writeKeyframe(keyframe, keyframeBytes) && keyframeBytes.size() > 3);
+		}
+
+		// a state restores to the same game
+		TetrisEngine restored;
+		restored.setState(replayEngine.getState());
+		assert(isSameGame(restored, replayEngine));
+		assert(restored.getBoard().getOccupancyHash() == replayEngine.getBoard().getOccupancyHash());
+
+		for (const std::string& path : paths) {
+			std::remove(path.c_str());
+		}
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testReplayCorpusClasses()
+	{
+		std::cout << " testReplayCorpusClasses...";
+
+		// record a few games (random actions) & what they ended like
+		const int GAMES = 5;
+		std::vector<std::string> paths;
+		std::uint64_t endHashes[GAMES];
+		int endShapes[GAMES];
+		{
+			ReplayRecorder recorder;
+			TetrisEngine engine(5);
+			for (int game = 0; game < GAMES; game++) {
+				paths.push_back("TestSuite-" + std::to_string(game) + ".replay");
+				engine.reset();
+				recorder.start(paths.back(), engine);
+				for (int step = game; !engine.isGameOver(); step++) {
+					TetrisEngine::Action action = (TetrisEngine::Action)(step * 5 % (int)TetrisEngine::Action::COUNT);
+					engine.applyAction(action);
+					recorder.recordAction(engine, action);
+					engine.update(0.1);
+					recorder.recordUpdate(engine);
+				}
+				recorder.stop(engine);
+				endHashes[game] = engine.getBoard().getHash();
+				endShapes[game] = engine.getShapesPlaced();
+			}
+			recorder.flush();
+		}
+
+		// gather them into a corpus (what isn't a replay is left out)
+		const std::string corpusPath = "TestSuite.corpus";
+		ReplayCorpusWriter writer;
+		assert(writer.open(corpusPath));
+		for (const std::string& path : paths) {
+			assert(writer.addFile(path));
+		}
+		const std::uint8_t junk[ReplayFormat::HEADER_BYTES] = { 1, 2, 3 };
+		assert(!writer.add(junk, sizeof(junk)) && !writer.addFile("TestSuite-missing.replay"));
+		assert(writer.getGameCount() == GAMES && writer.close());
+
+		// read the games in place: the same games
+		ReplayCorpus corpus;
+		assert(corpus.open(corpusPath) && corpus.getGameCount() == GAMES);
+		TetrisEngine engine;
+		for (int game = 0; game < GAMES; game++) {
+			ReplayPlayer player;
+			assert(corpus.view(game, player) && player.start(engine));
+			player.play(engine);
+			assert(player.isVerified(engine) && engine.getBoard().getHash() == endHashes[game]);
+
+			// (scanning the events in blocks reads the same events)
+			ReplayPlayer scanner;
+			assert(corpus.view(game, scanner));
+			ReplayFormat::Event events[7];
+			std::uint64_t eventCount = 0;
+			for (std::size_t count; (count = scanner.nextEvents(events, 7)) > 0; ) {
+				eventCount += count;
+			}
+			assert(eventCount == player.getEventCount() && scanner.isComplete());
+			assert(scanner.getSeconds() == player.getSeconds());
+		}
+		std::size_t size;
+		assert(corpus.getReplay(GAMES, size) == nullptr && size == 0);
+
+		// the shards cover every game once
+		for (int shardCount = 1; shardCount <= GAMES + 2; shardCount++) {
+			std::uint64_t next = 0;
+			for (int shard = 0; shard < shardCount; shard++) {
+				std::uint64_t begin, end;
+				corpus.getShard(shard, shardCount, begin, end);
+				assert(begin == next && end >= begin && end - begin <= (std::uint64_t)(GAMES / shardCount + 1));
+				next = end;
+			}
+			assert(next == GAMES);
+		}
+		std::vector<int> shapesByGame(GAMES, 0);
+		int shardCount = corpus.forEachGameParallel(3, [&shapesByGame](int, std::uint64_t game, ReplayPlayer& player) {
+			TetrisEngine shardEngine;
+			player.start(shardEngine);
+			player.play(shardEngine);
+			shapesByGame[game] = shardEngine.getShapesPlaced();
+		});
+		assert(shardCount == 3);
+		for (int game = 0; game < GAMES; game++) {
+			assert(shapesByGame[game] == endShapes[game]);
+		}
+
+		// a corpus that was cut short isn't a corpus
+		corpus.close();
+		std::ifstream file(corpusPath, std::ios::binary);
+		std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		file.close();
+		std::ofstream cut(corpusPath, std::ios::binary | std::ios::trunc);
+		cut.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 1));
+		cut.close();
+		assert(!corpus.open(corpusPath) && corpus.getGameCount() == 0);
+		assert(!corpus.open("TestSuite-missing.corpus"));
+
+		std::remove(corpusPath.c_str());
+		for (const std::string& path : paths) {
+			std::remove(path.c_str());
+		}
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testVersusSessionClass()
+	{
+		std::cout << " testVersusSessionClass...";
+
+		// garbage rows: pushed in at the bottom, with a hole
+		TetrisEngine garbageEngine(9);
+		garbageEngine.addGarbage(2, 3);
+		const Gameboard& garbageBoard = garbageEngine.getBoard();
+		for (int y = Gameboard::MAX_Y - 2; y < Gameboard::MAX_Y; y++) {
+			assert(garbageBoard.getRowMask(y) == (Gameboard::FULL_ROW_MASK & ~(1 << 3)) && "a garbage row has one hole");
+		}
+		assert(garbageBoard.getRowMask(Gameboard::MAX_Y - 3) == 0 && !garbageEngine.isGameOver());
+		assert(garbageBoard.getFeatures().getColumnHeight(0) == 2 && garbageBoard.getFeatures().getColumnHeight(3) == 0);
+		garbageEngine.addGarbage(Gameboard::MAX_Y, 0);
+		assert(garbageEngine.isGameOver() && "blocks pushed off the top end the game");
+		assert(VersusSession::getGarbageRows(1) == 0 && VersusSession::getGarbageRows(4) == 4);
+
+		// two players connected by a simulated network (50 to 150 ms, 5% loss), each
+		//   playing random actions on a virtual clock
+		VersusSession first(11), second(22);
+		VersusSession* sessions[VersusSession::PLAYER_COUNT] = { &first, &second };
+		LatencySimulator links[VersusSession::PLAYER_COUNT];	// (links[i] carries the packets of sessions[i])
+		ParallelGameRunner::Policy policies[VersusSession::PLAYER_COUNT];
+		std::vector<TetrisEngine::Action> played[VersusSession::PLAYER_COUNT];	// each player's input of each frame
+		for (int i = 0; i < VersusSession::PLAYER_COUNT; i++) {
+			LatencySimulator::Settings settings;
+			settings.latencySeconds = 0.05;
+			settings.jitterSeconds = 0.1;
+			settings.lossRate = 0.05;
+			settings.seed = i + 1;
+			links[i].setSettings(settings);
+			policies[i] = ParallelGameRunner::makeRandomPolicyFactory(i + 7)();
+		}
+
+		const std::uint8_t junk[VersusSession::MAX_PACKET_BYTES] = { 1, 2, 3 };
+		assert(!first.receivePacket(junk, sizeof(junk)) && !first.isStarted() && !first.advanceFrame(TetrisEngine::Action::NONE));
+
+		const int FRAMES = 900;
+		int immediateFrames = 0;
+		std::vector<std::uint8_t> packet;
+		for (int tick = 0; tick < FRAMES + 30; tick++) {
+			double now = tick * VersusSession::FRAME_SECONDS;
+			for (int i = 0; i < VersusSession::PLAYER_COUNT; i++) {
+				while (links[1 - i].receive(packet, now)) {
+					assert(sessions[i]->receivePacket(packet.data(), packet.size()));
+				}
+			}
+
+			for (int i = 0; i < VersusSession::PLAYER_COUNT; i++) {
+				VersusSession& session = *sessions[i];
+				int local = session.getLocalPlayer();
+				TetrisEngine::Action action = (tick < FRAMES) ? policies[i](session.getEngine(local)) : TetrisEngine::Action::NONE;
+
+				// (what the local game should look like at the end of the frame)
+				TetrisEngine expected = session.getEngine(local);
+				expected.step(action, VersusSession::FRAME_SECONDS);
+				bool expectable = session.isStarted() && session.getState().pendingGarbage[local] == 0;
+				int round = session.getState().round;
+
+				if (session.advanceFrame(action)) {
+					played[i].push_back(action);
+
+					// the local input shows in its own frame, whatever the network
+					if (expectable && session.getState().round == round) {
+						const TetrisEngine& engine = session.getEngine(local);
+						assert(engine.getBoard().getHash() == expected.getBoard().getHash() && "the local input isn't delayed");
+						assert(engine.getCurrentShape().getGridLoc().getX() == expected.getCurrentShape().getGridLoc().getX());
+						assert(engine.getCurrentShape().getGridLoc().getY() == expected.getCurrentShape().getGridLoc().getY());
+						assert(engine.getCurrentShape().getRotation() == expected.getCurrentShape().getRotation());
+						immediateFrames++;
+					}
+				}
+
+				session.writePacket(packet);
+				assert(packet.size() <= static_cast<std::size_t>(VersusSession::MAX_PACKET_BYTES));
+				links[i].send(packet.data(), packet.size(), now);
+			}
+		}
+		assert(first.getLocalPlayer() == 0 && second.getLocalPlayer() == 1 && first.getSeed() == second.getSeed());
+		assert(immediateFrames > FRAMES && links[0].getLostCount() > 0);
+
+		// both sessions agree (& checked each other), and rolled back to get there
+		for (int i = 0; i < VersusSession::PLAYER_COUNT; i++) {
+			const VersusSession& session = *sessions[i];
+			assert(!session.isDesynced() && session.getChecksumCount() > 0);
+			assert(session.getRollbackCount() > 0 && session.getResimulatedFrameCount() >= session.getRollbackCount());
+			assert(session.getConfirmedFrame() >= FRAMES && session.getFrame() >= session.getConfirmedFrame());
+		}
+
+		// and their final states are those of the same inputs without a network
+		VersusSession::State reference;
+		VersusSession::startState(reference, first.getSeed());
+		int lastFrame = std::max(first.getConfirmedFrame(), second.getConfirmedFrame());
+		std::vector<std::uint64_t> referenceHashes;
+		for (int frame = 0; frame <= lastFrame; frame++) {
+			referenceHashes.push_back(VersusSession::getStateHash(reference));
+			if (frame < lastFrame) {
+				TetrisEngine::Action frameInputs[VersusSession::PLAYER_COUNT] = { played[0][frame], played[1][frame] };
+				VersusSession::simulateFrame(reference, first.getSeed(), frameInputs);
+			}
+		}
+		assert(reference.round > 0 && "the games were played to the end");
+		for (int i = 0; i < VersusSession::PLAYER_COUNT; i++) {
+			const VersusSession& session = *sessions[i];
+			int frame = session.getConfirmedFrame();
+			std::uint64_t hash = (frame == session.getFrame()) ? VersusSession::getStateHash(session.getState()) : session.savedHashes[VersusSession::getSlot(frame)];
+			assert(hash == referenceHashes[frame] && "rollback ends where lockstep would");
+		}
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testSpscQueueClass()
+	{
+		std::cout << " testSpscQueueClass...";
+
+		// the capacity is rounded up to a power of 2
+		SpscQueue<int> queue(5);
+		assert(queue.getCapacity() == 8 && queue.mask == 7);
+		assert(SpscQueue<int>(1).getCapacity() == 2);
+
+		// an empty queue pops nothing, a full one pushes nothing
+		int item = -1;
+		assert(!queue.pop(item) && item == -1);
+		for (int i = 0; i < 8; i++) {
+			assert(queue.push(i));
+		}
+		assert(!queue.push(8) && "the queue is full");
+
+		// the items come out in the order they went in (& the ring buffer wraps)
+		for (int round = 0; round < 3; round++) {
+			for (int i = 0; i < 8; i++) {
+				assert(queue.pop(item) && item == round * 8 + i);
+				assert(queue.push(round * 8 + i + 8));
+			}
+		}
+		for (int i = 0; i < 8; i++) {
+			assert(queue.pop(item) && item == 24 + i);
+		}
+		assert(!queue.pop(item));
+
+		// the head & tail don't share a cache line
+		assert(reinterpret_cast<const char*>(&queue.tail) - reinterpret_cast<const char*>(&queue.head) >= 64);
+
+		// one thread pushes while another pops: every item arrives, once & in order
+		const int ITEM_COUNT = 200000;
+		SpscQueue<int> shared(16);
+		std::thread producer([&shared]() {
+			for (int i = 0; i < ITEM_COUNT; i++) {
+				while (!shared.push(i)) {
+					std::this_thread::yield();
+				}
+			}
+		});
+		int expected = 0;
+		while (expected < ITEM_COUNT) {
+			if (shared.pop(item)) {
+				assert(item == expected && "the items arrive in order");
+				expected++;
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+		producer.join();
+		assert(!shared.pop(item));
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testTripleBufferClass()
+	{
+		std::cout << " testTripleBufferClass...";
+
+		// nothing published: the reader has nothing newer
+		TripleBuffer<int> buffer;
+		assert(!buffer.update());
+
+		// the reader takes the latest version published (skipping the older ones)
+		buffer.getWriteBuffer() = 1;
+		buffer.publish();
+		buffer.getWriteBuffer() = 2;
+		buffer.publish();
+		assert(buffer.update() && buffer.getReadBuffer() == 2);
+		assert(!buffer.update() && buffer.getReadBuffer() == 2 && "no newer version: the read buffer stays");
+
+		// the 3 copies stay distinct: the writer never gets the reader's copy
+		for (int i = 3; i < 10; i++) {
+			assert(&buffer.getWriteBuffer() != &buffer.getReadBuffer());
+			buffer.getWriteBuffer() = i;
+			buffer.publish();
+			if (i % 2 == 0) {
+				assert(buffer.update() && buffer.getReadBuffer() == i);
+			}
+		}
+		assert(buffer.writeIndex != buffer.readIndex && (buffer.middle & TripleBuffer<int>::INDEX_MASK) != buffer.writeIndex);
+
+		// one thread publishes while another reads: every version read is complete
+		//   (all its values match) & no older than the one before
+		struct Version {
+			int values[64];
+		};
+		const int VERSION_COUNT = 100000;
+		TripleBuffer<Version> shared;
+		std::thread writer([&shared]() {
+			for (int v = 1; v <= VERSION_COUNT; v++) {
+				Version& version = shared.getWriteBuffer();
+				for (int& value : version.values) {
+					value = v;
+				}
+				shared.publish();
+			}
+		});
+		int lastRead = 0;
+		while (lastRead < VERSION_COUNT) {
+			if (shared.update()) {
+				const Version& version = shared.getReadBuffer();
+				for (int value : version.values) {
+					assert(value == version.values[0] && "a version is never read while it is written");
+				}
+				assert(version.values[0] > lastRead && "the versions read only get newer");
+				lastRead = version.values[0];
+			}
+		}
+		writer.join();
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
+
+	static bool testFrameTimingsClasses()
+	{
+		std::cout << " testFrameTimingsClasses...";
+
+		// the bins cover every duration, in order, without gaps
+		assert(TimingHistogram::getBin(0) == 0 && TimingHistogram::getBin(15) == 15);
+		assert(TimingHistogram::getBin(0xFFFFFFFFu) == TimingHistogram::BIN_COUNT - 1);
+		assert(TimingHistogram::getBinHighest(TimingHistogram::BIN_COUNT - 1) == 0xFFFFFFFFu);
+		for (int bin = 1; bin < TimingHistogram::BIN_COUNT; bin++) {
+			assert(TimingHistogram::getBinLowest(bin) == TimingHistogram::getBinHighest(bin - 1) + 1);
+		}
+		for (std::uint32_t us : { 16u, 17u, 100u, 1000u, 16666u, 33333u, 1000000u }) {
+			int bin = TimingHistogram::getBin(us);
+			assert(TimingHistogram::getBinLowest(bin) <= us && us <= TimingHistogram::getBinHighest(bin));
+			assert(TimingHistogram::getBinHighest(bin) - TimingHistogram::getBinLowest(bin) <= us / 16 && "a bin is within 1/16 of its durations");
+		}
+
+		// the percentiles: the top of the bin of the duration at that rank (at most the max)
+		TimingHistogram histogram;
+		assert(histogram.getCount() == 0 && histogram.getPercentile(0.5) == 0 && histogram.getMax() == 0);
+		for (std::uint32_t us = 1; us <= 100; us++) {
+			histogram.record(us);
+		}
+		histogram.record(5000);
+		assert(histogram.getCount() == 101 && histogram.getMax() == 5000);
+		std::uint32_t p50 = histogram.getPercentile(0.5);
+		assert(p50 >= 51 && p50 <= 51 + 51 / 16);
+		std::uint32_t p99 = histogram.getPercentile(0.99);
+		assert(p99 >= 100 && p99 <= 100 + 100 / 16);
+		assert(histogram.getPercentile(1.0) == 5000 && histogram.getPercentile(0.0) == 1);
+
+		// off: nothing is recorded
+		FrameTimings timings;
+		FrameTimings::Clock::time_point start = FrameTimings::now();
+		timings.record(FrameTimings::Phase::DRAW, start);
+		timings.record(FrameTimings::Phase::FRAME, 0.016);
+		assert(timings.getHistogram(FrameTimings::Phase::DRAW).getCount() == 0);
+		assert(timings.getHistogram(FrameTimings::Phase::FRAME).getCount() == 0);
+
+		// on: seconds are recorded in microseconds (clamped to the histogram's range)
+		timings.setEnabled(true);
+		timings.record(FrameTimings::Phase::DRAW, start);
+		timings.record(FrameTimings::Phase::FRAME, 0.000010);
+		timings.record(FrameTimings::Phase::FRAME, -1.0);
+		timings.record(FrameTimings::Phase::TICK_JITTER, 1e9);
+		assert(timings.getHistogram(FrameTimings::Phase::DRAW).getCount() == 1);
+		assert(timings.getHistogram(FrameTimings::Phase::FRAME).getMax() == 10);
+		assert(timings.getHistogram(FrameTimings::Phase::FRAME).getPercentile(0.0) == 0);
+		assert(timings.getHistogram(FrameTimings::Phase::TICK_JITTER).getMax() == 0xFFFFFFFFu);
+
+		// the overlay has a line per phase recorded (& a heading)
+		std::string overlay = timings.getOverlayText();
+		assert(std::count(overlay.begin(), overlay.end(), '\n') == 4);
+		assert(overlay.find("frame") != std::string::npos && overlay.find("present") == std::string::npos);
+		assert(overlay.find("dropped") == std::string::npos && "no line for dropped key presses until there are some");
+		timings.setDroppedInputCount(3);
+		assert(timings.getOverlayText().find("dropped keys  3") != std::string::npos);
+
+		// the file has a summary line per phase, & a line per bin that isn't empty
+		const std::string path = "testFrameTimings.txt";
+		assert(timings.writeToFile(path));
+		std::ifstream file(path);
+		std::string line;
+		int phaseLines = 0;
+		int binLines = 0;
+		bool droppedLine = false;
+		while (std::getline(file, line)) {
+			phaseLines += (line.compare(0, 6, "phase ") == 0);
+			binLines += (line.compare(0, 4, "bin ") == 0);
+			droppedLine = droppedLine || line == "dropped_inputs 3";
+		}
+		file.close();
+		std::remove(path.c_str());
+		assert(phaseLines == static_cast<int>(FrameTimings::Phase::COUNT) && binLines == 4 && droppedLine);
+
+		std::cout << "passed!" << "\n";
+		return true;
+	}
 
 };
 #endif /* TESTSUITE_H */
\ No newline at end of file
@@ -0,0 +1,461 @@
+#include <algorithm>
+#include <cstring>
+#include "TetrisEngine.h"
+
+constexpr double TetrisEngine::MAX_SECONDS_PER_TICK;
+constexpr double TetrisEngine::MIN_SECONDS_PER_TICK;
+
+// constructor
+//   seed the randomizer
+//   reset() the game
+TetrisEngine::TetrisEngine(std::uint64_t seed, PieceRandomizer::Mode randomizerMode)
+	: randomizer(seed, randomizerMode)
+{
+	reset();
+}
+
+// reset everything for a new game (use existing functions)
+//  - set the score to 0
+//  - call determineSecondsPerTick() to determine the tick rate.
+//  - clear the gameboard,
+//  - pick & spawn next shape
+//  - pick next shape again (for the "on-deck" shape)
+void TetrisEngine::reset()
+{
+	score = 0;
+	shapesPlaced = 0;
+	ticks = 0;
+	gameOver = false;
+	elapsedSeconds = 0.0;
+	secondsSinceLastTick = 0.0;
+	shapePlacedSinceLastUpdate = false;
+	determineSecondsPerTick();
+	board.empty();
+	startRandomizerState = randomizer.getState();
+	pickNextShape();
+	spawnNextShape();
+	pickNextShape();
+}
+
+// reset everything for a new game after re-seeding the randomizer
+void TetrisEngine::reset(std::uint64_t seed)
+{
+	randomizer.seed(seed);
+	reset();
+}
+
+// reset everything for a new game with the randomizer continuing from a state
+void TetrisEngine::reset(const PieceRandomizer::State& randomizerState)
+{
+	randomizer.setState(randomizerState);
+	reset();
+}
+
+// return the complete state of the game
+TetrisEngine::State TetrisEngine::getState() const
+{
+	State state;
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			state.cells[y][x] = static_cast<std::int8_t>(board.getContent(x, y));
+		}
+	}
+	state.currentShape = currentShape.getShape();
+	state.currentRotation = static_cast<std::int8_t>(currentShape.getRotation());
+	state.currentX = static_cast<std::int8_t>(currentShape.getGridLoc().getX());
+	state.currentY = static_cast<std::int8_t>(currentShape.getGridLoc().getY());
+	state.nextShape = nextShape.getShape();
+	state.randomizer = randomizer.getState();
+	state.startRandomizer = startRandomizerState;
+	state.score = score;
+	state.shapesPlaced = shapesPlaced;
+	state.ticks = ticks;
+	state.gameOver = gameOver;
+	state.shapePlacedSinceLastUpdate = shapePlacedSinceLastUpdate;
+	state.secondsPerTick = secondsPerTick;
+	state.elapsedSeconds = elapsedSeconds;
+	state.secondsSinceLastTick = secondsSinceLastTick;
+	return state;
+}
+
+// continue the game from a state previously returned by getState()
+//   (the board's masks, hashes & features follow from its blocks)
+void TetrisEngine::setState(const State& state)
+{
+	board.empty();
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			if (state.cells[y][x] != Gameboard::EMPTY_BLOCK) {
+				board.setContent(x, y, state.cells[y][x]);
+			}
+		}
+	}
+	currentShape.setShape(state.currentShape);
+	currentShape.setRotation(state.currentRotation);
+	currentShape.setGridLoc(state.currentX, state.currentY);
+	nextShape.setShape(state.nextShape);
+	randomizer.setState(state.randomizer);
+	startRandomizerState = state.startRandomizer;
+	score = state.score;
+	shapesPlaced = state.shapesPlaced;
+	ticks = state.ticks;
+	gameOver = state.gameOver;
+	shapePlacedSinceLastUpdate = state.shapePlacedSinceLastUpdate;
+	secondsPerTick = state.secondsPerTick;
+	elapsedSeconds = state.elapsedSeconds;
+	secondsSinceLastTick = state.secondsSinceLastTick;
+}
+
+// copy the complete simulation to a snapshot
+void TetrisEngine::save(Snapshot& snapshot) const
+{
+	std::memcpy(snapshot.bytes, this, sizeof(TetrisEngine));
+}
+
+// continue the game from a snapshot (taken from this engine or another one)
+void TetrisEngine::restore(const Snapshot& snapshot)
+{
+	std::memcpy(this, snapshot.bytes, sizeof(TetrisEngine));
+}
+
+// apply a player action to the currentShape
+//   (ignored once the game is over)
+void TetrisEngine::applyAction(Action action)
+{
+	if (gameOver) {
+		return;
+	}
+
+	switch (action) {
+	case Action::ROTATE:
+		attemptRotate(currentShape);
+		break;
+
+	case Action::DOWN:
+		if (!attemptMove(currentShape, 0, DOWN)) {
+			lock(currentShape);
+			shapePlacedSinceLastUpdate = true;
+		}
+		break;
+
+	case Action::LEFT:
+		attemptMove(currentShape, LEFT, 0);
+		break;
+
+	case Action::RIGHT:
+		attemptMove(currentShape, RIGHT, 0);
+		break;
+
+	case Action::DROP:
+		drop(currentShape);
+		lock(currentShape);
+		shapePlacedSinceLastUpdate = true;
+		break;
+
+	default:
+		break;
+	}
+}
+
+// advance the virtual clock by secondsSinceLastUpdate, handling ticks &
+// tetromino placement (locking).
+void TetrisEngine::update(double secondsSinceLastUpdate)
+{
+	if (gameOver) {
+		return;
+	}
+
+	elapsedSeconds += secondsSinceLastUpdate;
+	secondsSinceLastTick += secondsSinceLastUpdate;
+
+	if (secondsSinceLastTick > secondsPerTick) {
+		tick();
+		secondsSinceLastTick -= secondsPerTick;
+	}
+
+	settle();
+}
+
+// handle the shape placed since the last update (if any) without advancing the clock
+void TetrisEngine::settle()
+{
+	if (shapePlacedSinceLastUpdate) {
+		processPlacedShape();
+	}
+}
+
+// push the board up by rowCount garbage rows (with a hole at holeColumn)
+void TetrisEngine::addGarbage(int rowCount, int holeColumn)
+{
+	if (gameOver || rowCount <= 0) {
+		return;
+	}
+
+	rowCount = std::min(rowCount, static_cast<int>(Gameboard::MAX_Y));
+	if (board.insertGarbageRows(rowCount, holeColumn, static_cast<int>(GARBAGE_COLOR))) {
+		gameOver = true;
+		return;
+	}
+
+	// (the shape may already be above its landing spot, so it only moves as far as it must)
+	for (int pushed = 0; pushed < rowCount && !isPositionLegal(currentShape); pushed++) {
+		currentShape.move(0, -1);
+	}
+}
+
+// apply an action, then update() the virtual clock by seconds.
+void TetrisEngine::step(Action action, double seconds)
+{
+	applyAction(action);
+	update(seconds);
+}
+
+// A tick() forces the currentShape to move (if there were no tick,
+// the currentShape would float in position forever). This should
+// call attemptMove() on the currentShape.  If not successful, lock()
+// the currentShape (it can move no further), and record the fact that a
+// shape was placed (using shapePlacedSinceLastUpdate)
+void TetrisEngine::tick()
+{
+	ticks++;
+	if (!attemptMove(currentShape, 0, DOWN)) {
+		lock(currentShape);
+		shapePlacedSinceLastUpdate = true;
+	}
+}
+
+// State access ==================================================
+
+const Gameboard& TetrisEngine::getBoard() const
+{
+	return board;
+}
+
+const GridTetromino& TetrisEngine::getCurrentShape() const
+{
+	return currentShape;
+}
+
+const GridTetromino& TetrisEngine::getNextShape() const
+{
+	return nextShape;
+}
+
+int TetrisEngine::getScore() const
+{
+	return score;
+}
+
+int TetrisEngine::getShapesPlaced() const
+{
+	return shapesPlaced;
+}
+
+int TetrisEngine::getTicks() const
+{
+	return ticks;
+}
+
+bool TetrisEngine::isGameOver() const
+{
+	return gameOver;
+}
+
+double TetrisEngine::getElapsedSeconds() const
+{
+	return elapsedSeconds;
+}
+
+double TetrisEngine::getSecondsPerTick() const
+{
+	return secondsPerTick;
+}
+
+double TetrisEngine::getSecondsSinceLastTick() const
+{
+	return secondsSinceLastTick;
+}
+
+const PieceRandomizer& TetrisEngine::getRandomizer() const
+{
+	return randomizer;
+}
+
+const PieceRandomizer::State& TetrisEngine::getStartRandomizerState() const
+{
+	return startRandomizerState;
+}
+
+double TetrisEngine::getMaxSecondsPerTick() const
+{
+	return MAX_SECONDS_PER_TICK;
+}
+
+double TetrisEngine::getMinSecondsPerTick() const
+{
+	return MIN_SECONDS_PER_TICK;
+}
+
+int TetrisEngine::getDropDistance() const
+{
+	return getDropDistance(currentShape);
+}
+
+GridTetromino TetrisEngine::getGhostShape() const
+{
+	GridTetromino ghost = currentShape;
+	ghost.move(0, getDropDistance(currentShape));
+	return ghost;
+}
+
+// State & gameplay/logic methods ================================
+
+// assign nextShape.setShape the next shape from the randomizer
+void TetrisEngine::pickNextShape()
+{
+	nextShape.setShape(randomizer.nextShape());
+}
+
+// copy the nextShape into the currentShape (through assignment)
+//   position the currentShape to its spawn location.
+//	 - return true/false based on isPositionLegal()
+bool TetrisEngine::spawnNextShape()
+{
+	currentShape.setShape(nextShape.getShape());
+	currentShape.setGridLoc(board.getSpawnLoc());
+
+	return isPositionLegal(currentShape);
+}
+
+// handle a shape that was placed since the last update:
+//   spawn the next shape (the game is over if it can't be spawned),
+//   pick a new next shape, remove completed rows & update the score and tick rate.
+void TetrisEngine::processPlacedShape()
+{
+	shapePlacedSinceLastUpdate = false;
+	shapesPlaced++;
+
+	if (!spawnNextShape()) {
+		gameOver = true;
+		return;
+	}
+
+	pickNextShape();
+	score += board.removeCompletedRows();
+	determineSecondsPerTick();
+}
+
+// Test if a rotation is legal on the tetromino and if so, rotate it.
+//  To do this:
+//	 1) create a (local) temporary copy of the tetromino
+//	 2) rotate it (shape.rotateClockwise())
+//	 3) test if temp rotation was legal (isPositionLegal()),
+//      if so - rotate the original tetromino.
+//	 4) return true/false to indicate successful movement
+bool TetrisEngine::attemptRotate(GridTetromino& shape)
+{
+	GridTetromino temp = shape;
+	temp.rotateClockwise();
+
+	if (isPositionLegal(temp)) {
+		shape.rotateClockwise();
+		return true;
+	}
+
+	return false;
+}
+
+// test if a move is legal on the tetromino, if so, move it.
+//  To do this:
+//	 1) create a (local) temporary copy of the tetromino
+//	 2) move it (temp.move())
+//	 3) test if temp move was legal (isPositionLegal(),
+//      if so - move the original.
+//	 4) return true/false to indicate successful movement
+bool TetrisEngine::attemptMove(GridTetromino& shape, int x, int y)
+{
+	GridTetromino temp = shape;
+	temp.move(x, y);
+
+	if (isPositionLegal(temp)) {
+		shape.move(x, y);
+		return true;
+	}
+
+	return false;
+}
+
+// drops the tetromino vertically as far as it can
+//   legally go, in one move (see getDropDistance()).
+void TetrisEngine::drop(GridTetromino& shape)
+{
+	shape.move(0, getDropDistance(shape));
+}
+
+// return how many rows a tetromino can fall from its (legal) position
+int TetrisEngine::getDropDistance(const GridTetromino& shape) const
+{
+	int bottoms[Tetromino::BLOCK_COUNT];
+	int columnCount = shape.getColumnBottomsMappedToGrid(bottoms);
+
+	return board.getFeatures().getDropDistance(shape.getMappedLeftColumn(), bottoms, columnCount);
+}
+
+// copy the contents (color) of the tetromino's mapped block locs to the grid.
+//     1) get the tetromino's mapped locs via tetromino.getBlockLocsMappedToGrid()
+//     2) iterate through the mapped locations, if the location is a valid point
+//         (according to the gameboard) then use Gameboard.setContent() to set the
+//         board content to be the color of the tetromino.
+void TetrisEngine::lock(const GridTetromino& shape)
+{
+	for (Point pt : shape.getBlockLocsMappedToGrid()) {
+		if (board.isValidPoint(pt)) {
+			board.setContent(pt, (int)shape.getColor());
+		}
+	}
+}
+
+// return true if shape is within borders (isShapeWithinBorders())
+//	 and the shape's mapped board locs are empty.
+//   Make use of Gameboard's areRowMasksEmpty() and pass it the shape's mapped row masks.
+bool TetrisEngine::isPositionLegal(const GridTetromino& shape) const
+{
+	if (!isShapeWithinBorders(shape)) {
+		return false;
+	}
+
+	// test the shape's row masks against the board's row masks (one AND per row)
+	Gameboard::RowMask masks[Tetromino::BLOCK_COUNT];
+	int rowCount = shape.getRowMasksMappedToGrid(masks);
+
+	return board.areRowMasksEmpty(shape.getMappedTopRow(), masks, rowCount);
+}
+
+// return true if the shape is within the left, right, and lower border of
+//	 the grid, but *NOT* the top border. (return false otherwise)
+//   * Ignore the upper border because we want shapes to be able to drop
+//     in from the top of the gameboard.
+//   All of a shape's blocks must be inside these 3 borders to return true
+bool TetrisEngine::isShapeWithinBorders(const GridTetromino& shape) const
+{
+	// the shape's precomputed bounding box tells us its outermost blocks
+	const TetrominoTable::Orientation& orientation = shape.getOrientation();
+	int x = shape.getGridLoc().getX();
+	int y = shape.getGridLoc().getY();
+
+	if (x + orientation.minX < 0
+		|| x + orientation.maxX >= board.MAX_X
+		|| y + orientation.maxY >= board.MAX_Y)
+	{
+		return false;
+	}
+	return true;
+}
+
+// set secsPerTick
+//   - basic: use MAX_SECS_PER_TICK
+//   - advanced: base it on score (higher score results in lower secsPerTick)
+void TetrisEngine::determineSecondsPerTick()
+{
+	secondsPerTick = std::max(MIN_SECONDS_PER_TICK, MAX_SECONDS_PER_TICK - (score * 0.1));
+}
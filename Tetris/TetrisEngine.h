@@ -0,0 +1,282 @@
+// This class encapsulates the rules of a single tetris game: the board, the falling
+// and "on-deck" tetrominoes, the score and the tick timing.
+// It does no drawing and has no knowledge of SFML (or of any window, font or sprite),
+// so it builds with a plain C++ toolchain and can be run headless, eg: on a
+// simulation server, as fast as the CPU allows.
+//
+// Each engine owns its own PieceRandomizer, so a game is fully determined by its
+// seed and its inputs, and many engines can run in parallel without sharing state.
+//
+// The engine is driven by 2 things:
+//   - actions: the player inputs (rotate, left, right, down, drop), see applyAction()
+//   - time: a virtual clock that is only advanced by update(). A tick happens
+//     when enough (virtual) time has accumulated, regardless of real time.
+//
+// TetrisGame wraps an engine, translating key presses into actions, feeding it
+// the real time between game loops, and drawing its state.
+//
+// This class is responsible for:
+//   - setting up the board,
+//   - spawning tetrominoes,
+//   - moving and placing tetrominoes (and removing completed rows)
+//   - keeping score and determining the tick rate
+
+#ifndef TETRISENGINE_H
+#define TETRISENGINE_H
+
+#include <cstdint>
+#include <type_traits>
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "PieceRandomizer.h"
+
+class TetrisEngine
+{
+public:
+	// the player inputs the engine understands
+	enum class Action {
+		NONE,	// do nothing (useful for a step() that only advances time)
+		ROTATE,	// rotate the currentShape clockwise
+		LEFT,	// move the currentShape 1 block left
+		RIGHT,	// move the currentShape 1 block right
+		DOWN,	// move the currentShape 1 block down (lock it if it can't move)
+		DROP,	// drop the currentShape as far as it can go and lock it
+		COUNT
+	};
+
+	// the complete state of a game, as plain data (see getState()): the board is
+	//   kept as its block colors only, setState() rebuilds its masks, hashes & features
+	//   (compact, eg: for a file. For a fast copy in memory, see Snapshot)
+	struct State {
+		std::int8_t cells[Gameboard::MAX_Y][Gameboard::MAX_X];	// the block colors (EMPTY_BLOCK if empty)
+		Tetromino::TetShape currentShape;
+		std::int8_t currentRotation;
+		std::int8_t currentX;
+		std::int8_t currentY;
+		Tetromino::TetShape nextShape;
+		PieceRandomizer::State randomizer;
+		PieceRandomizer::State startRandomizer;
+		int score;
+		int shapesPlaced;
+		int ticks;
+		bool gameOver;
+		bool shapePlacedSinceLastUpdate;
+		double secondsPerTick;
+		double elapsedSeconds;
+		double secondsSinceLastTick;
+	};
+
+	// a snapshot of the complete simulation, for search, rollback & undo: the engine
+	//   is plain data all the way down (the board's arrays, the tetrominoes, the
+	//   randomizer's state, the clock), so a snapshot is a copy of its bytes and
+	//   save() & restore() are a single fixed size memcpy, without allocating.
+	//   A snapshot can be restored into any engine. (defined below the class: it is
+	//   the size of an engine, about 800 bytes)
+	struct Snapshot;
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   seed the randomizer
+	//   reset() the game
+	explicit TetrisEngine(std::uint64_t seed = 0, PieceRandomizer::Mode randomizerMode = PieceRandomizer::Mode::RANDOM);
+
+	// reset everything for a new game (use existing functions)
+	//  - set the score to 0
+	//  - call determineSecondsPerTick() to determine the tick rate.
+	//  - clear the gameboard,
+	//  - pick & spawn next shape
+	//  - pick next shape again (for the "on-deck" shape)
+	void reset();
+	// (same as above) after re-seeding the randomizer
+	void reset(std::uint64_t seed);
+	// (same as above) with the randomizer continuing from a state
+	//   (eg: the start state of a recorded game, see getStartRandomizerState())
+	void reset(const PieceRandomizer::State& randomizerState);
+
+	// return the complete state of the game
+	State getState() const;
+	// continue the game from a state previously returned by getState()
+	//   (eg: a replay's keyframe, see ReplayPlayer::seek())
+	void setState(const State& state);
+
+	// copy the complete simulation to a snapshot
+	void save(Snapshot& snapshot) const;
+	// continue the game from a snapshot (taken from this engine or another one)
+	void restore(const Snapshot& snapshot);
+
+	// apply a player action to the currentShape
+	//   (ignored once the game is over)
+	void applyAction(Action action);
+
+	// advance the virtual clock by secondsSinceLastUpdate, handling ticks &
+	// tetromino placement (locking). When a placed shape can't be replaced by
+	// the next shape the game is over (see isGameOver()).
+	void update(double secondsSinceLastUpdate);
+
+	// apply an action, then update() the virtual clock by seconds.
+	//   (one step of a headless simulation)
+	void step(Action action, double seconds);
+
+	// handle the shape placed since the last update (if any) without advancing the
+	//   clock: the end of an update(), after its tick. (eg: for a replay, whose
+	//   ticks are events of their own)
+	void settle();
+
+	// push the board up by rowCount "garbage" rows, each full except for a hole at
+	//   holeColumn (sent by the opponent of a versus game, see VersusSession).
+	//   The currentShape is pushed up with the board, and the game is over if any
+	//   blocks are pushed off the top. (ignored once the game is over)
+	void addGarbage(int rowCount, int holeColumn);
+
+	// A tick() forces the currentShape to move (if there were no tick,
+	// the currentShape would float in position forever). This should
+	// call attemptMove() on the currentShape.  If not successful, lock()
+	// the currentShape (it can move no further), and record the fact that a
+	// shape was placed (using shapePlacedSinceLastUpdate)
+	void tick();
+
+	// STATE ACCESS (for rendering, bots, tests, etc.)
+
+	// return the gameboard (the blocks that have been locked in place)
+	const Gameboard& getBoard() const;
+	// return the tetromino that is currently falling
+	const GridTetromino& getCurrentShape() const;
+	// return the tetromino that is "on deck"
+	const GridTetromino& getNextShape() const;
+	// return the current game score (the # of rows removed)
+	int getScore() const;
+	// return the # of shapes placed (locked) since the last reset()
+	int getShapesPlaced() const;
+	// return the # of ticks since the last reset()
+	int getTicks() const;
+	// return true once a shape could not be spawned (reset() to play again)
+	bool isGameOver() const;
+	// return the virtual clock: the # of seconds passed to update() since the last reset()
+	double getElapsedSeconds() const;
+	// return the current tick rate (seconds per tick)
+	double getSecondsPerTick() const;
+	// return the virtual time since the last tick (towards the next one, eg: to draw
+	//   the falling shape between rows)
+	double getSecondsSinceLastTick() const;
+	// return the randomizer that picks this game's shapes
+	const PieceRandomizer& getRandomizer() const;
+	// return the randomizer state at the last reset(), before it picked the first shapes
+	//   (resetting to it replays the same sequence of shapes)
+	const PieceRandomizer::State& getStartRandomizerState() const;
+	// return the slowest & fastest tick rates (seconds per tick)
+	double getMaxSecondsPerTick() const;
+	double getMinSecondsPerTick() const;
+	// return how many rows the currentShape would fall if it were dropped
+	int getDropDistance() const;
+	// return the currentShape where it would land if it were dropped (the "ghost" piece)
+	//   cheap enough to call every frame: a few word operations per column.
+	GridTetromino getGhostShape() const;
+
+private:
+	// assign nextShape.setShape the next shape from the randomizer
+	void pickNextShape();
+
+	// copy the nextShape into the currentShape (through assignment)
+	//   position the currentShape to its spawn location.
+	//	 - return true/false based on isPositionLegal()
+	bool spawnNextShape();
+
+	// handle a shape that was placed since the last update:
+	//   spawn the next shape (the game is over if it can't be spawned),
+	//   pick a new next shape, remove completed rows & update the score and tick rate.
+	void processPlacedShape();
+
+	// Test if a rotation is legal on the tetromino and if so, rotate it.
+	//  To do this:
+	//	 1) create a (local) temporary copy of the tetromino
+	//	 2) rotate it (shape.rotateClockwise())
+	//	 3) test if temp rotation was legal (isPositionLegal()),
+	//      if so - rotate the original tetromino.
+	//	 4) return true/false to indicate successful movement
+	bool attemptRotate(GridTetromino& shape);
+
+	// test if a move is legal on the tetromino, if so, move it.
+	//  To do this:
+	//	 1) create a (local) temporary copy of the tetromino
+	//	 2) move it (temp.move())
+	//	 3) test if temp move was legal (isPositionLegal(),
+	//      if so - move the original.
+	//	 4) return true/false to indicate successful movement
+	bool attemptMove(GridTetromino& shape, int x, int y);
+
+	// drops the tetromino vertically as far as it can
+	//   legally go, in one move (see getDropDistance()).
+	void drop(GridTetromino& shape);
+
+	// return how many rows a tetromino can fall from its (legal) position: its
+	//   bottom profile (lowest block per column) against the board's column
+	//   surfaces (see BoardFeatures::getDropDistance())
+	int getDropDistance(const GridTetromino& shape) const;
+
+	// copy the contents (color) of the tetromino's mapped block locs to the grid.
+	//	 1) get current blockshape locs via tetromino.getBlockLocsMappedToGrid()
+	//	 2) copy the content (color) to the grid (via gameboard.setContent())
+	void lock(const GridTetromino& shape);
+
+	// return true if shape is within borders (isShapeWithinBorders())
+	//	 and the shape's mapped board locs are empty.
+	//   Make use of Gameboard's areRowMasksEmpty() and pass it the shape's mapped row masks.
+	bool isPositionLegal(const GridTetromino& shape) const;
+
+	// return true if the shape is within the left, right, and lower border of
+	//	 the grid, but *NOT* the top border. (return false otherwise)
+	//   * Ignore the upper border because we want shapes to be able to drop
+	//     in from the top of the gameboard.
+	//   All of a shape's blocks must be inside these 3 borders to return true
+	//   (tested using the shape's precomputed bounding box)
+	bool isShapeWithinBorders(const GridTetromino& shape) const;
+
+	// set secsPerTick
+	//   - basic: use MAX_SECS_PER_TICK
+	//   - advanced: base it on score (higher score results in lower secsPerTick)
+	void determineSecondsPerTick();
+
+	// MEMBER VARIABLES
+
+	// State members ---------------------------------------------
+	int score;					// the current game score.
+	int shapesPlaced;			// the # of shapes placed (locked) since the last reset()
+	int ticks;					// the # of ticks since the last reset()
+	bool gameOver;				// true once a shape could not be spawned
+	Gameboard board;			// the gameboard (grid) to represent where all the blocks are.
+	GridTetromino nextShape;	// the tetromino shape that is "on deck".
+	GridTetromino currentShape;	// the tetromino that is currently falling.
+	PieceRandomizer randomizer;	// picks the sequence of shapes for this game.
+	PieceRandomizer::State startRandomizerState;	// the randomizer state at the last reset()
+
+	static const int LEFT = -1;
+	static const int RIGHT = 1;
+	static const int DOWN = 1;
+
+	// the color of garbage rows (the tiles image has no spare color)
+	static const Tetromino::TetColor GARBAGE_COLOR = Tetromino::TetColor::BLUE_DARK;
+
+	// Time members ----------------------------------------------
+	// Note: a "tick" is the amount of time it takes a block to fall one line.
+
+	// (static: constant members would make engines unassignable, and snapshots unsafe)
+	static constexpr double MAX_SECONDS_PER_TICK = 0.75;	// start off with a slow (max) tick rate. (seconds per game tick)
+	static constexpr double MIN_SECONDS_PER_TICK = 0.20;	// this is the fastest tick pace (seconds per game tick).
+	double secondsPerTick = MAX_SECONDS_PER_TICK;	// the number of seconds per tick (changes depending on score)
+
+	double elapsedSeconds = 0.0;				// the virtual clock (total seconds passed to update())
+	double secondsSinceLastTick = 0.0;			// update this every update until it is >= secsPerTick,
+												// we then know to trigger a tick.  Reduce this var (by a tick) & repeat.
+	bool shapePlacedSinceLastUpdate = false;	// Tracks whether we have placed (locked) a shape on
+												// the gameboard since the last update
+};
+
+// a snapshot of an engine (see TetrisEngine::save())
+struct TetrisEngine::Snapshot {
+	alignas(TetrisEngine) unsigned char bytes[sizeof(TetrisEngine)];
+};
+
+static_assert(std::is_trivially_copyable<TetrisEngine>::value, "an engine is saved & restored with memcpy");
+
+#endif /* TETRISENGINE_H */
@@ -1,17 +1,20 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include "TetrisGame.h"
 #include "TestSuite.h"
 
+constexpr double TetrisGame::SIMULATION_STEP_SECONDS;
+constexpr double TetrisGame::MAX_CATCH_UP_SECONDS;
+
 // constructor
 //   initialize/assign variables
-//   reset() the game
+//   seed the engine's randomizer (each game has its own)
 //   load font from file: fonts/RedOctober.ttf
 //   setup scoreText
-TetrisGame::TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, Point gameboardOffset, Point nextShapeOffset)
-	: blockSprite(blockSprite), window(window), gameboardOffset(gameboardOffset), nextShapeOffset(nextShapeOffset)
+TetrisGame::TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, Point gameboardOffset, Point nextShapeOffset, std::uint64_t seed)
+	: engine(seed), blockSprite(blockSprite), window(window), gameboardOffset(gameboardOffset), nextShapeOffset(nextShapeOffset)
 {
-	reset();
-
 	// setup our font for drawing the score
 	if (!scoreFont.loadFromFile("fonts/RedOctober.ttf"))
 	{
@@ -22,226 +25,399 @@ TetrisGame::TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, Point
 	scoreText.setFillColor(sf::Color::White);
 	scoreText.setPosition(435, 325);
 
+	timingsText.setFont(scoreFont);
+	timingsText.setCharacterSize(14);
+	timingsText.setFillColor(sf::Color::White);
+	timingsText.setOutlineColor(sf::Color::Black);
+	timingsText.setOutlineThickness(1.f);
+	timingsText.setPosition(8, 8);
+
+	publishFrame();
+	frames.update();
+	updateScoreDisplay(frames.getReadBuffer());
+
+}
+
+// destructor - end the replay being recorded (if any)
+TetrisGame::~TetrisGame()
+{
+	recorder.stop(engine);
 }
 
 // Draw anything to do with the game,
-//   includes the board, currentShape, nextShape, score
+//   includes the board, ghost, currentShape, nextShape, score
 //   called every game loop
+//   (the board's locked blocks are drawn from a cached layer, then all the moving
+//   blocks are drawn at once, from one vertex array)
+//   The falling shape is drawn between rows, as far as the tick in progress has gone.
+//   (it draws the latest frame the game loop published, see publishFrame())
+//   The timings overlay is drawn last (when shown), its draw time isn't measured.
 void TetrisGame::draw()
 {
+	FrameTimings::Clock::time_point drawStart = FrameTimings::now();
+
+	// (no newer frame: the last one is drawn again)
+	frames.update();
+	const Frame& frame = frames.getReadBuffer();
+	drawnInputTime = frame.inputTime;
+	if (frame.engines[0].getScore() != displayedScore || frame.round != displayedRound || frame.versus != displayedVersus) {
+		updateScoreDisplay(frame);
+	}
+
+	drawGameboard(frame.engines[0].getBoard(), gameboardOffset, boardLayers[0]);
+	if (frame.versus) {
+		drawGameboard(frame.engines[1].getBoard(), remoteGameboardOffset, boardLayers[1]);
+	}
+
+	// (clear() keeps the array's memory, so a frame doesn't allocate)
+	blockVertices.clear();
+	drawPieces(frame.engines[0], gameboardOffset, nextShapeOffset, frame.unsimulatedSeconds);
+	if (frame.versus) {
+		drawPieces(frame.engines[1], remoteGameboardOffset, remoteNextShapeOffset, frame.unsimulatedSeconds);
+	}
+	window.draw(blockVertices, blockSprite.getTexture());
 
-	drawGameboard();
-	drawTetromino(currentShape, gameboardOffset);
-	drawTetromino(nextShape, nextShapeOffset);
 	window.draw(scoreText);
+	timings.record(FrameTimings::Phase::DRAW, drawStart);
+
+	// (the percentiles scan the histograms: the text changes a few times a second)
+	if (showTimings) {
+		if (framesDrawn % TIMINGS_REFRESH_FRAMES == 0) {
+			timingsText.setString(timings.getOverlayText());
+		}
+		window.draw(timingsText);
+	}
+	framesDrawn++;
+}
+
+// called once the frame drawn is on the screen (after window.display())
+//   records the present, the time between frames, & the time since the frame's new
+//   key press (the latency from the key to the screen)
+void TetrisGame::onFramePresented(FrameTimings::Clock::time_point presentStart, double now)
+{
+	timings.record(FrameTimings::Phase::PRESENT, presentStart);
+
+	FrameTimings::Clock::time_point presentEnd = FrameTimings::now();
+	if (framesDrawn > 1) {
+		timings.record(FrameTimings::Phase::FRAME, std::chrono::duration<double>(presentEnd - lastPresent).count());
+	}
+	lastPresent = presentEnd;
+
+	if (drawnInputTime > presentedInputTime) {
+		timings.record(FrameTimings::Phase::INPUT_LATENCY, now - drawnInputTime);
+		presentedInputTime = drawnInputTime;
+	}
 }
 
 // Event and game loop processing
-// handles keypress events (up, left, right, down, space)
-void TetrisGame::onKeyPressed(sf::Event event)
+// handles key presses (up, left, right, down, space, A, T)
+//   the move is queued until the simulation step (or versus frame) that covers time
+void TetrisGame::onKeyPressed(sf::Keyboard::Key key, double time)
 {
-	switch (event.key.code) {
+	TetrisEngine::Action action = TetrisEngine::Action::NONE;
+	switch (key) {
 	case sf::Keyboard::Up:
-		attemptRotate(currentShape);
+		action = TetrisEngine::Action::ROTATE;
 		break;
 
 	case sf::Keyboard::Down:
-		if (!attemptMove(currentShape, 0, DOWN)) {
-			lock(currentShape);
-			shapePlacedSinceLastGameLoop = true;
-		}
+		action = TetrisEngine::Action::DOWN;
 		break;
 
 	case sf::Keyboard::Left:
-		attemptMove(currentShape, LEFT, 0);
+		action = TetrisEngine::Action::LEFT;
 		break;
 
 	case sf::Keyboard::Right:
-		attemptMove(currentShape, RIGHT, 0);
+		action = TetrisEngine::Action::RIGHT;
 		break;
 
 	case sf::Keyboard::Space:
-		drop(currentShape);
-		lock(currentShape);
-		shapePlacedSinceLastGameLoop = true;
+		action = TetrisEngine::Action::DROP;
+		break;
+
+	case sf::Keyboard::A:
+		autoplay = !autoplay;
+		break;
+
+	case sf::Keyboard::T:
+		showTimings = !showTimings;
+		if (showTimings) {
+			timings.setEnabled(true);
+		}
 		break;
 
 	}
-	
+
+	if (action != TetrisEngine::Action::NONE) {
+		queuedActions.push_back(TimedAction{ action, time });
+	}
 }
 
 // called every game loop to handle ticks & tetromino placement (locking)
-void TetrisGame::processGameLoop(float secondsSinceLastLoop)
+//   advances the engine's clock, resets the game when it is over
+//   and keeps the score display up to date.
+//   The clock advances in fixed steps (SIMULATION_STEP_SECONDS), as many as the
+//   time since the last loop holds (up to MAX_CATCH_UP_SECONDS)
+//   Before each step, the key presses that happened before the step's end are applied.
+//   When autoplay is on, the bot plays one action every STEPS_PER_BOT_ACTION steps.
+//   The loop ends by publishing a frame for draw().
+//   (its duration, & how far the time since the last loop is from a step, are timed)
+void TetrisGame::processGameLoop(double now)
 {
-	secondsSinceLastTick += secondsSinceLastLoop;
+	FrameTimings::Clock::time_point loopStart = FrameTimings::now();
+	double secondsSinceLastLoop = std::max(0.0, now - loopTime);
+	if (loopTime > 0.0) {
+		timings.record(FrameTimings::Phase::TICK_JITTER, std::abs(secondsSinceLastLoop - SIMULATION_STEP_SECONDS));
+	}
+	loopTime = now;
 
-	if (secondsSinceLastTick > secondsPerTick) {
-		tick();
-		secondsSinceLastTick -= secondsPerTick;
+	if (versus) {
+		processVersusLoop(secondsSinceLastLoop);
+		publishFrame();
+		timings.record(FrameTimings::Phase::SIMULATION, loopStart);
+		return;
 	}
 
-	if (shapePlacedSinceLastGameLoop) {
-		if (!spawnNextShape()) {
-			reset();
+	simulationSeconds = std::min(simulationSeconds + secondsSinceLastLoop, MAX_CATCH_UP_SECONDS);
+	while (simulationSeconds >= SIMULATION_STEP_SECONDS) {
+		simulationSeconds -= SIMULATION_STEP_SECONDS;
+
+		// (the step ends simulationSeconds before now)
+		double stepEnd = now - simulationSeconds;
+		while (!queuedActions.empty() && queuedActions.front().time < stepEnd) {
+			applyAction(queuedActions.front().action);
+			inputTime = queuedActions.front().time;
+			queuedActions.pop_front();
 		}
-		else {
-			pickNextShape();
-			score += board.removeCompletedRows();
-			updateScoreDisplay();
-			determineSecondsPerTick();
-			shapePlacedSinceLastGameLoop = false;
+
+		if (autoplay && simulationSteps % STEPS_PER_BOT_ACTION == 0) {
+			applyAction(bot.nextAction(engine));
 		}
-	}
+		simulationSteps++;
 
-}
+		engine.update(SIMULATION_STEP_SECONDS);
+		recorder.recordUpdate(engine);
 
-// A tick() forces the currentShape to move (if there were no tick,
-// the currentShape would float in position forever). This should
-// call attemptMove() on the currentShape.  If not successful, lock() 
-// the currentShape (it can move no further), and record the fact that a
-// shape was placed (using shapePlacedSinceLastGameLoop)
-void TetrisGame::tick()
-{
-	if (!attemptMove(currentShape, 0, 1)) {
-		lock(currentShape);
-		shapePlacedSinceLastGameLoop = true;
+		if (engine.isGameOver()) {
+			recorder.stop(engine);
+			engine.reset();
+			startNextRecording();
+		}
 	}
 
+	publishFrame();
+	timings.record(FrameTimings::Phase::SIMULATION, loopStart);
 }
 
-// reset everything for a new game (use existing functions) 
-	//  - set the score to 0 and call updateScoreDisplay()
-	//  - call determineSecondsPerTick() to determine the tick rate.
-	//  - clear the gameboard,
-	//  - pick & spawn next shape
-	//  - pick next shape again (for the "on-deck" shape)
-void TetrisGame::reset()
+// return the engine that runs this game's rules
+//   (in a versus game: the local player's engine in the session)
+const TetrisEngine& TetrisGame::getEngine() const
 {
-	score = 0;
-	updateScoreDisplay();
-	determineSecondsPerTick();
-	board.empty();
-	pickNextShape();
-	spawnNextShape();
-	pickNextShape();
-
+	return versus ? versus->getEngine(versus->getLocalPlayer()) : engine;
 }
 
-// assign nextShape.setShape a new random shape  
-void TetrisGame::pickNextShape()
+// return the timings of the game's loops & frames
+FrameTimings& TetrisGame::getTimings()
 {
-	nextShape.setShape(Tetromino::getRandomShape());
-
+	return timings;
 }
 
-// copy the nextShape into the currentShape (through assignment)
-//   position the currentShape to its spawn location.
-//	 - return true/false based on isPositionLegal()
-bool TetrisGame::spawnNextShape()
+// record every game from now on (starting with the current one, if it hasn't
+//   started yet) to replay files named pathPrefix + game # + ".replay"
+void TetrisGame::startRecording(const std::string& pathPrefix)
 {
-	currentShape.setShape(nextShape.getShape());
-	currentShape.setGridLoc(board.getSpawnLoc());
+	replayPathPrefix = pathPrefix;
+	if (engine.getShapesPlaced() == 0 && engine.getTicks() == 0) {
+		startNextRecording();
+	}
+}
 
-	return isPositionLegal(currentShape);
+// play versus a remote player from now on, over a connection
+void TetrisGame::startVersus(VersusConnection& versusConnection, Point remoteBoardOffset, Point remoteShapeOffset, std::uint64_t nonce)
+{
+	recorder.stop(engine);
+	replayPathPrefix.clear();
+
+	versus.reset(new VersusSession(nonce));
+	connection = &versusConnection;
+	remoteGameboardOffset = remoteBoardOffset;
+	remoteNextShapeOffset = remoteShapeOffset;
+	publishFrame();
 }
 
-// Test if a rotation is legal on the tetromino and if so, rotate it. 
-//  To do this:
-//	 1) create a (local) temporary copy of the tetromino
-//	 2) rotate it (shape.rotateClockwise())
-//	 3) test if temp rotation was legal (isPositionLegal()), 
-//      if so - rotate the original tetromino.
-//	 4) return true/false to indicate successful movement
-bool TetrisGame::attemptRotate(GridTetromino& shape)
+// apply a player (or bot) action to the engine, and record it
+void TetrisGame::applyAction(TetrisEngine::Action action)
 {
-	GridTetromino temp = shape;
-	temp.rotateClockwise();
+	engine.applyAction(action);
+	recorder.recordAction(engine, action);
+}
 
-	if (isPositionLegal(temp)) {
-		shape.rotateClockwise();
-		return true;
+// start recording the game the engine was just reset for (if recording)
+void TetrisGame::startNextRecording()
+{
+	if (!replayPathPrefix.empty()) {
+		recorder.start(replayPathPrefix + std::to_string(++gamesRecorded) + ".replay", engine);
 	}
-
-	return false;
 }
 
-// test if a move is legal on the tetromino, if so, move it.
-//  To do this:
-//	 1) create a (local) temporary copy of the tetromino
-//	 2) move it (temp.move())
-//	 3) test if temp move was legal (isPositionLegal(),
-//      if so - move the original.
-//	 4) return true/false to indicate successful movement
-bool TetrisGame::attemptMove(GridTetromino& shape, int x, int y)
+// copy what is shown into a frame, & make it the latest frame for draw()
+void TetrisGame::publishFrame()
 {
-	GridTetromino temp = shape;
-	temp.move(x, y);
-
-	if (isPositionLegal(temp)) {
-		shape.move(x, y);
-		return true;
+	// (the write buffer holds an older frame: every member is written)
+	Frame& frame = frames.getWriteBuffer();
+	frame.engines[0] = getEngine();
+	frame.versus = versus != nullptr;
+	frame.unsimulatedSeconds = versus ? versusSeconds : simulationSeconds;
+	frame.inputTime = inputTime;
+	frame.round = 0;
+	frame.wins[0] = frame.wins[1] = 0;
+	if (versus) {
+		const VersusSession::State& state = versus->getState();
+		int local = versus->getLocalPlayer();
+		frame.engines[1] = versus->getEngine(1 - local);
+		frame.round = state.round;
+		frame.wins[0] = state.wins[local];
+		frame.wins[1] = state.wins[1 - local];
 	}
 
-	return false;
+	frames.publish();
 }
 
-// drops the tetromino vertically as far as it can 
-//   legally go.  Use attemptMove(). This can be done in 1 line.
-void TetrisGame::drop(GridTetromino& shape)
+// the game loop of a versus game: exchange packets with the remote player and
+//   simulate the frames due (the first key press before the frame's end, or the
+//   bot's action, in each)
+void TetrisGame::processVersusLoop(double secondsSinceLastLoop)
 {
-	while (attemptMove(shape, 0, 1)) {}
-}
+	while (connection->receive(packet)) {
+		versus->receivePacket(packet.data(), packet.size());
+	}
 
-// copy the contents (color) of the tetromino's mapped block locs to the grid.
-//     1) get the tetromino's mapped locs via tetromino.getBlockLocsMappedToGrid()
-//     2) make Gameboard's isValidPoint() methods public
-//     2) iterate through the mapped locations, if the location is a valid point 
-//         (according to the gameboard) then use Gameboard.setContent() to set the
-//         board content to be the color of the tetromino. 
-void TetrisGame::lock(const GridTetromino& shape)
-{
-	for (Point pt : shape.getBlockLocsMappedToGrid()) {
-		if (board.isValidPoint(pt)) {
-			board.setContent(pt, (int)shape.getColor());
+	// (the frames are fixed: a slow loop catches up a few, a fast one may simulate none)
+	versusSeconds = std::min(versusSeconds + secondsSinceLastLoop, MAX_CATCH_UP_FRAMES * VersusSession::FRAME_SECONDS);
+	while (versusSeconds >= VersusSession::FRAME_SECONDS) {
+		// (a frame takes one input: the first key press before its end)
+		double frameEnd = loopTime - (versusSeconds - VersusSession::FRAME_SECONDS);
+		bool keyPressed = !queuedActions.empty() && queuedActions.front().time < frameEnd;
+
+		TetrisEngine::Action action = TetrisEngine::Action::NONE;
+		if (keyPressed) {
+			action = queuedActions.front().action;
+		}
+		else if (autoplay) {
+			action = bot.nextAction(getEngine());
+		}
+
+		// (before the handshake, or too far ahead of the remote player: the input waits)
+		if (!versus->advanceFrame(action)) {
+			break;
+		}
+		if (keyPressed) {
+			inputTime = queuedActions.front().time;
+			queuedActions.pop_front();
 		}
+		versusSeconds -= VersusSession::FRAME_SECONDS;
 	}
+
+	versus->writePacket(packet);
+	connection->send(packet);
+	connection->update();
 }
 
 // Graphics methods ==============================================
 
-// Draw a tetris block sprite on the canvas		
+// Add a tetris block to the blocks of this frame (blockVertices, see draw())
 // The block position is specified in terms of 2 offsets: 
 //    1) the top left (of the gameboard in pixels)
 //    2) an x & y offset into the gameboard - in blocks (not pixels)
 //       meaning they need to be multiplied by BLOCK_WIDTH and BLOCK_HEIGHT
 //       to get the pixel offset.
-//	 1) set the block color using blockSprite.setTextureRect()
-//   2) set the block location using blockSprite.setPosition()   
-//	 3) draw the block using window.draw()
-//   For details/instructions on these 3 operations see:
-//       www.sfml-dev.org/tutorials/2.5/graphics-sprite.php
-//       use member variables: window and blockSprite (assigned in constructor)
+//	 1) the block color picks the block's rect in the tiles texture
+//   2) the block location gives the 4 corners of its quad
+//	 3) the quad is appended to blockVertices (tinted with blockTint)
+//   For details on vertex arrays see:
+//       www.sfml-dev.org/tutorials/2.5/graphics-vertex-array.php
 void TetrisGame::drawBlock(const Point& topLeft, int xOffset, int yOffset, Tetromino::TetColor color)
 {
-	blockSprite.setTextureRect(sf::IntRect(static_cast<int>(color) * BLOCK_WIDTH, 0, BLOCK_WIDTH, BLOCK_HEIGHT));
-	int x = topLeft.getX() + (xOffset)*BLOCK_WIDTH;
-	int y = topLeft.getY() + (yOffset)*BLOCK_HEIGHT;
-	blockSprite.setPosition(x, y);
-	window.draw(blockSprite);
+	float x = static_cast<float>(topLeft.getX() + (xOffset)*BLOCK_WIDTH);
+	float y = static_cast<float>(topLeft.getY() + (yOffset)*BLOCK_HEIGHT);
+	float tileX = static_cast<float>(static_cast<int>(color) * BLOCK_WIDTH);
+
+	// (clockwise from the top left, the texture's corners in the same order)
+	blockVertices.append(sf::Vertex(sf::Vector2f(x, y), blockTint, sf::Vector2f(tileX, 0.f)));
+	blockVertices.append(sf::Vertex(sf::Vector2f(x + BLOCK_WIDTH, y), blockTint, sf::Vector2f(tileX + BLOCK_WIDTH, 0.f)));
+	blockVertices.append(sf::Vertex(sf::Vector2f(x + BLOCK_WIDTH, y + BLOCK_HEIGHT), blockTint, sf::Vector2f(tileX + BLOCK_WIDTH, BLOCK_HEIGHT)));
+	blockVertices.append(sf::Vertex(sf::Vector2f(x, y + BLOCK_HEIGHT), blockTint, sf::Vector2f(tileX, BLOCK_HEIGHT)));
+}
+
+// Draw an engine's moving blocks: its ghost, currentShape & nextShape
+//   (the currentShape is drawn lower by the part of a row its tick has gone)
+void TetrisGame::drawPieces(const TetrisEngine& shownEngine, const Point& boardOffset, const Point& shapeOffset, double unsimulatedSeconds)
+{
+	// the ghost piece shows where the currentShape will land
+	blockTint = sf::Color(255, 255, 255, GHOST_ALPHA);
+	drawTetromino(shownEngine.getGhostShape(), boardOffset);
+	blockTint = sf::Color::White;
+
+	Point fallingOffset(boardOffset.getX(), boardOffset.getY() + getFallOffset(shownEngine, unsimulatedSeconds));
+	drawTetromino(shownEngine.getCurrentShape(), fallingOffset);
+	drawTetromino(shownEngine.getNextShape(), shapeOffset);
+}
+
+// return how many pixels below its row to draw the falling currentShape
+int TetrisGame::getFallOffset(const TetrisEngine& shownEngine, double unsimulatedSeconds) const
+{
+	if (shownEngine.isGameOver() || shownEngine.getDropDistance() == 0) {
+		return 0;
+	}
+
+	double fraction = (shownEngine.getSecondsSinceLastTick() + unsimulatedSeconds) / shownEngine.getSecondsPerTick();
+	return static_cast<int>(std::max(0.0, std::min(fraction, 1.0)) * BLOCK_HEIGHT);
 }
 
 // Draw the gameboard blocks on the window
-//   Iterate through each row & col, use drawBlock() to 
-//   draw a block if it isn't empty.
-void TetrisGame::drawGameboard()
+//   The blocks are drawn into the layer's texture (off-screen), and the window only
+//   draws that texture (one quad). The texture is only redrawn when the board
+//   changed since: a different version or hash (see Gameboard::getVersion()).
+//   To redraw it, iterate through each row & col, use drawBlock() to 
+//   add a block if it isn't empty.
+//   (if the layer's texture can't be created, the blocks are drawn every frame)
+void TetrisGame::drawGameboard(const Gameboard& board, const Point& topLeft, BoardLayer& layer)
 {
-	for (int col = 0; col < Gameboard::MAX_Y; col++) {
-		for (int row = 0; row < Gameboard::MAX_X; row++) {
-			if (board.getContent(row, col) != Gameboard::EMPTY_BLOCK) {
-				drawBlock(gameboardOffset, row, col, (Tetromino::TetColor)board.getContent(row, col));
+	if (!layer.created && !layer.failed) {
+		layer.created = layer.texture.create(Gameboard::MAX_X * BLOCK_WIDTH, Gameboard::MAX_Y * BLOCK_HEIGHT);
+		layer.failed = !layer.created;
+	}
+
+	bool cached = layer.created;
+	if (!cached || !layer.drawn || layer.version != board.getVersion() || layer.hash != board.getHash()) {
+		// (in the layer, the board's top left is at 0,0)
+		blockVertices.clear();
+		Point origin = cached ? Point(0, 0) : topLeft;
+		for (int col = 0; col < Gameboard::MAX_Y; col++) {
+			for (int row = 0; row < Gameboard::MAX_X; row++) {
+				if (board.getContent(row, col) != Gameboard::EMPTY_BLOCK) {
+					drawBlock(origin, row, col, (Tetromino::TetColor)board.getContent(row, col));
+				}
 			}
 		}
+
+		if (!cached) {
+			window.draw(blockVertices, blockSprite.getTexture());
+			return;
+		}
+
+		layer.texture.clear(sf::Color::Transparent);
+		layer.texture.draw(blockVertices, blockSprite.getTexture());
+		layer.texture.display();
+		layer.drawn = true;
+		layer.version = board.getVersion();
+		layer.hash = board.getHash();
 	}
+
+	sf::Sprite layerSprite(layer.texture.getTexture());
+	layerSprite.setPosition(static_cast<float>(topLeft.getX()), static_cast<float>(topLeft.getY()));
+	window.draw(layerSprite);
 }
 
 // Draw a tetromino on the window
@@ -257,56 +433,17 @@ void TetrisGame::drawTetromino(const GridTetromino& tetromino, const Point& topL
 }
 
 // update the score display
-// form a string "score: ##" to display the current score
+// form a string "score: ##" to display the current score (of a frame)
 // user scoreText.setString() to display it.
-void TetrisGame::updateScoreDisplay()
+void TetrisGame::updateScoreDisplay(const Frame& frame)
 {
-	std::string str = "score: " + std::to_string(score);
-	scoreText.setString(str);
-}
-
-// State & gameplay/logic methods ================================
-
-// return true if shape is within borders (isShapeWithinBorders())
-//	 and the shape's mapped board locs are empty.
-//   Make use of Gameboard's areLocsEmpty() and pass it the shape's mapped locs.
-bool TetrisGame::isPositionLegal(const GridTetromino& shape) const
-{
-	if (isShapeWithinBorders(shape) && board.areLocsEmpty(shape.getBlockLocsMappedToGrid())) {
-		return true;
+	displayedScore = frame.engines[0].getScore();
+	displayedRound = frame.round;
+	displayedVersus = frame.versus;
+	std::string str = "score: " + std::to_string(displayedScore);
+	if (frame.versus) {
+		// (the rounds won: the local player's first)
+		str += "\nwins: " + std::to_string(frame.wins[0]) + " - " + std::to_string(frame.wins[1]);
 	}
-	return false;
-}
-
-// return true if the shape is within the left, right, and lower border of
-//	 the grid, but *NOT* the top border. (return false otherwise)
-//   * Ignore the upper border because we want shapes to be able to drop
-//     in from the top of the gameboard.
-//   All of a shape's blocks must be inside these 3 borders to return true
-bool TetrisGame::isShapeWithinBorders(const GridTetromino& shape) const
-{
-	for (Point pt : shape.getBlockLocsMappedToGrid()) {
-		if (pt.getX() < 0 
-			|| pt.getX() >= board.MAX_X
-			|| pt.getY() >= board.MAX_Y)
-		{
-			return false;
-		}
-	}
-	return true;
+	scoreText.setString(str);
 }
-
-
-// set secsPerTick 
-//   - basic: use MAX_SECS_PER_TICK
-//   - advanced: base it on score (higher score results in lower secsPerTick)
-void TetrisGame::determineSecondsPerTick()
-{
-	if (secondsPerTick < MIN_SECONDS_PER_TICK) {
-		secondsPerTick = MIN_SECONDS_PER_TICK;
-	}
-	else {
-		secondsPerTick = MAX_SECONDS_PER_TICK - (score * 0.1);
-	}
-
-}
\ No newline at end of file
@@ -1,24 +1,48 @@
-// This class encapsulates the tetris game and its drawing routines, gameplay, & control logic.
+// This class encapsulates the tetris game and its drawing routines, & control logic.
 // This class was designed so with the idea of potentially instantiating 2 of them
 // and have them run side by side (player vs player).
 // So, anything you would need for an individual tetris game has been included here.
 // Anything you might use between games (like the background, or the sprite used for 
 // rendering a tetromino block) was left in main.cpp
+//
+// The rules of the game (the board, spawning, moving & placing tetrominoes, ticks
+// and score) live in TetrisEngine, which has no SFML dependency. This class wraps
+// an engine, feeding it the player's key presses and the time between game loops.
 // 
 // This class is responsible for:
-//   - setting up the board,
 //	 - drawing game elements to the screen
-//   - spawning tetrominoes,
 //   - handling user input,
-//   - moving and placing tetrominoes 
+//   - letting the BeamSearchBot play (autoplay, toggled with the A key)
+//   - recording each game to a replay file (see startRecording())
+//   - playing versus a remote player (see startVersus()): the game is then run by
+//     a VersusSession, and both players' games are drawn
+//   - resetting the game when it is over
+//   - measuring its loops (see getTimings()), & showing the timings in an overlay
+//     (toggled with the T key)
+//
+// The game loop (processGameLoop()) & the drawing (draw()) can run on different
+// threads (see SimulationThread): each game loop publishes a frame, a snapshot of
+// what is shown, through a TripleBuffer, and draw() only draws the latest frame.
+// So a slow draw never delays the game, and neither thread ever waits for the other.
+// (the key presses, the loop & the start...() calls belong to the game loop's thread)
 //
 //  [expected .cpp size: ~ 275 lines]
 
 #ifndef TETRISGAME_H
 #define TETRISGAME_H
 
+#include "BeamSearchBot.h"
+#include "FrameTimings.h"
 #include "Gameboard.h"
 #include "GridTetromino.h"
+#include "ReplayRecorder.h"
+#include "TetrisEngine.h"
+#include "TripleBuffer.h"
+#include "VersusConnection.h"
+#include "VersusSession.h"
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <SFML/Graphics.hpp>
 
 
@@ -28,99 +52,157 @@ public:
 	// STATIC CONSTANTS
 	static const int BLOCK_WIDTH = 32;			// pixel width of a tetris block
 	static const int BLOCK_HEIGHT = 32;			// pixel height of a tetris block
+	static const int GHOST_ALPHA = 80;			// opacity of the ghost piece (0-255)
+	static const int MAX_CATCH_UP_FRAMES = 4;	// the most versus frames simulated in one game loop
+	static constexpr double SIMULATION_STEP_SECONDS = 1.0 / 240.0;	// the fixed timestep of the engine's clock
+															//   (shorter than any tick: at most a tick per step)
+	static constexpr double MAX_CATCH_UP_SECONDS = 0.25;	// the most time simulated in one game loop
+															//   (after a longer stall the game slows down instead)
+	static const int STEPS_PER_BOT_ACTION = 8;				// autoplay's pace (30 actions per second)
+	static const int TIMINGS_REFRESH_FRAMES = 15;			// the timings overlay's text changes every # frames
 
 	// MEMBER FUNCTIONS
 
 	// constructor
 	//   initialize/assign variables
-	//   reset() the game
+	//   seed the engine's randomizer (each game has its own)
 	//   load font from file: fonts/RedOctober.ttf
 	//   setup scoreText
-	TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, Point gameboardOffset, Point nextShapeOffset);	 
+	TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, Point gameboardOffset, Point nextShapeOffset, std::uint64_t seed);	 
+
+	// destructor - end the replay being recorded (if any)
+	~TetrisGame();
 
 	// Draw anything to do with the game,
-	//   includes the board, currentShape, nextShape, score
+	//   includes the board, ghost, currentShape, nextShape, score
 	//   called every game loop
-	void draw();								
+	//   (the board's locked blocks are drawn from a cached layer, then all the moving
+	//   blocks are drawn at once, from one vertex array)
+	//   The falling shape is drawn between rows, as far as the tick in progress has gone.
+	//   (it draws the latest frame the game loop published, see publishFrame())
+	//   The timings overlay is drawn last (when shown), its draw time isn't measured.
+	void draw();
+
+	// called once the frame drawn is on the screen (after window.display())
+	//   records the present (since presentStart), the time between frames, &
+	//   (if the frame shows a new key press) the time since that key press
+	//   now: the time on the game clock (see processGameLoop())
+	void onFramePresented(FrameTimings::Clock::time_point presentStart, double now);								
 
 	// Event and game loop processing
-	// handles keypress events (up, left, right, down, space)
-	void onKeyPressed(sf::Event event);
+	// handles key presses (up, left, right, down, space)
+	//   A toggles autoplay, T toggles the timings overlay (& turns the timings on)
+	//   time: when the key was pressed, on the game clock (see processGameLoop(),
+	//   eg: from the InputThread). The move is applied in the simulation step (or
+	//   versus frame) that covers that time, rather than at the next frame.
+	void onKeyPressed(sf::Keyboard::Key key, double time);
 
 	// called every game loop to handle ticks & tetromino placement (locking)
-	void processGameLoop(float secondsSinceLastLoop);
+	//   advances the engine's clock, resets the game when it is over
+	//   and keeps the score display up to date.
+	//   now: the time of this loop on the game clock (seconds), the time since the
+	//   last loop is simulated.
+	//   The clock advances in fixed steps (SIMULATION_STEP_SECONDS), as many as the
+	//   time since the last loop holds (up to MAX_CATCH_UP_SECONDS), so the game runs
+	//   at the same speed whatever the frame rate, and every tick that is due happens.
+	//   (the rest of the time is simulated by the next loop)
+	//   Before each step, the key presses that happened before the step's end are applied.
+	//   When autoplay is on, the bot plays one action every STEPS_PER_BOT_ACTION steps.
+	//   The loop ends by publishing a frame for draw().
+	//   (its duration, & how far the time since the last loop is from a step, are timed)
+	void processGameLoop(double now);
+
+	// return the engine that runs this game's rules
+	//   (in a versus game: the local player's engine in the session)
+	const TetrisEngine& getEngine() const;
+
+	// return the timings of the game's loops & frames (off until enabled, see FrameTimings)
+	FrameTimings& getTimings();
+
+	// record every game from now on (starting with the current one, if it hasn't
+	//   started yet) to replay files named pathPrefix + game # + ".replay"
+	void startRecording(const std::string& pathPrefix);
 
-	// A tick() forces the currentShape to move (if there were no tick,
-	// the currentShape would float in position forever). This should
-	// call attemptMove() on the currentShape.  If not successful, lock() 
-	// the currentShape (it can move no further), and record the fact that a
-	// shape was placed (using shapePlacedSinceLastGameLoop)
-	void tick();
+	// play versus a remote player from now on, over a connection (see VersusSession):
+	//   the key presses (or the bot) play the local game, one input per frame, and the
+	//   remote player's game is drawn at remoteGameboardOffset & remoteNextShapeOffset.
+	//   nonce: a random number for the handshake (see VersusSession())
+	//   (versus games aren't recorded)
+	void startVersus(VersusConnection& versusConnection, Point remoteGameboardOffset, Point remoteNextShapeOffset, std::uint64_t nonce);
 
 private:
-	// reset everything for a new game (use existing functions) 
-	//  - set the score to 0 and call updateScoreDisplay()
-	//  - call determineSecondsPerTick() to determine the tick rate.
-	//  - clear the gameboard,
-	//  - pick & spawn next shape
-	//  - pick next shape again (for the "on-deck" shape)
-	void reset();
-
-	// assign nextShape.setShape a new random shape  
-	void pickNextShape();
-	
-	// copy the nextShape into the currentShape (through assignment)
-	//   position the currentShape to its spawn location.
-	//	 - return true/false based on isPositionLegal()
-	bool spawnNextShape();																	
-
-	// Test if a rotation is legal on the tetromino and if so, rotate it. 
-	//  To do this:
-	//	 1) create a (local) temporary copy of the tetromino
-	//	 2) rotate it (shape.rotateClockwise())
-	//	 3) test if temp rotation was legal (isPositionLegal()), 
-	//      if so - rotate the original tetromino.
-	//	 4) return true/false to indicate successful movement
-	bool attemptRotate(GridTetromino &shape);
-   
-	// test if a move is legal on the tetromino, if so, move it.
-	//  To do this:
-	//	 1) create a (local) temporary copy of the tetromino
-	//	 2) move it (temp.move())
-	//	 3) test if temp move was legal (isPositionLegal(),
-	//      if so - move the original.
-	//	 4) return true/false to indicate successful movement
-	bool attemptMove(GridTetromino &shape, int x, int y);												
-
-	// drops the tetromino vertically as far as it can 
-	//   legally go.  Use attemptMove(). This can be done in 1 line.
-	void drop(GridTetromino &shape);
-
-	// copy the contents (color) of the tetromino's mapped block locs to the grid.
-	//	 1) get current blockshape locs via tetromino.getBlockLocsMappedToGrid()
-	//	 2) copy the content (color) to the grid (via gameboard.setContent()) 
-	void lock(const GridTetromino &shape);
-	
+	// a board's locked blocks, drawn off-screen (see drawGameboard())
+	struct BoardLayer {
+		sf::RenderTexture texture;
+		bool created = false;		// true once the texture is created
+		bool failed = false;		// true if it can't be
+		bool drawn = false;			// true once the texture holds the blocks of version & hash
+		std::uint32_t version = 0;	// the board version drawn
+		std::uint64_t hash = 0;		// (& its hash: a snapshot can bring an old version back)
+	};
+
+	// a snapshot of what draw() shows (copied: an engine is trivially copyable)
+	struct Frame {
+		TetrisEngine engines[VersusSession::PLAYER_COUNT];	// (the local player's first)
+		bool versus = false;				// true if the remote player's engine is shown too
+		double unsimulatedSeconds = 0.0;	// the time passed that the engines haven't simulated
+		double inputTime = 0.0;				// the time of the latest key press applied (0: none yet)
+		int round = 0;						// the versus round & the rounds won (local player first)
+		int wins[VersusSession::PLAYER_COUNT] = {};
+	};
+
+	// an action from a key press, & the time of the key press (on the game clock)
+	struct TimedAction {
+		TetrisEngine::Action action;
+		double time;
+	};
+
+	// apply a player (or bot) action to the engine, and record it
+	void applyAction(TetrisEngine::Action action);
+
+	// the game loop of a versus game: exchange packets with the remote player and
+	//   simulate the frames due (the first key press before the frame's end, or the
+	//   bot's action, in each)
+	void processVersusLoop(double secondsSinceLastLoop);
+
+	// start recording the game the engine was just reset for (if recording)
+	void startNextRecording();
+
+	// copy what is shown into a frame, & make it the latest frame for draw()
+	void publishFrame();
+
 	// Graphics methods ==============================================
 	
-	// Draw a tetris block sprite on the canvas		
+	// Add a tetris block to the blocks of this frame (blockVertices, see draw())
 	// The block position is specified in terms of 2 offsets: 
 	//    1) the top left (of the gameboard in pixels)
 	//    2) an x & y offset into the gameboard - in blocks (not pixels)
 	//       meaning they need to be multiplied by BLOCK_WIDTH and BLOCK_HEIGHT
 	//       to get the pixel offset.
-	//	 1) set the block color using blockSprite.setTextureRect()
-	//   2) set the block location using blockSprite.setPosition()   
-	//	 3) draw the block using window.draw()
-	//   For details/instructions on these 3 operations see:
-	//       www.sfml-dev.org/tutorials/2.5/graphics-sprite.php
-	//       use member variables: window and blockSprite (assigned in constructor)
+	//	 1) the block color picks the block's rect in the tiles texture
+	//   2) the block location gives the 4 corners of its quad
+	//	 3) the quad is appended to blockVertices (tinted with blockTint)
+	//   For details on vertex arrays see:
+	//       www.sfml-dev.org/tutorials/2.5/graphics-vertex-array.php
 	void drawBlock(const Point& topLeft, int xOffset, int yOffset, Tetromino::TetColor color);
 										
+	// Draw an engine's moving blocks: its ghost, currentShape & nextShape
+	//   unsimulatedSeconds: the time that has passed but the engine hasn't simulated yet
+	//   (the currentShape is drawn lower by the part of a row its tick has gone)
+	void drawPieces(const TetrisEngine& shownEngine, const Point& boardOffset, const Point& shapeOffset, double unsimulatedSeconds);
+
+	// return how many pixels below its row to draw the falling currentShape:
+	//   the fraction of its tick that has passed (0 if it can't fall)
+	int getFallOffset(const TetrisEngine& shownEngine, double unsimulatedSeconds) const;
+
 	// Draw the gameboard blocks on the window
-	//   Iterate through each row & col, use drawBlock() to 
-	//   draw a block if it isn't empty.
-	void drawGameboard();
+	//   The blocks are drawn into the layer's texture (off-screen), and the window only
+	//   draws that texture (one quad). The texture is only redrawn when the board
+	//   changed since: a different version or hash (see Gameboard::getVersion()).
+	//   To redraw it, iterate through each row & col, use drawBlock() to 
+	//   add a block if it isn't empty.
+	//   (if the layer's texture can't be created, the blocks are drawn every frame)
+	void drawGameboard(const Gameboard& board, const Point& topLeft, BoardLayer& layer);
 	
 	// Draw a tetromino on the window
 	//	 Iterate through each mapped loc & drawBlock() for each.
@@ -129,62 +211,59 @@ private:
 	void drawTetromino(const GridTetromino& tetromino, const Point& topLeft);
 	
 	// update the score display
-	// form a string "score: ##" to display the current score
+	// form a string "score: ##" to display the current score (of a frame)
 	// user scoreText.setString() to display it.
-	void updateScoreDisplay();
-
-	// State & gameplay/logic methods ================================
+	void updateScoreDisplay(const Frame& frame);
 
-	// return true if shape is within borders (isShapeWithinBorders())
-	//	 and the shape's mapped board locs are empty.
-	//   Make use of Gameboard's areLocsEmpty() and pass it the shape's mapped locs.
-	bool isPositionLegal(const GridTetromino &shape) const;					
-		
-	// return true if the shape is within the left, right, and lower border of
-	//	 the grid, but *NOT* the top border. (return false otherwise)
-	//   * Ignore the upper border because we want shapes to be able to drop
-	//     in from the top of the gameboard.
-	//   All of a shape's blocks must be inside these 3 borders to return true
-	bool isShapeWithinBorders(const GridTetromino &shape) const;
+	// MEMBER VARIABLES
 
+	// State members ---------------------------------------------
+	TetrisEngine engine;		// the game rules: board, tetrominoes, score & timing.
+	BeamSearchBot bot;			// plays the game when autoplay is on.
+	bool autoplay = false;		// toggled by the A key.
+	ReplayRecorder recorder;	// records the games (when replayPathPrefix isn't empty).
+	std::string replayPathPrefix;
+	int gamesRecorded = 0;
+	double loopTime = 0.0;				// the time of the last game loop (on the game clock)
+	double simulationSeconds = 0.0;		// the time passed that the engine hasn't simulated yet (less than a step)
+	std::deque<TimedAction> queuedActions;	// the key presses not yet applied (oldest first)
+	double inputTime = 0.0;				// the time of the latest key press applied
+	std::uint64_t simulationSteps = 0;	// the # of fixed steps simulated
 
-	// set secsPerTick 
-	//   - basic: use MAX_SECS_PER_TICK
-	//   - advanced: base it on score (higher score results in lower secsPerTick)
-	void determineSecondsPerTick();
+	// Versus members --------------------------------------------
+	std::unique_ptr<VersusSession> versus;			// runs the versus game (if playing versus)
+	VersusConnection* connection = nullptr;			// carries the versus packets
+	double versusSeconds = 0.0;						// the time not yet simulated in frames
+	std::vector<std::uint8_t> packet;
+	Point remoteGameboardOffset;					// pixel XY offset of the remote player's gameboard
+	Point remoteNextShapeOffset;					// (& nextShape)
 
-	// MEMBER VARIABLES
+	// Frame members (written by the game loop, read by draw()) --
+	TripleBuffer<Frame> frames;
+	FrameTimings timings;				// (each phase written by one of the threads)
+	std::atomic<bool> showTimings{ false };	// toggled by the T key.
 
-	// State members ---------------------------------------------
-	int score;					// the current game score.
-    Gameboard board;			// the gameboard (grid) to represent where all the blocks are.
-    GridTetromino nextShape;	// the tetromino shape that is "on deck".
-    GridTetromino currentShape;	// the tetromino that is currently falling.
-
-	int LEFT{ -1 };
-	int RIGHT{ 1 };
-	int DOWN{ 1 };
-	
 	// Graphics members ------------------------------------------
 	const Point gameboardOffset;	// pixel XY offset of the gameboard on the screen
 	const Point nextShapeOffset;	// pixel XY offset to the nextShape
-	sf::Sprite& blockSprite;		// the sprite used for all the blocks.
+	sf::Sprite& blockSprite;		// the sprite used for all the blocks (its texture: the tiles).
+	sf::VertexArray blockVertices{ sf::Quads };	// this frame's blocks, a textured quad each,
+												//   drawn with a single draw call.
+	sf::Color blockTint = sf::Color::White;		// the color the blocks are added with.
+	BoardLayer boardLayers[VersusSession::PLAYER_COUNT];	// the locked blocks of each board shown.
 	sf::RenderWindow& window;		// the window that we are drawing on.
 
 	sf::Font scoreFont;				// SFML font for displaying the score.
 	sf::Text scoreText;				// SFML text object for displaying the score
-									
-	// Time members ----------------------------------------------
-	// Note: a "tick" is the amount of time it takes a block to fall one line.
-
-	const double MAX_SECONDS_PER_TICK = 0.75;		// start off with a slow (max) tick rate. (seconds per game tick)
-	const double MIN_SECONDS_PER_TICK = 0.20;		// this is the fastest tick pace (seconds per game tick).
-	double secondsPerTick = MAX_SECONDS_PER_TICK;	// the number of seconds per tick (changes depending on score)
-											
-	double secondsSinceLastTick = 0.0;			// update this every game loop until it is >= secsPerTick,
-												// we then know to trigger a tick.  Reduce this var (by a tick) & repeat.
-	bool shapePlacedSinceLastGameLoop = false;	// Tracks whether we have placed (locked) a shape on
-												// the gameboard in the current gameloop
+	int displayedScore = 0;			// the score shown by scoreText.
+	int displayedRound = 0;			// (& the versus round)
+	bool displayedVersus = false;	// (& whether the rounds won are shown)
+	sf::Text timingsText;			// the timings overlay (drawn with scoreFont).
+	int framesDrawn = 0;
+	double drawnInputTime = 0.0;	// the inputTime of the frame drawn (see onFramePresented())
+	double presentedInputTime = 0.0;	// (& of the last frame presented with a new key press)
+	FrameTimings::Clock::time_point lastPresent;	// (the time between frames starts here)
+
 };
 
 #endif /* TETRISGAME_H */
@@ -1,11 +1,24 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <stdlib.h>
 
 #include "Tetromino.h"
 #include "Point.h"
 
+static_assert(static_cast<int>(Tetromino::TetShape::COUNT) == TetrominoTable::SHAPE_COUNT,
+	"the TetrominoTable must have an entry for every TetShape");
+
+// the color of each shape (in TetShape order: S, Z, L, J, O, I, T)
+static const Tetromino::TetColor SHAPE_COLORS[] = {
+	Tetromino::TetColor::RED,
+	Tetromino::TetColor::GREEN,
+	Tetromino::TetColor::ORANGE,
+	Tetromino::TetColor::BLUE_DARK,
+	Tetromino::TetColor::YELLOW,
+	Tetromino::TetColor::BLUE_LIGHT,
+	Tetromino::TetColor::PURPLE
+};
+
 
 Tetromino::Tetromino()
 {
@@ -14,7 +27,7 @@ Tetromino::Tetromino()
 }
 Tetromino::TetColor Tetromino::getColor() const {
 
-	return color;
+	return SHAPE_COLORS[static_cast<int>(shape)];
 }
 
 Tetromino::TetShape Tetromino::getShape() const {
@@ -24,57 +37,40 @@ Tetromino::TetShape Tetromino::getShape() const {
 
 void Tetromino::setShape(TetShape shape) {
 
-	blockLocs.clear();
 	this->shape = shape;
-	switch (shape) {
-
-	case Tetromino::TetShape::O:
-		blockLocs = { Point(0, 0), Point(1, 1), Point(0,1), Point(1,0) };
-		color = TetColor::YELLOW;
-		break;
-
-	case Tetromino::TetShape::I:
-		blockLocs = { Point(0, 0), Point(0, -1), Point(0,1), Point(0,2) };
-		color = TetColor::BLUE_LIGHT;
-		break;
-
-	case Tetromino::TetShape::S:
-		blockLocs = { Point(0, 0), Point(-1, 0), Point(0,1), Point(1,1) };
-		color = TetColor::RED;
-		break;
-
-	case Tetromino::TetShape::Z:
-		blockLocs = { Point(0, 0), Point(-1, 1), Point(0,1), Point(1,0) };
-		color = TetColor::GREEN;
-		break;
-
-	case Tetromino::TetShape::L:
-		blockLocs = { Point(0, 0), Point(0, 1), Point(0,-1), Point(1, -1) };
-		color = TetColor::ORANGE;
-		break;
-
-	case Tetromino::TetShape::J:
-		blockLocs = { Point(0, 0), Point(0, 1), Point(0,-1), Point(-1, -1) };
-		color = TetColor::BLUE_DARK;
-		break;
-
-	case Tetromino::TetShape::T:
-		blockLocs = { Point(0, 0), Point(-1, 0), Point(1, 0), Point(0,-1) };
-		color = TetColor::PURPLE;
-		break;
-	
-	}
+	rotation = 0;
+}
 
+int Tetromino::getRotation() const {
+
+	return rotation;
 }
 
+void Tetromino::setRotation(int rotation) {
+
+	this->rotation = ((rotation % ROTATION_COUNT) + ROTATION_COUNT) % ROTATION_COUNT;
+}
 
 void Tetromino::rotateClockwise() {
 
-	for (Point &pt : blockLocs) {
-		pt.swapXY();
-		pt.multiplyY(-1);
+	rotation = (rotation + 1) % ROTATION_COUNT;
+}
+
+const TetrominoTable::Orientation& Tetromino::getOrientation() const {
+
+	return TetrominoTable::getOrientation(static_cast<int>(shape), rotation);
+}
+
+Tetromino::BlockLocs Tetromino::getBlockLocs() const {
+
+	const TetrominoTable::Orientation& orientation = getOrientation();
+	BlockLocs locs;
+
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		locs[i].setXY(orientation.blockX[i], orientation.blockY[i]);
 	}
 
+	return locs;
 }
 
 void Tetromino::printToConsole() const {
@@ -88,7 +84,7 @@ void Tetromino::printToConsole() const {
 
 			bool found = false;
 
-			for (Point pt : blockLocs) {
+			for (Point pt : getBlockLocs()) {
 
 				if (pt.getX() == row && pt.getY() == col) {
 					found = true;
@@ -106,8 +102,3 @@ void Tetromino::printToConsole() const {
 		std::cout << "\n";
 	}
 }
-
-Tetromino::TetShape Tetromino::getRandomShape() {
-	int shape = rand() % (int)TetShape::COUNT;
-	return (Tetromino::TetShape)shape;
-}
\ No newline at end of file
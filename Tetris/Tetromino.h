@@ -1,6 +1,7 @@
 #pragma once
-#include <vector>
+#include <array>
 #include "Point.h"
+#include "TetrominoTable.h"
 
 class Tetromino {
 
@@ -23,32 +24,38 @@ public:
 		S, Z, L, J, O, I, T, COUNT
 	};
 
-	static TetShape getRandomShape();
+	// CONSTANTS
+	static const int BLOCK_COUNT = TetrominoTable::BLOCK_COUNT;			// every tetromino is made of 4 blocks
+	static const int ROTATION_COUNT = TetrominoTable::ROTATION_COUNT;	// every tetromino has 4 orientations
+
+	// the block locations of a tetromino, stored inline (no heap allocation)
+	typedef std::array<Point, BLOCK_COUNT> BlockLocs;
 
 private:
-	TetColor color;
 	TetShape shape;
-
-protected:
-	std::vector<Point> blockLocs;
+	int rotation;	// the index of the current orientation in the TetrominoTable (0 to ROTATION_COUNT-1)
 
 public:
 	Tetromino();
 	TetColor getColor() const;
 	TetShape getShape() const;
 	// set the shape
-	// - clear any blockLocs set previously
-	// - set the blockLocs for the shape
-	// - set the color for the shape
+	// - reset the rotation to the spawn orientation (0)
+	// (the blockLocs and color are looked up from the shape, see getBlockLocs() and getColor())
 	void setShape(TetShape shape);//
+	// return the index of the current orientation (0 to ROTATION_COUNT-1)
+	int getRotation() const;
+	// set the index of the current orientation (wrapped into 0 to ROTATION_COUNT-1)
+	void setRotation(int rotation);
 	// rotate the shape 90 degrees around [0,0] (clockwise)
-	// to do this:
-	// - iterate through blockLocs
-	// - rotate each Point 90 degrees around [0,0]
-	// hint: rotate the point [1,2] clockwise around [0,0] and note
-	// how the x,y values change. There are 2 functions in the Point
-	// class that can be used to accomplish a rotation.
+	//   every orientation is precomputed in the TetrominoTable, so this
+	//   simply advances the rotation index.
 	void rotateClockwise();
+	// return the precomputed geometry (block offsets, bounding box, row masks)
+	//   of the current shape and rotation
+	const TetrominoTable::Orientation& getOrientation() const;
+	// return the block locations of the current shape and rotation (relative to [0,0])
+	BlockLocs getBlockLocs() const;
 	// print a grid to display the current shape
 	// to do this: print out a grid of text to represent a co-ordinate
 	// system. Start at top left [-3,3] go to bottom right [3,-3]
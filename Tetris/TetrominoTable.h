@@ -0,0 +1,160 @@
+// The TetrominoTable holds the geometry of every tetromino shape in every orientation.
+// The table is generated at compile time (constexpr) from the spawn orientation of each
+// shape, by rotating it 90 degrees clockwise around [0,0] (the same rotation a Point
+// gets from swapXY() followed by multiplyY(-1)).
+//
+// A tetromino then only needs to carry a shape index and a rotation index:
+//  - rotating it is an index increment,
+//  - its block offsets, bounding box and per-row bitmasks are a table lookup.
+//
+// The table knows nothing about the Tetromino class (or about colors), it is indexed by
+// the integer value of a Tetromino::TetShape. Keep SPAWN_BLOCKS in TetShape order.
+
+#ifndef TETROMINOTABLE_H
+#define TETROMINOTABLE_H
+
+#include <cstdint>
+
+namespace TetrominoTable {
+
+	// CONSTANTS
+	const int SHAPE_COUNT = 7;		// the number of shapes (Tetromino::TetShape::COUNT)
+	const int ROTATION_COUNT = 4;	// the number of orientations of each shape
+	const int BLOCK_COUNT = 4;		// the number of blocks in each shape
+
+	// the geometry of one shape in one orientation.
+	//   block offsets and the bounding box are relative to the tetromino's [0,0].
+	//   rowMasks[i] is the occupancy of bounding box row minY+i, where bit 0 is column minX
+	//   (the same bit layout as a Gameboard::RowMask once shifted by the mapped minX).
+	//   columnBottoms[i] is the y of the lowest block in column minX+i (the shape's bottom
+	//   profile, used to find how far it can drop).
+	//   canonicalRotation is the lowest rotation of the shape that covers the same cells
+	//   (eg: an O looks the same in every rotation, an I looks the same in rotations 0 & 2).
+	struct Orientation {
+		std::int8_t blockX[BLOCK_COUNT];
+		std::int8_t blockY[BLOCK_COUNT];
+		std::int8_t minX;
+		std::int8_t maxX;
+		std::int8_t minY;
+		std::int8_t maxY;
+		std::uint16_t rowMasks[BLOCK_COUNT];
+		std::int8_t columnBottoms[BLOCK_COUNT];
+		std::int8_t canonicalRotation;
+	};
+
+	// every orientation of every shape: orientations[shape][rotation]
+	struct Table {
+		Orientation orientations[SHAPE_COUNT][ROTATION_COUNT];
+	};
+
+	// the blocks of each shape in its spawn orientation (rotation 0) as [x,y] pairs,
+	//   in Tetromino::TetShape order: S, Z, L, J, O, I, T
+	constexpr std::int8_t SPAWN_BLOCKS[SHAPE_COUNT][BLOCK_COUNT][2] = {
+		{ { 0, 0 }, { -1, 0 }, { 0, 1 }, { 1, 1 } },	// S
+		{ { 0, 0 }, { -1, 1 }, { 0, 1 }, { 1, 0 } },	// Z
+		{ { 0, 0 }, { 0, 1 }, { 0, -1 }, { 1, -1 } },	// L
+		{ { 0, 0 }, { 0, 1 }, { 0, -1 }, { -1, -1 } },	// J
+		{ { 0, 0 }, { 1, 1 }, { 0, 1 }, { 1, 0 } },		// O
+		{ { 0, 0 }, { 0, -1 }, { 0, 1 }, { 0, 2 } },	// I
+		{ { 0, 0 }, { -1, 0 }, { 1, 0 }, { 0, -1 } }	// T
+	};
+
+	// build the orientation of a shape that has been rotated clockwise 'rotation' times
+	constexpr Orientation buildOrientation(int shape, int rotation)
+	{
+		Orientation o{};
+
+		for (int i = 0; i < BLOCK_COUNT; i++) {
+			int x = SPAWN_BLOCKS[shape][i][0];
+			int y = SPAWN_BLOCKS[shape][i][1];
+
+			// rotate 90 degrees clockwise around [0,0]: [x,y] -> [y,-x]
+			for (int r = 0; r < rotation; r++) {
+				int temp = x;
+				x = y;
+				y = -temp;
+			}
+
+			o.blockX[i] = static_cast<std::int8_t>(x);
+			o.blockY[i] = static_cast<std::int8_t>(y);
+
+			if (i == 0 || x < o.minX) { o.minX = static_cast<std::int8_t>(x); }
+			if (i == 0 || x > o.maxX) { o.maxX = static_cast<std::int8_t>(x); }
+			if (i == 0 || y < o.minY) { o.minY = static_cast<std::int8_t>(y); }
+			if (i == 0 || y > o.maxY) { o.maxY = static_cast<std::int8_t>(y); }
+		}
+
+		for (int i = 0; i < BLOCK_COUNT; i++) {
+			o.rowMasks[o.blockY[i] - o.minY] |= static_cast<std::uint16_t>(1 << (o.blockX[i] - o.minX));
+		}
+
+		// (every column of a tetromino's bounding box has a block in it)
+		for (int i = 0; i < BLOCK_COUNT; i++) {
+			o.columnBottoms[i] = o.minY;
+		}
+		for (int i = 0; i < BLOCK_COUNT; i++) {
+			int column = o.blockX[i] - o.minX;
+			if (o.blockY[i] > o.columnBottoms[column]) {
+				o.columnBottoms[column] = o.blockY[i];
+			}
+		}
+
+		return o;
+	}
+
+	// return true if 2 orientations cover the same cells (relative to their bounding boxes)
+	constexpr bool haveSameCells(const Orientation& a, const Orientation& b)
+	{
+		for (int i = 0; i < BLOCK_COUNT; i++) {
+			if (a.rowMasks[i] != b.rowMasks[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	constexpr Table buildTable()
+	{
+		Table table{};
+
+		for (int shape = 0; shape < SHAPE_COUNT; shape++) {
+			for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
+				Orientation o = buildOrientation(shape, rotation);
+
+				o.canonicalRotation = static_cast<std::int8_t>(rotation);
+				for (int earlier = rotation - 1; earlier >= 0; earlier--) {
+					if (haveSameCells(o, table.orientations[shape][earlier])) {
+						o.canonicalRotation = table.orientations[shape][earlier].canonicalRotation;
+					}
+				}
+
+				table.orientations[shape][rotation] = o;
+			}
+		}
+
+		return table;
+	}
+
+	// the table itself (computed by the compiler)
+	constexpr Table TABLE = buildTable();
+
+	// return the orientation of a shape at a rotation index (0 to ROTATION_COUNT-1)
+	constexpr const Orientation& getOrientation(int shape, int rotation)
+	{
+		return TABLE.orientations[shape][rotation];
+	}
+
+	// sanity checks on the generated table (evaluated at compile time)
+	static_assert(getOrientation(6, 1).blockX[3] == -1 && getOrientation(6, 1).blockY[3] == 0,
+		"T rotated once should move its [0,-1] block to [-1,0]");
+	static_assert(getOrientation(5, 1).minX == -1 && getOrientation(5, 1).maxX == 2 && getOrientation(5, 1).rowMasks[0] == 0xF,
+		"a horizontal I should be a single row of 4 blocks");
+	static_assert(getOrientation(4, 3).canonicalRotation == 0 && getOrientation(5, 3).canonicalRotation == 1
+		&& getOrientation(6, 2).canonicalRotation == 2,
+		"an O has 1 distinct orientation, an I has 2, a T has 4");
+	static_assert(getOrientation(6, 2).columnBottoms[0] == 0 && getOrientation(6, 2).columnBottoms[1] == 1
+		&& getOrientation(6, 2).columnBottoms[2] == 0,
+		"an upside down T is lowest in its middle column");
+}
+
+#endif /* TETROMINOTABLE_H */
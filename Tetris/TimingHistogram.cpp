@@ -0,0 +1,126 @@
+#include <cassert>
+#include "TimingHistogram.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// constructor - no durations
+TimingHistogram::TimingHistogram()
+{
+	for (std::atomic<std::uint32_t>& bin : bins) {
+		bin.store(0, std::memory_order_relaxed);
+	}
+}
+
+// (recording thread) count a duration
+//   (only this thread writes the counters: a load & a store each, no locked add)
+void TimingHistogram::record(std::uint32_t microseconds)
+{
+	std::atomic<std::uint32_t>& bin = bins[getBin(microseconds)];
+	bin.store(bin.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	if (microseconds > max.load(std::memory_order_relaxed)) {
+		max.store(microseconds, std::memory_order_relaxed);
+	}
+}
+
+// return the # of durations counted
+std::uint64_t TimingHistogram::getCount() const
+{
+	return count.load(std::memory_order_relaxed);
+}
+
+// return the longest duration counted (0 if none)
+std::uint32_t TimingHistogram::getMax() const
+{
+	return max.load(std::memory_order_relaxed);
+}
+
+// return the duration that fraction of the durations counted are no longer than
+//   (the top of the bin that holds the duration ranked fraction * count)
+std::uint32_t TimingHistogram::getPercentile(double fraction) const
+{
+	// (the counters can move while they are read: the bins are summed, not count read)
+	std::uint64_t total = 0;
+	for (const std::atomic<std::uint32_t>& bin : bins) {
+		total += bin.load(std::memory_order_relaxed);
+	}
+	if (total == 0) {
+		return 0;
+	}
+
+	std::uint64_t rank = static_cast<std::uint64_t>(fraction * total + 0.5);
+	rank = (rank < 1) ? 1 : (rank > total ? total : rank);
+	std::uint64_t seen = 0;
+	for (int bin = 0; bin < BIN_COUNT; bin++) {
+		seen += bins[bin].load(std::memory_order_relaxed);
+		if (seen >= rank) {
+			std::uint32_t highest = getBinHighest(bin);
+			std::uint32_t longest = getMax();
+			return (highest < longest) ? highest : longest;
+		}
+	}
+	return getMax();
+}
+
+// write the bins that aren't empty: a line per bin, "lowest highest count"
+void TimingHistogram::writeBins(std::ostream& out, const char* prefix) const
+{
+	for (int bin = 0; bin < BIN_COUNT; bin++) {
+		std::uint32_t binCount = bins[bin].load(std::memory_order_relaxed);
+		if (binCount != 0) {
+			out << prefix << getBinLowest(bin) << ' ' << getBinHighest(bin) << ' ' << binCount << '\n';
+		}
+	}
+}
+
+// return the bin of a duration
+//   (below SUB_BIN_COUNT: the duration, above: the power of 2 & the next SUB_BIN_BITS bits)
+int TimingHistogram::getBin(std::uint32_t microseconds)
+{
+	if (microseconds < SUB_BIN_COUNT) {
+		return static_cast<int>(microseconds);
+	}
+
+	int highestBit = getHighestBit(microseconds);
+	int shift = highestBit - SUB_BIN_BITS;
+	int subBin = static_cast<int>(microseconds >> shift) & (SUB_BIN_COUNT - 1);
+	return (shift + 1) * SUB_BIN_COUNT + subBin;
+}
+
+// return the shortest duration of a bin
+std::uint32_t TimingHistogram::getBinLowest(int bin)
+{
+	assert(bin >= 0 && bin < BIN_COUNT);
+	if (bin < SUB_BIN_COUNT) {
+		return static_cast<std::uint32_t>(bin);
+	}
+
+	int shift = bin / SUB_BIN_COUNT - 1;
+	std::uint32_t subBin = static_cast<std::uint32_t>(bin % SUB_BIN_COUNT);
+	return (SUB_BIN_COUNT + subBin) << shift;
+}
+
+// return the longest duration of a bin
+std::uint32_t TimingHistogram::getBinHighest(int bin)
+{
+	if (bin < SUB_BIN_COUNT) {
+		return static_cast<std::uint32_t>(bin);
+	}
+
+	int shift = bin / SUB_BIN_COUNT - 1;
+	return getBinLowest(bin) + ((std::uint32_t(1) << shift) - 1);
+}
+
+// return the index of the highest set bit (value must not be 0)
+int TimingHistogram::getHighestBit(std::uint32_t value)
+{
+	assert(value != 0);
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse(&index, value);
+	return static_cast<int>(index);
+#else
+	return 31 - __builtin_clz(value);
+#endif
+}
@@ -0,0 +1,72 @@
+// A TimingHistogram counts durations (in microseconds) in a fixed set of bins, so
+// recording one is a few instructions and never allocates, however long the game runs:
+// - below 16 us, every microsecond has a bin of its own
+// - above, each power of 2 is split into 16 bins (so a bin is within 1/16 of its value)
+// which covers 0 us to over an hour in BIN_COUNT bins.
+//
+// One thread records (eg: the render thread, its draw times), any thread may read:
+// the counters are atomics that only the recording thread writes (a relaxed load &
+// store, not a locked add), so a reader sees each counter whole, if not all at the
+// same instant (fine for an overlay).
+
+#ifndef TIMINGHISTOGRAM_H
+#define TIMINGHISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+class TimingHistogram
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// CONSTANTS
+	static const int SUB_BIN_BITS = 4;						// (16 bins per power of 2)
+	static const int SUB_BIN_COUNT = 1 << SUB_BIN_BITS;
+	static const int BIN_COUNT = (32 - SUB_BIN_BITS + 1) * SUB_BIN_COUNT;	// (up to 2^32 us)
+
+	// MEMBER FUNCTIONS
+
+	// constructor - no durations
+	TimingHistogram();
+
+	TimingHistogram(const TimingHistogram&) = delete;
+	TimingHistogram& operator=(const TimingHistogram&) = delete;
+
+	// (recording thread) count a duration
+	void record(std::uint32_t microseconds);
+
+	// return the # of durations counted
+	std::uint64_t getCount() const;
+
+	// return the longest duration counted (0 if none)
+	std::uint32_t getMax() const;
+
+	// return the duration that fraction (0 to 1, eg: 0.99) of the durations counted
+	//   are no longer than (the top of its bin, at most getMax()), 0 if none were counted
+	std::uint32_t getPercentile(double fraction) const;
+
+	// write the bins that aren't empty: a line per bin, "lowest highest count"
+	//   (each line starts with prefix)
+	void writeBins(std::ostream& out, const char* prefix) const;
+
+	// return the bin of a duration
+	static int getBin(std::uint32_t microseconds);
+
+	// return the shortest & longest durations of a bin
+	static std::uint32_t getBinLowest(int bin);
+	static std::uint32_t getBinHighest(int bin);
+
+private:
+	// return the index of the highest set bit (value must not be 0)
+	static int getHighestBit(std::uint32_t value);
+
+	// MEMBER VARIABLES
+	std::atomic<std::uint32_t> bins[BIN_COUNT];
+	std::atomic<std::uint64_t> count{ 0 };
+	std::atomic<std::uint32_t> max{ 0 };
+};
+
+#endif /* TIMINGHISTOGRAM_H */
@@ -0,0 +1,182 @@
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include "TranspositionTable.h"
+
+namespace {
+	const int WORDS_PER_BUCKET = TranspositionTable::BUCKET_BYTES / sizeof(std::uint64_t);
+	static_assert(WORDS_PER_BUCKET == TranspositionTable::ENTRIES_PER_BUCKET * 2, "an entry is 2 words");
+
+	// the data word: score | x | y | rotation | depth | age | valid
+	const int X_SHIFT = 32, Y_SHIFT = 37, ROTATION_SHIFT = 43, DEPTH_SHIFT = 45, AGE_SHIFT = 49;
+	const std::uint64_t VALID_BIT = 1ULL << 57;
+	const int COORDINATE_BIAS = 8;		// x & y are stored + 8 (placements can be above or left of the grid)
+}
+
+// constructor - allocate (and clear) a table of up to megabytes MB
+TranspositionTable::TranspositionTable(std::uint64_t megabytes)
+{
+	// the largest power of 2 buckets that fits (and can be addressed on this platform)
+	std::uint64_t maxBuckets = (megabytes << 20) / BUCKET_BYTES;
+	std::uint64_t addressable = std::numeric_limits<std::size_t>::max() / BUCKET_BYTES / 2;
+	bucketCount = 1;
+	while (bucketCount * 2 <= maxBuckets && bucketCount * 2 <= addressable) {
+		bucketCount *= 2;
+	}
+
+	// one spare bucket, so the first one can start on a cache line
+	std::size_t wordCount = static_cast<std::size_t>((bucketCount + 1) * WORDS_PER_BUCKET);
+	storage.reset(new std::atomic<std::uint64_t>[wordCount]);
+	std::size_t misalignment = reinterpret_cast<std::uintptr_t>(storage.get()) % BUCKET_BYTES;
+	words = storage.get() + (misalignment == 0 ? 0 : (BUCKET_BYTES - misalignment) / sizeof(std::uint64_t));
+
+	clear();
+}
+
+// look up a position, return true (and fill entry) if it is in the table
+bool TranspositionTable::probe(std::uint64_t key, Entry& entry) const
+{
+	const std::atomic<std::uint64_t>* bucket = getBucket(key);
+
+	for (int i = 0; i < ENTRIES_PER_BUCKET; i++) {
+		std::uint64_t data = bucket[2 * i + 1].load(std::memory_order_relaxed);
+		std::uint64_t check = bucket[2 * i].load(std::memory_order_relaxed);
+		if ((data & VALID_BIT) != 0 && (check ^ data) == key) {
+			unpack(data, entry);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// store a search result (it may replace another entry, or be dropped when the
+//   position holds a deeper result of the current search)
+void TranspositionTable::store(std::uint64_t key, const Placement& placement, float score, int depth)
+{
+	assert(depth >= 1 && depth <= MAX_DEPTH);
+	std::atomic<std::uint64_t>* bucket = getBucket(key);
+	int age = static_cast<int>(generation.load(std::memory_order_relaxed) & 0xFF);
+
+	// the entry of this position if there is one, otherwise the least valuable:
+	//   an empty one, else the one with the lowest depth (minus 2 per generation old)
+	int target = 0;
+	int lowestWorth = std::numeric_limits<int>::max();
+	for (int i = 0; i < ENTRIES_PER_BUCKET; i++) {
+		std::uint64_t data = bucket[2 * i + 1].load(std::memory_order_relaxed);
+		std::uint64_t check = bucket[2 * i].load(std::memory_order_relaxed);
+		if ((data & VALID_BIT) == 0) {
+			if (lowestWorth > std::numeric_limits<int>::min()) {
+				target = i;
+				lowestWorth = std::numeric_limits<int>::min();
+			}
+			continue;
+		}
+		if ((check ^ data) == key) {
+			if (getAge(data) == age && getDepth(data) > depth) {
+				return;		// keep the deeper result
+			}
+			target = i;
+			break;
+		}
+		int worth = getDepth(data) - 2 * ((age - getAge(data)) & 0xFF);
+		if (worth < lowestWorth) {
+			target = i;
+			lowestWorth = worth;
+		}
+	}
+
+	std::uint64_t data = pack(placement, score, depth, age);
+	bucket[2 * target + 1].store(data, std::memory_order_relaxed);
+	bucket[2 * target].store(key ^ data, std::memory_order_relaxed);
+}
+
+// start a new search generation: entries of older generations are replaced first
+void TranspositionTable::newSearch()
+{
+	generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+// remove every entry
+void TranspositionTable::clear()
+{
+	for (std::uint64_t w = 0; w < bucketCount * WORDS_PER_BUCKET; w++) {
+		words[w].store(0, std::memory_order_relaxed);
+	}
+}
+
+std::uint64_t TranspositionTable::getEntryCount() const
+{
+	return bucketCount * ENTRIES_PER_BUCKET;
+}
+
+std::uint64_t TranspositionTable::getSizeBytes() const
+{
+	return bucketCount * BUCKET_BYTES;
+}
+
+// return the key of a position: a board hash & the current and next shapes
+std::uint64_t TranspositionTable::makeKey(std::uint64_t boardHash, Tetromino::TetShape current, Tetromino::TetShape next)
+{
+	// a SplitMix64 finalizer over the hash with the shapes added in
+	std::uint64_t z = boardHash
+		+ (static_cast<std::uint64_t>(current) + 1) * 0x9E3779B97F4A7C15ULL
+		+ (static_cast<std::uint64_t>(next) + 1) * 0xD1B54A32D192ED03ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// (same as above) when the next shape doesn't matter (or isn't known)
+std::uint64_t TranspositionTable::makeKey(std::uint64_t boardHash, Tetromino::TetShape current)
+{
+	return makeKey(boardHash, current, Tetromino::TetShape::COUNT);
+}
+
+// Packing =======================================================
+
+// pack a search result & its age into an entry's data word
+std::uint64_t TranspositionTable::pack(const Placement& placement, float score, int depth, int age)
+{
+	assert(placement.x + COORDINATE_BIAS >= 0 && placement.x + COORDINATE_BIAS < 32);
+	assert(placement.y + COORDINATE_BIAS >= 0 && placement.y + COORDINATE_BIAS < 64);
+
+	std::uint32_t scoreBits;
+	std::memcpy(&scoreBits, &score, sizeof(scoreBits));
+
+	return scoreBits
+		| static_cast<std::uint64_t>(placement.x + COORDINATE_BIAS) << X_SHIFT
+		| static_cast<std::uint64_t>(placement.y + COORDINATE_BIAS) << Y_SHIFT
+		| static_cast<std::uint64_t>(placement.rotation) << ROTATION_SHIFT
+		| static_cast<std::uint64_t>(depth) << DEPTH_SHIFT
+		| static_cast<std::uint64_t>(age) << AGE_SHIFT
+		| VALID_BIT;
+}
+
+// unpack an entry's data word
+void TranspositionTable::unpack(std::uint64_t data, Entry& entry)
+{
+	std::uint32_t scoreBits = static_cast<std::uint32_t>(data);
+	std::memcpy(&entry.score, &scoreBits, sizeof(scoreBits));
+
+	entry.placement.x = static_cast<std::int8_t>(static_cast<int>((data >> X_SHIFT) & 0x1F) - COORDINATE_BIAS);
+	entry.placement.y = static_cast<std::int8_t>(static_cast<int>((data >> Y_SHIFT) & 0x3F) - COORDINATE_BIAS);
+	entry.placement.rotation = static_cast<std::int8_t>((data >> ROTATION_SHIFT) & 0x3);
+	entry.depth = getDepth(data);
+}
+
+int TranspositionTable::getDepth(std::uint64_t data)
+{
+	return static_cast<int>((data >> DEPTH_SHIFT) & 0xF);
+}
+
+int TranspositionTable::getAge(std::uint64_t data)
+{
+	return static_cast<int>((data >> AGE_SHIFT) & 0xFF);
+}
+
+// return the first word of the bucket of a key
+std::atomic<std::uint64_t>* TranspositionTable::getBucket(std::uint64_t key) const
+{
+	return words + static_cast<std::size_t>(key & (bucketCount - 1)) * WORDS_PER_BUCKET;
+}
@@ -0,0 +1,105 @@
+// The TranspositionTable remembers search results by position, so a search that
+// reaches a position some search (on any thread) has already scored can reuse the
+// result instead of expanding it again.
+//
+// - Keys: a position is a board hash (eg: Gameboard::getOccupancyHash()) plus the
+//   shapes to place (the current shape, and the next shape when it matters),
+//   mixed into 64 bits by makeKey().
+// - Entries: the best placement found from the position, its score, the depth
+//   searched (# of pieces) and the age (the search generation that wrote it).
+//   An entry is 2 words: the data, and the key XOR'd with the data. A probe
+//   accepts an entry only when its 2 words XOR back to the key, so a read that
+//   races a write (and sees one old word and one new one) is a miss, not a wrong
+//   hit. That makes every probe & store lock free: 2 relaxed atomic loads or stores.
+// - Buckets: entries are grouped 4 to a 64 byte bucket (one cache line), and a key
+//   can only live in its bucket. The table is lossy: storing into a full bucket
+//   replaces its least valuable entry, the shallowest & oldest one.
+// - Memory: the size is set in megabytes when the table is made (eg: 64 to 16384),
+//   rounded down to a power of 2 buckets, allocated once and never resized.
+//
+// One table can be shared by every thread of a search and every bot of a sweep, as
+// long as they score positions the same way (the same evaluator).
+
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "PlacementEnumerator.h"
+#include "Tetromino.h"
+
+class TranspositionTable
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	typedef PlacementEnumerator::Placement Placement;
+
+	// a search result
+	struct Entry {
+		Placement placement{};	// the best placement from the position
+		float score = 0.0f;		// its score
+		int depth = 0;			// the # of pieces searched (1 to MAX_DEPTH)
+	};
+
+	// CONSTANTS
+	static const int ENTRIES_PER_BUCKET = 4;
+	static const int BUCKET_BYTES = 64;		// one cache line
+	static const int MAX_DEPTH = 15;
+
+	// constructor - allocate (and clear) a table of up to megabytes MB
+	explicit TranspositionTable(std::uint64_t megabytes);
+
+	TranspositionTable(const TranspositionTable&) = delete;
+	TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+	// look up a position, return true (and fill entry) if it is in the table
+	bool probe(std::uint64_t key, Entry& entry) const;
+
+	// store a search result (it may replace another entry, or be dropped when the
+	//   position holds a deeper result of the current search)
+	void store(std::uint64_t key, const Placement& placement, float score, int depth);
+
+	// start a new search generation: entries of older generations are replaced first
+	void newSearch();
+
+	// remove every entry
+	void clear();
+
+	// return the # of entries the table can hold
+	std::uint64_t getEntryCount() const;
+
+	// return the memory used by the entries, in bytes
+	std::uint64_t getSizeBytes() const;
+
+	// return the key of a position: a board hash & the current and next shapes
+	static std::uint64_t makeKey(std::uint64_t boardHash, Tetromino::TetShape current, Tetromino::TetShape next);
+	// (same as above) when the next shape doesn't matter (or isn't known)
+	static std::uint64_t makeKey(std::uint64_t boardHash, Tetromino::TetShape current);
+
+private:
+	// pack a search result & its age into an entry's data word
+	static std::uint64_t pack(const Placement& placement, float score, int depth, int age);
+
+	// unpack an entry's data word
+	static void unpack(std::uint64_t data, Entry& entry);
+
+	// return the depth & age of an entry's data word
+	static int getDepth(std::uint64_t data);
+	static int getAge(std::uint64_t data);
+
+	// return the first word of the bucket of a key
+	std::atomic<std::uint64_t>* getBucket(std::uint64_t key) const;
+
+	// MEMBER VARIABLES
+
+	std::unique_ptr<std::atomic<std::uint64_t>[]> storage;	// the allocation (with room to align)
+	std::atomic<std::uint64_t>* words = nullptr;		// the first bucket (cache line aligned)
+	std::uint64_t bucketCount = 0;						// a power of 2
+	std::atomic<unsigned> generation{ 0 };				// the current search generation
+};
+
+#endif /* TRANSPOSITIONTABLE_H */
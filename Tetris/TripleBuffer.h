@@ -0,0 +1,73 @@
+// The TripleBuffer hands the latest version of a value from one thread (the writer)
+// to one other thread (the reader) without locks, eg: the frames the simulation
+// thread publishes for the render thread to draw (see TetrisGame::draw()).
+//
+// It holds 3 copies of the value: the writer's, the reader's, and the one in between.
+// The writer fills its copy, then publish() swaps it with the one in between; the
+// reader's update() swaps its copy with the one in between if that is newer. So:
+// - neither side ever waits, however slow the other is (a slow reader skips versions,
+//   it never holds the writer up)
+// - the reader's copy is never written while it is read: it is always a complete version
+// - the swaps are a single atomic exchange of an index (& a "newer" flag), with
+//   acquire/release ordering, so the copy swapped in is visible before its index.
+//
+// (a template: the whole class is in this header)
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// MEMBER FUNCTIONS
+
+	// (writer) return the copy to fill before publish()
+	//   (it holds an older version: every field must be written)
+	T& getWriteBuffer()
+	{
+		return slots[writeIndex];
+	}
+
+	// (writer) make the write buffer the latest version, & take another to fill
+	void publish()
+	{
+		writeIndex = middle.exchange(writeIndex | NEWER, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	// (reader) take the latest version published, return false if there is none
+	//   newer than the read buffer (the read buffer is then unchanged)
+	bool update()
+	{
+		if ((middle.load(std::memory_order_relaxed) & NEWER) == 0) {
+			return false;
+		}
+
+		readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	// (reader) return the version taken by the last update()
+	const T& getReadBuffer() const
+	{
+		return slots[readIndex];
+	}
+
+private:
+	// CONSTANTS
+	static const int INDEX_MASK = 3;	// the slot index in middle
+	static const int NEWER = 4;			// the flag in middle: its slot wasn't read yet
+
+	// MEMBER VARIABLES
+	T slots[3];
+	int writeIndex = 0;					// (only the writer uses it)
+	int readIndex = 1;					// (only the reader uses it)
+	std::atomic<int> middle{ 2 };		// the slot in between (& the NEWER flag)
+};
+
+#endif /* TRIPLEBUFFER_H */
@@ -0,0 +1,60 @@
+#include "VersusConnection.h"
+
+// bind localPort & send to remoteAddress:remotePort
+bool VersusConnection::open(unsigned short localPort, const std::string& address, unsigned short port)
+{
+	remoteAddress = sf::IpAddress(address);
+	remotePort = port;
+	if (remoteAddress == sf::IpAddress::None) {
+		return false;
+	}
+
+	socket.setBlocking(false);
+	return socket.bind(localPort) == sf::Socket::Done;
+}
+
+// delay & drop the packets sent from now on
+void VersusConnection::setSimulatedLatency(const LatencySimulator::Settings& settings)
+{
+	simulator.setSettings(settings);
+	simulating = true;
+}
+
+// send a packet (or hand it to the simulator)
+void VersusConnection::send(const std::vector<std::uint8_t>& packet)
+{
+	if (simulating) {
+		simulator.send(packet.data(), packet.size(), clock.getElapsedTime().asSeconds());
+		return;
+	}
+
+	// (a full send buffer drops the packet, like a lost one)
+	socket.send(packet.data(), packet.size(), remoteAddress, remotePort);
+}
+
+// take the next packet from the remote player
+bool VersusConnection::receive(std::vector<std::uint8_t>& packet)
+{
+	std::uint8_t data[512];
+	std::size_t size = 0;
+	sf::IpAddress sender;
+	unsigned short senderPort = 0;
+
+	while (socket.receive(data, sizeof(data), size, sender, senderPort) == sf::Socket::Done) {
+		if (sender == remoteAddress && senderPort == remotePort) {
+			packet.assign(data, data + size);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// send the simulator's packets whose delay has passed
+void VersusConnection::update()
+{
+	double now = clock.getElapsedTime().asSeconds();
+	while (simulating && simulator.receive(buffer, now)) {
+		socket.send(buffer.data(), buffer.size(), remoteAddress, remotePort);
+	}
+}
@@ -0,0 +1,55 @@
+// The VersusConnection carries the packets of a VersusSession between two players
+// over UDP (an SFML UdpSocket), eg: two machines on a LAN, or two windows on one
+// machine (with different ports).
+//
+// UDP suits rollback netcode: a packet that arrives late is worth less than the next
+// one, so nothing waits for a lost packet to be resent (the session resends every
+// input until it is acknowledged). The socket is non-blocking, so neither sending
+// nor receiving ever stalls the game loop.
+//
+// For trying the netcode on a good network, the packets sent can be delayed and
+// dropped by a LatencySimulator (see setSimulatedLatency()).
+
+#ifndef VERSUSCONNECTION_H
+#define VERSUSCONNECTION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <SFML/Network.hpp>
+#include <SFML/System/Clock.hpp>
+#include "LatencySimulator.h"
+
+class VersusConnection
+{
+public:
+	// MEMBER FUNCTIONS
+
+	// bind localPort & send to remoteAddress:remotePort (only packets from there are
+	//   received), return false if the port can't be bound or the address is unknown
+	bool open(unsigned short localPort, const std::string& remoteAddress, unsigned short remotePort);
+
+	// delay & drop the packets sent from now on (as a slower network would)
+	void setSimulatedLatency(const LatencySimulator::Settings& settings);
+
+	// send a packet (or hand it to the simulator, see update())
+	void send(const std::vector<std::uint8_t>& packet);
+
+	// take the next packet from the remote player, return false if none is waiting
+	bool receive(std::vector<std::uint8_t>& packet);
+
+	// send the simulator's packets whose delay has passed (call every game loop)
+	void update();
+
+private:
+	// MEMBER VARIABLES
+	sf::UdpSocket socket;
+	sf::IpAddress remoteAddress;
+	unsigned short remotePort = 0;
+	bool simulating = false;			// true if the packets sent go through the simulator
+	LatencySimulator simulator;
+	sf::Clock clock;					// the simulator's time
+	std::vector<std::uint8_t> buffer;	// (a delayed packet)
+};
+
+#endif /* VERSUSCONNECTION_H */
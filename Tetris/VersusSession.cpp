@@ -0,0 +1,329 @@
+#include <algorithm>
+#include "ParallelGameRunner.h"
+#include "ReplayFormat.h"
+#include "VersusSession.h"
+
+constexpr double VersusSession::FRAME_SECONDS;
+
+// constructor
+VersusSession::VersusSession(std::uint64_t nonce)
+	: nonce(nonce), savedStates(HISTORY_FRAMES), savedHashes(HISTORY_FRAMES, 0),
+	inputs(HISTORY_FRAMES * PLAYER_COUNT, static_cast<std::uint8_t>(TetrisEngine::Action::NONE))
+{
+	startState(state, 0);
+}
+
+bool VersusSession::isStarted() const
+{
+	return started;
+}
+
+int VersusSession::getLocalPlayer() const
+{
+	return localPlayer;
+}
+
+std::uint64_t VersusSession::getSeed() const
+{
+	return seed;
+}
+
+// simulate the next frame with the local player's input (& the remote player's
+//   input, or a prediction of it)
+bool VersusSession::advanceFrame(TetrisEngine::Action localInput)
+{
+	if (!started) {
+		return false;
+	}
+
+	// (the inputs & states of the frames that could still be rolled back must stay in the history)
+	if (state.frame - remoteInputCount >= MAX_PREDICTION_FRAMES || state.frame - ackedInputCount >= MAX_PREDICTION_FRAMES) {
+		stalls++;
+		return false;
+	}
+
+	int slot = getSlot(state.frame);
+	inputs[slot * PLAYER_COUNT + localPlayer] = static_cast<std::uint8_t>(localInput);
+	if (state.frame >= remoteInputCount) {
+		inputs[slot * PLAYER_COUNT + 1 - localPlayer] = static_cast<std::uint8_t>(TetrisEngine::Action::NONE);
+	}
+	simulateNextFrame();
+	return true;
+}
+
+// write the packet to send to the other player
+//   magic (2 bytes), nonce (8), remote inputs received (4),
+//   checksum frame (4) & the checksum of its state (8),
+//   first input frame (4), input count (1), inputs (a byte each)
+void VersusSession::writePacket(std::vector<std::uint8_t>& packet) const
+{
+	packet.clear();
+	ReplayFormat::writeBytes(PACKET_MAGIC, 2, packet);
+	ReplayFormat::writeBytes(nonce, 8, packet);
+	ReplayFormat::writeBytes(static_cast<std::uint32_t>(remoteInputCount), 4, packet);
+
+	if (started) {
+		// the latest state that no longer depends on a predicted input
+		int checksumFrame = std::min(remoteInputCount, state.frame);
+		ReplayFormat::writeBytes(static_cast<std::uint32_t>(checksumFrame), 4, packet);
+		ReplayFormat::writeBytes(checksumFrame == state.frame ? getStateHash(state) : savedHashes[getSlot(checksumFrame)], 8, packet);
+	}
+	else {
+		ReplayFormat::writeBytes(NO_FRAME, 4, packet);
+		ReplayFormat::writeBytes(0, 8, packet);
+	}
+
+	// every local input the other player hasn't acknowledged (advanceFrame() keeps them few)
+	int firstFrame = started ? ackedInputCount : 0;
+	int count = started ? state.frame - ackedInputCount : 0;
+	ReplayFormat::writeBytes(static_cast<std::uint32_t>(firstFrame), 4, packet);
+	ReplayFormat::writeBytes(static_cast<std::uint32_t>(count), 1, packet);
+	for (int frame = firstFrame; frame < firstFrame + count; frame++) {
+		packet.push_back(inputs[getSlot(frame) * PLAYER_COUNT + localPlayer]);
+	}
+}
+
+// handle a packet from the other player
+bool VersusSession::receivePacket(const std::uint8_t* data, std::size_t size)
+{
+	if (size < static_cast<std::size_t>(PACKET_HEADER_BYTES)) {
+		return false;
+	}
+
+	const std::uint8_t* read = data;
+	std::uint64_t magic = ReplayFormat::readBytes(read, 2);
+	std::uint64_t packetNonce = ReplayFormat::readBytes(read, 8);
+	std::uint64_t ack = ReplayFormat::readBytes(read, 4);
+	std::uint64_t checksumFrame = ReplayFormat::readBytes(read, 4);
+	std::uint64_t checksum = ReplayFormat::readBytes(read, 8);
+	std::uint64_t firstFrame = ReplayFormat::readBytes(read, 4);
+	int count = static_cast<int>(ReplayFormat::readBytes(read, 1));
+	if (magic != PACKET_MAGIC || size != static_cast<std::size_t>(PACKET_HEADER_BYTES + count) || packetNonce == nonce) {
+		return false;
+	}
+
+	// the handshake: the first packet of the other player starts the game
+	if (!started) {
+		remoteNonce = packetNonce;
+		start(ParallelGameRunner::getGameSeed(nonce ^ packetNonce, 0), nonce < packetNonce ? 0 : 1);
+	}
+	else if (packetNonce != remoteNonce) {
+		return false;
+	}
+
+	ackedInputCount = std::max(ackedInputCount, static_cast<int>(std::min<std::uint64_t>(ack, state.frame)));
+
+	// take the new remote inputs, find the earliest that was mispredicted
+	int remotePlayer = 1 - localPlayer;
+	int rollbackFrame = state.frame;
+	for (int i = 0; i < count; i++) {
+		std::uint64_t frame = firstFrame + i;
+		if (frame < static_cast<std::uint64_t>(remoteInputCount)) {
+			continue;
+		}
+		// (inputs can't skip a frame, or be further ahead than the history can hold)
+		if (frame > static_cast<std::uint64_t>(remoteInputCount) || remoteInputCount >= state.frame + HISTORY_FRAMES - MAX_PREDICTION_FRAMES
+			|| read[i] >= static_cast<std::uint8_t>(TetrisEngine::Action::COUNT)) {
+			break;
+		}
+
+		std::uint8_t& input = inputs[getSlot(remoteInputCount) * PLAYER_COUNT + remotePlayer];
+		if (remoteInputCount < state.frame && input != read[i]) {
+			rollbackFrame = std::min(rollbackFrame, remoteInputCount);
+		}
+		input = read[i];
+		remoteInputCount++;
+	}
+
+	// roll back: restore the state of the first mispredicted frame and simulate the
+	//   frames since then again (with the inputs known now, and predictions after them)
+	if (rollbackFrame < state.frame) {
+		int presentFrame = state.frame;
+		state = savedStates[getSlot(rollbackFrame)];
+		while (state.frame < presentFrame) {
+			simulateNextFrame();
+		}
+		rollbacks++;
+		resimulatedFrames += presentFrame - rollbackFrame;
+	}
+
+	// compare the other player's checksum, if the state it is for is final here too
+	//   (and still in the history)
+	if (checksumFrame != NO_FRAME && checksumFrame <= static_cast<std::uint64_t>(std::min(remoteInputCount, state.frame))
+		&& checksumFrame + HISTORY_FRAMES > static_cast<std::uint64_t>(state.frame)) {
+		int frame = static_cast<int>(checksumFrame);
+		std::uint64_t hash = (frame == state.frame) ? getStateHash(state) : savedHashes[getSlot(frame)];
+		checksums++;
+		desynced = desynced || hash != checksum;
+	}
+
+	return true;
+}
+
+const VersusSession::State& VersusSession::getState() const
+{
+	return state;
+}
+
+const TetrisEngine& VersusSession::getEngine(int player) const
+{
+	return state.engines[player];
+}
+
+int VersusSession::getFrame() const
+{
+	return state.frame;
+}
+
+int VersusSession::getConfirmedFrame() const
+{
+	return remoteInputCount;
+}
+
+std::uint64_t VersusSession::getRollbackCount() const
+{
+	return rollbacks;
+}
+
+std::uint64_t VersusSession::getResimulatedFrameCount() const
+{
+	return resimulatedFrames;
+}
+
+std::uint64_t VersusSession::getStallCount() const
+{
+	return stalls;
+}
+
+std::uint64_t VersusSession::getChecksumCount() const
+{
+	return checksums;
+}
+
+bool VersusSession::isDesynced() const
+{
+	return desynced;
+}
+
+// Simulation ====================================================
+
+// reset a state for a new versus game (both games get the same shapes)
+void VersusSession::startState(State& state, std::uint64_t seed)
+{
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		state.engines[player].reset(ParallelGameRunner::getGameSeed(seed, 0));
+		state.pendingGarbage[player] = 0;
+		state.wins[player] = 0;
+	}
+	state.round = 0;
+	state.frame = 0;
+}
+
+// advance a state by one frame, given each player's input
+//   1) the garbage sent last frame is added
+//   2) each game steps with its player's input
+//   3) the rows cleared become garbage for the other player (next frame)
+//   4) when a game is over, the other player wins the round and both games restart
+void VersusSession::simulateFrame(State& state, std::uint64_t seed, const TetrisEngine::Action inputs[PLAYER_COUNT])
+{
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		if (state.pendingGarbage[player] > 0) {
+			std::uint64_t hole = ParallelGameRunner::getGameSeed(~seed, static_cast<std::uint64_t>(state.frame) * PLAYER_COUNT + player);
+			state.engines[player].addGarbage(state.pendingGarbage[player], static_cast<int>(hole % Gameboard::MAX_X));
+			state.pendingGarbage[player] = 0;
+		}
+	}
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		TetrisEngine& engine = state.engines[player];
+		int score = engine.getScore();
+		engine.step(inputs[player], FRAME_SECONDS);
+		state.pendingGarbage[1 - player] += getGarbageRows(engine.getScore() - score);
+	}
+
+	if (state.engines[0].isGameOver() || state.engines[1].isGameOver()) {
+		state.round++;
+		for (int player = 0; player < PLAYER_COUNT; player++) {
+			if (!state.engines[player].isGameOver()) {
+				state.wins[player]++;
+			}
+		}
+		for (int player = 0; player < PLAYER_COUNT; player++) {
+			state.engines[player].reset(ParallelGameRunner::getGameSeed(seed, state.round));
+			state.pendingGarbage[player] = 0;
+		}
+	}
+
+	state.frame++;
+}
+
+// return a hash of a state (to compare the states of both machines)
+//   (of its values, not its bytes: the padding between them isn't part of the game)
+std::uint64_t VersusSession::getStateHash(const State& state)
+{
+	std::uint64_t hash = 0;
+	auto add = [&hash](std::int64_t value) {
+		hash = ParallelGameRunner::getGameSeed(hash, static_cast<std::uint64_t>(value));
+	};
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		const TetrisEngine& engine = state.engines[player];
+		add(static_cast<std::int64_t>(engine.getBoard().getHash()));
+		add(static_cast<int>(engine.getCurrentShape().getShape()));
+		add(engine.getCurrentShape().getRotation());
+		add(engine.getCurrentShape().getGridLoc().getX());
+		add(engine.getCurrentShape().getGridLoc().getY());
+		add(static_cast<int>(engine.getNextShape().getShape()));
+		add(engine.getScore());
+		add(engine.getShapesPlaced());
+		add(engine.getTicks());
+		add(engine.isGameOver());
+		add(state.pendingGarbage[player]);
+		add(state.wins[player]);
+	}
+	add(state.round);
+	add(state.frame);
+	return hash;
+}
+
+// return the # of garbage rows sent for clearing rowCount rows at once
+//   (a single row sends nothing, 4 rows send all 4)
+int VersusSession::getGarbageRows(int rowCount)
+{
+	const int GARBAGE_ROWS[] = { 0, 0, 1, 2, 4 };
+	return GARBAGE_ROWS[std::max(0, std::min(rowCount, 4))];
+}
+
+// Private methods ===============================================
+
+// start the versus game (at the end of the handshake)
+void VersusSession::start(std::uint64_t gameSeed, int player)
+{
+	seed = gameSeed;
+	localPlayer = player;
+	started = true;
+	startState(state, seed);
+	remoteInputCount = 0;
+	ackedInputCount = 0;
+}
+
+// return where frame # is stored (in the ring buffers of HISTORY_FRAMES)
+int VersusSession::getSlot(int frame)
+{
+	static_assert((HISTORY_FRAMES & (HISTORY_FRAMES - 1)) == 0, "the history is a power of 2");
+	return frame & (HISTORY_FRAMES - 1);
+}
+
+// simulate the frame at state.frame with the inputs known (or predicted) for it
+void VersusSession::simulateNextFrame()
+{
+	int slot = getSlot(state.frame);
+	savedStates[slot] = state;
+	savedHashes[slot] = getStateHash(state);
+
+	TetrisEngine::Action frameInputs[PLAYER_COUNT];
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		frameInputs[player] = static_cast<TetrisEngine::Action>(inputs[slot * PLAYER_COUNT + player]);
+	}
+	simulateFrame(state, seed, frameInputs);
+}
@@ -0,0 +1,159 @@
+// The VersusSession runs a two player versus game with rollback netcode: each
+// player's machine runs both games (its own & the remote player's) from the same
+// seed, and only the players' inputs travel between them (see writePacket()).
+//
+// The game advances in fixed frames (FRAME_SECONDS), one input per player per frame:
+//   - the local input is applied in the frame it is given, so the local player never
+//     waits for the network (no input delay),
+//   - the remote input of a frame that hasn't arrived yet is predicted (NONE: most
+//     frames have no input) and the frame is simulated anyway.
+// When a remote input arrives and differs from its prediction, the session rolls
+// back: it restores the state saved at the start of that frame and re-simulates up to
+// the present with the inputs it now knows. A state is plain data (two engines, see
+// TetrisEngine::Snapshot), so saving one every frame is a copy of a few KB.
+//
+// The simulation is deterministic (simulateFrame()): the same inputs give the same
+// states on both machines. Rows cleared send "garbage" rows to the other player,
+// with a hole whose column follows from the seed, and when a game is over the other
+// player wins the round and both games are reset for the next one.
+//
+// Packets are small (about 30 bytes plus a byte per input) and carry every input
+// the other player hasn't acknowledged yet, so a lost packet costs nothing but time.
+// They also carry a checksum of the latest state that no longer depends on a
+// prediction, so a desync (eg: different builds) is detected (see isDesynced()).
+// The first packets are a handshake: each player has a random nonce, the seed is
+// made from both, and the player with the lower nonce is player 0.
+//
+// The session has no clock & does no I/O: the caller advances it every frame and
+// moves its packets (see VersusConnection for UDP, and LatencySimulator for tests).
+// A session falls at most MAX_PREDICTION_FRAMES ahead of the remote inputs: when it
+// would be further ahead it stalls (advanceFrame() returns false) until they arrive.
+
+#ifndef VERSUSSESSION_H
+#define VERSUSSESSION_H
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "TetrisEngine.h"
+
+class VersusSession
+{
+public:
+	// FRIENDS
+	friend class TestSuite;// (allows TestSuite access to private members for testing)
+
+	// CONSTANTS
+	static const int PLAYER_COUNT = 2;
+	static constexpr double FRAME_SECONDS = 1.0 / 30.0;	// the virtual time of a frame
+	static const int MAX_PREDICTION_FRAMES = 30;		// how far ahead of the remote inputs a session may run (1 s)
+	static const int HISTORY_FRAMES = 64;				// the frames of inputs & states kept (more than the above)
+	static const std::uint16_t PACKET_MAGIC = 0x5654;	// "TV"
+	static const int PACKET_HEADER_BYTES = 2 + 8 + 4 + 4 + 1 + 4 + 8;
+	static const int MAX_PACKET_BYTES = PACKET_HEADER_BYTES + HISTORY_FRAMES;
+
+	// the complete state of a versus game (plain data: copied to save it)
+	struct State {
+		TetrisEngine engines[PLAYER_COUNT];	// each player's game
+		int pendingGarbage[PLAYER_COUNT];	// the garbage rows each player gets next frame
+		int wins[PLAYER_COUNT];				// the # of rounds each player won
+		int round;							// the # of rounds finished
+		int frame;							// the # of frames simulated
+	};
+
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   nonce: a random number that identifies this player in the handshake
+	//   (the players must pick different nonces, eg: from a random_device)
+	explicit VersusSession(std::uint64_t nonce);
+
+	// return true once the handshake is done (the game can advance)
+	bool isStarted() const;
+	// return the player (0 or 1) whose inputs are given to advanceFrame()
+	int getLocalPlayer() const;
+	// return the seed both games were made from
+	std::uint64_t getSeed() const;
+
+	// simulate the next frame with the local player's input (& the remote player's
+	//   input, or a prediction of it). return false if the frame could not be simulated:
+	//   before the handshake, or when the session is too far ahead of the remote inputs
+	//   (a stall: give the same input again next frame)
+	bool advanceFrame(TetrisEngine::Action localInput);
+
+	// write the packet to send to the other player (after each frame, and during the
+	//   handshake), it is at most MAX_PACKET_BYTES
+	void writePacket(std::vector<std::uint8_t>& packet) const;
+
+	// handle a packet from the other player: complete the handshake, or take its
+	//   inputs and roll back if they differ from their predictions.
+	//   return false if it isn't a versus packet (it is ignored)
+	bool receivePacket(const std::uint8_t* data, std::size_t size);
+
+	// return the state of the game (at the start of the next frame)
+	const State& getState() const;
+	// return a player's engine
+	const TetrisEngine& getEngine(int player) const;
+	// return the # of frames simulated
+	int getFrame() const;
+	// return the # of frames whose remote input is known (the frames before it are final)
+	int getConfirmedFrame() const;
+
+	// return the # of rollbacks, & the # of frames they re-simulated
+	std::uint64_t getRollbackCount() const;
+	std::uint64_t getResimulatedFrameCount() const;
+	// return the # of frames that stalled (advanceFrame() returned false)
+	std::uint64_t getStallCount() const;
+	// return the # of checksums compared with the other player's, & true if one differed
+	std::uint64_t getChecksumCount() const;
+	bool isDesynced() const;
+
+	// SIMULATION (the same on both machines)
+
+	// reset a state for a new versus game (both games get the same shapes)
+	static void startState(State& state, std::uint64_t seed);
+	// advance a state by one frame, given each player's input
+	static void simulateFrame(State& state, std::uint64_t seed, const TetrisEngine::Action inputs[PLAYER_COUNT]);
+	// return a hash of a state (to compare the states of both machines)
+	static std::uint64_t getStateHash(const State& state);
+	// return the # of garbage rows sent for clearing rowCount rows at once
+	static int getGarbageRows(int rowCount);
+
+private:
+	// CONSTANTS
+	static const std::uint32_t NO_FRAME = 0xFFFFFFFF;	// (a packet without a checksum)
+
+	// start the versus game (at the end of the handshake)
+	//   player: the local player (0 or 1), the other player's inputs come from the packets
+	void start(std::uint64_t gameSeed, int player);
+
+	// return where frame # is stored (in the ring buffers of HISTORY_FRAMES)
+	static int getSlot(int frame);
+
+	// simulate the frame at state.frame with the inputs known (or predicted) for it,
+	//   saving the state & its hash first
+	void simulateNextFrame();
+
+	// MEMBER VARIABLES
+	std::uint64_t nonce;				// this player's handshake nonce
+	std::uint64_t remoteNonce = 0;		// (& the other player's, once started)
+	std::uint64_t seed = 0;
+	bool started = false;
+	int localPlayer = 0;
+	State state;						// the present (the start of frame state.frame)
+	std::vector<State> savedStates;		// the state at the start of each recent frame
+	std::vector<std::uint64_t> savedHashes;	// (& its hash)
+	std::vector<std::uint8_t> inputs;	// the inputs of each recent frame, PLAYER_COUNT per frame
+										//   (the remote ones are predictions past remoteInputCount)
+	int remoteInputCount = 0;			// the # of frames whose remote input is known
+	int ackedInputCount = 0;			// the # of local inputs the other player has
+	std::uint64_t rollbacks = 0;
+	std::uint64_t resimulatedFrames = 0;
+	std::uint64_t stalls = 0;
+	std::uint64_t checksums = 0;
+	bool desynced = false;
+};
+
+static_assert(std::is_trivially_copyable<VersusSession::State>::value, "a state is saved with a copy");
+
+#endif /* VERSUSSESSION_H */